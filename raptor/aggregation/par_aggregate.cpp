@@ -7,8 +7,8 @@ int aggregate(ParCSRMatrix* A, ParCSRMatrix* S, aligned_vector<int>& states,
         bool tap_comm, double* rand_vals)
 {
     int rank, num_procs;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+    RAPtor_MPI_Comm_rank(A->partition->topology->comm, &rank);
+    RAPtor_MPI_Comm_size(A->partition->topology->comm, &num_procs);
 
     S->sort();
     S->on_proc->move_diag();
@@ -183,3 +183,132 @@ int aggregate(ParCSRMatrix* A, ParCSRMatrix* S, aligned_vector<int>& states,
     return n_aggs;
 }
 
+
+ParCSRMatrix* amalgamate(ParCSRMatrix* A, const int block_size, bool tap_comm)
+{
+    int bs = block_size;
+    int n_nodes = A->local_num_rows / bs;
+    int start, end, col, node, row;
+
+    // Map on_proc and off_proc columns of A to node columns
+    aligned_vector<int> on_proc_column_map;
+    aligned_vector<int> off_proc_column_map;
+    aligned_vector<int> on_to_node;
+    aligned_vector<int> off_to_node;
+    if (A->on_proc_num_cols)
+    {
+        on_to_node.resize(A->on_proc_num_cols);
+    }
+    if (A->off_proc_num_cols)
+    {
+        off_to_node.resize(A->off_proc_num_cols);
+    }
+    for (int i = 0; i < A->on_proc_num_cols; i++)
+    {
+        node = A->on_proc_column_map[i] / bs;
+        if (on_proc_column_map.empty() || on_proc_column_map.back() != node)
+        {
+            on_proc_column_map.emplace_back(node);
+        }
+        on_to_node[i] = on_proc_column_map.size() - 1;
+    }
+    for (int i = 0; i < A->off_proc_num_cols; i++)
+    {
+        node = A->off_proc_column_map[i] / bs;
+        if (off_proc_column_map.empty() || off_proc_column_map.back() != node)
+        {
+            off_proc_column_map.emplace_back(node);
+        }
+        off_to_node[i] = off_proc_column_map.size() - 1;
+    }
+    int on_proc_num_cols = on_proc_column_map.size();
+    int off_proc_num_cols = off_proc_column_map.size();
+
+    Partition* part = new Partition(A->partition->global_num_rows / bs,
+            A->partition->global_num_cols / bs, A->partition->local_num_rows / bs,
+            A->partition->local_num_cols / bs, A->partition->first_local_row / bs,
+            A->partition->first_local_col / bs, A->partition->topology);
+    ParCSRMatrix* A_node = new ParCSRMatrix(part, A->global_num_rows / bs,
+            A->global_num_cols / bs, n_nodes, on_proc_num_cols, off_proc_num_cols);
+    part->num_shared = 0;
+    A_node->on_proc_column_map = on_proc_column_map;
+    A_node->off_proc_column_map = off_proc_column_map;
+    A_node->local_row_map.resize(n_nodes);
+    for (int i = 0; i < n_nodes; i++)
+    {
+        A_node->local_row_map[i] = A->local_row_map[i*bs] / bs;
+    }
+
+    // Sum squares of each block (position of node column in row is
+    // stored in on_pos / off_pos, valid if marked with current row)
+    aligned_vector<int> on_pos(on_proc_num_cols);
+    aligned_vector<int> off_pos(off_proc_num_cols);
+    aligned_vector<int> on_marker(on_proc_num_cols, -1);
+    aligned_vector<int> off_marker(off_proc_num_cols, -1);
+    A_node->on_proc->idx1[0] = 0;
+    A_node->off_proc->idx1[0] = 0;
+    for (int i = 0; i < n_nodes; i++)
+    {
+        for (int k = 0; k < bs; k++)
+        {
+            row = i*bs + k;
+            start = A->on_proc->idx1[row];
+            end = A->on_proc->idx1[row+1];
+            for (int j = start; j < end; j++)
+            {
+                col = on_to_node[A->on_proc->idx2[j]];
+                if (on_marker[col] != i)
+                {
+                    on_marker[col] = i;
+                    on_pos[col] = A_node->on_proc->idx2.size();
+                    A_node->on_proc->idx2.emplace_back(col);
+                    A_node->on_proc->vals.emplace_back(0.0);
+                }
+                A_node->on_proc->vals[on_pos[col]] += A->on_proc->vals[j] * A->on_proc->vals[j];
+            }
+
+            start = A->off_proc->idx1[row];
+            end = A->off_proc->idx1[row+1];
+            for (int j = start; j < end; j++)
+            {
+                col = off_to_node[A->off_proc->idx2[j]];
+                if (off_marker[col] != i)
+                {
+                    off_marker[col] = i;
+                    off_pos[col] = A_node->off_proc->idx2.size();
+                    A_node->off_proc->idx2.emplace_back(col);
+                    A_node->off_proc->vals.emplace_back(0.0);
+                }
+                A_node->off_proc->vals[off_pos[col]] += A->off_proc->vals[j] * A->off_proc->vals[j];
+            }
+        }
+
+        for (int j = A_node->on_proc->idx1[i]; j < (int) A_node->on_proc->idx2.size(); j++)
+        {
+            A_node->on_proc->vals[j] = sqrt(A_node->on_proc->vals[j]);
+            if (A_node->on_proc->idx2[j] != i)
+            {
+                A_node->on_proc->vals[j] *= -1.0;
+            }
+        }
+        for (int j = A_node->off_proc->idx1[i]; j < (int) A_node->off_proc->idx2.size(); j++)
+        {
+            A_node->off_proc->vals[j] = -sqrt(A_node->off_proc->vals[j]);
+        }
+        A_node->on_proc->idx1[i+1] = A_node->on_proc->idx2.size();
+        A_node->off_proc->idx1[i+1] = A_node->off_proc->idx2.size();
+    }
+    A_node->on_proc->nnz = A_node->on_proc->idx2.size();
+    A_node->off_proc->nnz = A_node->off_proc->idx2.size();
+    A_node->local_nnz = A_node->on_proc->nnz + A_node->off_proc->nnz;
+
+    A_node->comm = new ParComm(part, A_node->off_proc_column_map,
+            A_node->on_proc_column_map, A->comm->key, A->comm->mpi_comm);
+    if (tap_comm)
+    {
+        A_node->tap_comm = new TAPComm(part, A_node->off_proc_column_map,
+                A_node->on_proc_column_map, true, A->comm->mpi_comm);
+    }
+
+    return A_node;
+}
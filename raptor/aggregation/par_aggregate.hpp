@@ -13,6 +13,18 @@ int aggregate(ParCSRMatrix* A, ParCSRMatrix* S, aligned_vector<int>& states,
         aligned_vector<int>& off_proc_states, aligned_vector<int>& aggregates,
         bool tap_comm = false, double* rand_vals = NULL);
 
+/**************************************************************
+ *****   Amalgamate
+ **************************************************************
+ ***** Forms the node matrix of A, with block_size consecutive
+ ***** rows and columns of A per node (global index node *
+ ***** block_size + k).  Each entry is the Frobenius norm of the
+ ***** corresponding block of A, negated for off-diagonal blocks so
+ ***** that strength of connection is applied as in the scalar case.
+ **************************************************************/
+ParCSRMatrix* amalgamate(ParCSRMatrix* A, const int block_size,
+        bool tap_comm = false);
+
 #endif
 
 
@@ -2,28 +2,108 @@
 // License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
 #include "aggregation/par_candidates.hpp"
 
-// TODO -- currently assumes B with single candidate
-ParCSRMatrix* fit_candidates(ParCSRMatrix* A, 
-        const int n_aggs, const aligned_vector<int>& aggregates, 
+/**************************************************************
+ *****   Aggregate Cholesky QR
+ **************************************************************
+ ***** Factors the num_candidates x num_candidates Gram matrix G
+ ***** of a single aggregate into R^T R (R upper triangular, row-
+ ***** major).  Candidates whose remaining squared norm is below
+ ***** tol times their original squared norm are dropped (zero row
+ ***** in R).  The threshold is at least the roundoff of G, so
+ ***** linearly dependent candidates are always dropped.
+ **************************************************************/
+void aggregate_cholesky(const double* G, double* R, const int num_candidates,
+        const double tol)
+{
+    int nc = num_candidates;
+    double val, diag, scale;
+    double drop_tol = std::max(tol, 10.0 * nc * DBL_EPSILON);
+
+    for (int j = 0; j < nc; j++)
+    {
+        val = G[j*nc + j];
+        for (int k = 0; k < j; k++)
+        {
+            val -= R[k*nc + j] * R[k*nc + j];
+        }
+
+        // Threshold relative to norm of original candidate
+        if (val > drop_tol * G[j*nc + j])
+        {
+            diag = sqrt(val);
+            scale = 1.0 / diag;
+        }
+        else
+        {
+            diag = 0.0;
+            scale = 0.0;
+        }
+
+        for (int k = 0; k < j; k++)
+        {
+            R[j*nc + k] = 0.0;
+        }
+        R[j*nc + j] = diag;
+        for (int l = j + 1; l < nc; l++)
+        {
+            val = G[j*nc + l];
+            for (int k = 0; k < j; k++)
+            {
+                val -= R[k*nc + j] * R[k*nc + l];
+            }
+            R[j*nc + l] = val * scale;
+        }
+    }
+}
+
+/**************************************************************
+ *****   Aggregate Triangular Solve
+ **************************************************************
+ ***** Overwrites each of the n_rows contiguous rows of b (of
+ ***** length num_candidates) with b R^{-1}.  Dropped candidates
+ ***** (zero diagonal in R) are set to zero.
+ **************************************************************/
+void aggregate_solve(double* b, const double* R, const int n_rows,
+        const int num_candidates)
+{
+    int nc = num_candidates;
+    double val, diag;
+
+    for (int i = 0; i < n_rows; i++)
+    {
+        double* b_row = &(b[i*nc]);
+        for (int j = 0; j < nc; j++)
+        {
+            diag = R[j*nc + j];
+            if (diag == 0.0)
+            {
+                b_row[j] = 0.0;
+                continue;
+            }
+            val = b_row[j];
+            for (int k = 0; k < j; k++)
+            {
+                val -= b_row[k] * R[k*nc + j];
+            }
+            b_row[j] = val * (1.0 / diag);
+        }
+    }
+}
+
+ParCSRMatrix* fit_candidates(ParCSRMatrix* A,
+        const int n_aggs, const aligned_vector<int>& aggregates,
         const aligned_vector<double>& B, aligned_vector<double>& R,
         int num_candidates, bool tap_comm, double tol)
 {
-    int rank;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-
-    // Currently only implemented for this
-    assert(num_candidates == 1);
-    
-    int col_start, col_end;
-    int row, idx_B, ctr;
-    int col_start_k;
-    int global_col, local_col, col;
-    double val, scale;
+    int nc = num_candidates;
+    int block_size = nc * nc;
+    int global_col, local_col;
+    int agg, pos, row_start;
+    double val;
     CommPkg* comm;
 
     // Calculate off_proc_column_map and num off_proc cols
     int off_proc_num_cols;
-    std::set<int> off_proc_col_set;
     aligned_vector<int> off_proc_column_map;
     for (aligned_vector<int>::const_iterator it = aggregates.begin();
             it != aggregates.end(); ++it)
@@ -32,185 +112,283 @@ ParCSRMatrix* fit_candidates(ParCSRMatrix* A,
 
         if (*it < A->partition->first_local_col || *it > A->partition->last_local_col)
         {
-            off_proc_col_set.insert(*it);
+            off_proc_column_map.emplace_back(*it);
         }
-    } 
-    std::map<int, int> global_to_local;
-    for (std::set<int>::iterator it = off_proc_col_set.begin();
-            it != off_proc_col_set.end(); ++it)
-    {
-        global_to_local[*it] = off_proc_column_map.size();
-        off_proc_column_map.emplace_back(*it);
     }
+    sort_unique(off_proc_column_map);
     off_proc_num_cols = off_proc_column_map.size();
+    IndexMap global_to_local(off_proc_column_map);
 
+    // Find aggregate of each row (on_proc aggregates first, followed by
+    // off_proc aggregates), with on_proc aggregates ordered by column
+    aligned_vector<int> row_aggs(A->local_num_rows, -1);
     aligned_vector<int> on_proc_cols(A->on_proc_num_cols, 0);
-    // Create AggOp matrices
+    aligned_vector<int> on_proc_column_map;
     int* on_proc_partition_to_col = A->map_partition_to_local();
-    CSRMatrix* AggOp_on = new CSRMatrix(A->local_num_rows, -1);
-    CSRMatrix* AggOp_off = new CSRMatrix(A->local_num_rows, -1);
-    AggOp_on->idx1[0] = 0;
-    AggOp_off->idx1[0] = 0;
     for (int i = 0; i < A->local_num_rows; i++)
     {
         global_col = aggregates[i];
-        if (global_col >= 0)
+        if (global_col < 0) continue;
+
+        if (global_col >= A->partition->first_local_col &&
+                global_col <= A->partition->last_local_col)
         {
-            if (global_col >= A->partition->first_local_col &&
-                    global_col <= A->partition->last_local_col)
-            {
-                local_col = on_proc_partition_to_col[global_col - A->partition->first_local_col];
-                on_proc_cols[local_col] = 1;
-                AggOp_on->idx2.emplace_back(local_col);
-                AggOp_on->vals.emplace_back(1.0);
-            }
-            else
-            {
-                AggOp_off->idx2.emplace_back(global_to_local[global_col]);
-                AggOp_off->vals.emplace_back(1.0);
-            }
+            local_col = on_proc_partition_to_col[global_col - A->partition->first_local_col];
+            on_proc_cols[local_col] = 1;
         }
-        AggOp_on->idx1[i+1] = AggOp_on->idx2.size();
-        AggOp_off->idx1[i+1] = AggOp_off->idx2.size();
     }
-    AggOp_on->nnz = AggOp_on->idx2.size();
-    AggOp_off->nnz = AggOp_off->idx2.size();
-    delete[] on_proc_partition_to_col;
-
-    // Initialize CSC Matrix for tentative interpolation
-    int global_num_cols;
-    RAPtor_MPI_Allreduce(&n_aggs, &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
-    ParCSCMatrix* T_csc = new ParCSCMatrix(A->partition, A->global_num_rows, global_num_cols, 
-            A->local_num_rows, n_aggs, off_proc_num_cols);
-        
-    T_csc->off_proc_column_map.resize(off_proc_num_cols);
-    std::copy(off_proc_column_map.begin(), off_proc_column_map.end(),
-            T_csc->off_proc_column_map.begin());
-    T_csc->local_row_map = A->get_local_row_map();
-
-    // Map on proc columns to new, contiguous cols
-    // Create on_proc_column_map of T
-    ctr = 0;
     for (int i = 0; i < A->on_proc_num_cols; i++)
     {
         if (on_proc_cols[i])
         {
-            on_proc_cols[i] = T_csc->on_proc_column_map.size();
-            T_csc->on_proc_column_map.emplace_back(A->on_proc_column_map[i]);
+            on_proc_cols[i] = on_proc_column_map.size();
+            on_proc_column_map.emplace_back(A->on_proc_column_map[i]);
         }
     }
-    for (int i = 0; i < AggOp_on->nnz; i++)
+    for (int i = 0; i < A->local_num_rows; i++)
     {
-        AggOp_on->idx2[i] = on_proc_cols[AggOp_on->idx2[i]];
-    }
-    AggOp_on->n_cols = n_aggs;
-    AggOp_off->n_cols = off_proc_num_cols;
+        global_col = aggregates[i];
+        if (global_col < 0) continue;
 
-    // Convert AggOp matrices to CSC
-    CSCMatrix* AggOp_on_csc = AggOp_on->to_CSC();
-    CSCMatrix* AggOp_off_csc = AggOp_off->to_CSC();
-    delete AggOp_on;
-    delete AggOp_off;
+        if (global_col >= A->partition->first_local_col &&
+                global_col <= A->partition->last_local_col)
+        {
+            local_col = on_proc_partition_to_col[global_col - A->partition->first_local_col];
+            row_aggs[i] = on_proc_cols[local_col];
+        }
+        else
+        {
+            row_aggs[i] = n_aggs + global_to_local.find(global_col);
+        }
+    }
+    delete[] on_proc_partition_to_col;
 
-    // Set near nullspace candidates in R to 0
-    R.resize(n_aggs);
-    for (int i = 0; i < n_aggs; i++)
+    // Pack rows of B contiguously by aggregate (aggregate-major), so
+    // that each aggregate's QR works on a dense n_rows x nc block
+    int total_aggs = n_aggs + off_proc_num_cols;
+    aligned_vector<int> agg_ptr(total_aggs + 1, 0);
+    aligned_vector<int> agg_rows;
+    aligned_vector<double> agg_B;
+    for (int i = 0; i < A->local_num_rows; i++)
     {
-        R[i] = 0.0;
+        if (row_aggs[i] >= 0) agg_ptr[row_aggs[i] + 1]++;
     }
-
-    aligned_vector<double> off_proc_norms(off_proc_num_cols, 0);
-    // Add columns of B to T (corresponding to pattern in AggOp)
-    // Add on_process columns
-    T_csc->on_proc->idx1[0] = 0;
-    for (int i = 0; i < n_aggs; i++)
+    for (int i = 0; i < total_aggs; i++)
+    {
+        agg_ptr[i+1] += agg_ptr[i];
+    }
+    if (agg_ptr[total_aggs])
     {
-        col_start = AggOp_on_csc->idx1[i];
-        col_end = AggOp_on_csc->idx1[i+1];
-        for (int k = col_start; k < col_end; k++)
+        agg_rows.resize(agg_ptr[total_aggs]);
+        agg_B.resize(agg_ptr[total_aggs] * nc);
+    }
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        agg = row_aggs[i];
+        if (agg < 0) continue;
+
+        pos = agg_ptr[agg]++;
+        agg_rows[pos] = i;
+        for (int j = 0; j < nc; j++)
         {
-            row = AggOp_on_csc->idx2[k];
-            val = B[row];
-            T_csc->on_proc->idx2.emplace_back(row);
-            T_csc->on_proc->vals.emplace_back(val);
-            R[i] += (val * val);
+            agg_B[pos*nc + j] = B[j*A->local_num_rows + i];
         }
-        T_csc->on_proc->idx1[i + 1] = T_csc->on_proc->idx2.size();
     }
-    T_csc->on_proc->nnz = T_csc->on_proc->idx2.size();
-    delete AggOp_on_csc;
+    for (int i = total_aggs; i > 0; i--)
+    {
+        agg_ptr[i] = agg_ptr[i-1];
+    }
+    agg_ptr[0] = 0;
 
-    // Add off_process columns
-    T_csc->off_proc->idx1[0] = 0;
-    for (int i = 0; i < off_proc_num_cols; i++)
+    // Local portion of Gram matrix (B_agg^T B_agg) of each aggregate
+    aligned_vector<double> G;
+    aligned_vector<double> off_proc_G;
+    if (n_aggs) G.resize(n_aggs * block_size, 0.0);
+    if (off_proc_num_cols) off_proc_G.resize(off_proc_num_cols * block_size, 0.0);
+    for (int a = 0; a < total_aggs; a++)
     {
-        col_start = AggOp_off_csc->idx1[i];
-        col_end = AggOp_off_csc->idx1[i+1];
-        for (int k = col_start; k < col_end; k++)
+        double* G_a = a < n_aggs ? &(G[a*block_size])
+            : &(off_proc_G[(a - n_aggs)*block_size]);
+        for (int i = agg_ptr[a]; i < agg_ptr[a+1]; i++)
         {
-            row = AggOp_off_csc->idx2[k];
-            val = B[row];
-            T_csc->off_proc->idx2.emplace_back(row);
-            T_csc->off_proc->vals.emplace_back(val);
-            off_proc_norms[i] += (val * val);
+            const double* b_row = &(agg_B[i*nc]);
+            for (int j = 0; j < nc; j++)
+            {
+                for (int k = 0; k < nc; k++)
+                {
+                    G_a[j*nc + k] += b_row[j] * b_row[k];
+                }
+            }
         }
-        T_csc->off_proc->idx1[i + 1] = T_csc->off_proc->idx2.size();
     }
-    T_csc->off_proc->nnz = T_csc->off_proc->idx2.size();
-    delete AggOp_off_csc;
 
-    // Create communicator
+    // Create communicator for aggregates
     if (tap_comm)
     {
-        T_csc->tap_comm = new TAPComm(T_csc->partition, T_csc->off_proc_column_map,
-                T_csc->on_proc_column_map, true, A->comm->mpi_comm);
-        comm = T_csc->tap_comm;
+        comm = new TAPComm(A->partition, off_proc_column_map,
+                on_proc_column_map, true, A->comm->mpi_comm);
     }
     else
     {
-        T_csc->comm = new ParComm(T_csc->partition, T_csc->off_proc_column_map,
-                T_csc->on_proc_column_map, A->comm->key, A->comm->mpi_comm);
-        comm = T_csc->comm;
+        comm = new ParComm(A->partition, off_proc_column_map,
+                on_proc_column_map, A->comm->key, A->comm->mpi_comm);
     }
 
+    // Sum Gram matrices on process holding each aggregate, factor, and
+    // send R back to each process with rows in the aggregate
     std::function<double(double, double)> func = &sum_func<double, double>;
-    comm->communicate_T(off_proc_norms, R, 1, func, func);
+    comm->communicate_T(off_proc_G, G, block_size, func, func);
 
-    for (int i = 0; i < n_aggs; i++)
+    aligned_vector<double> agg_R;
+    if (n_aggs) agg_R.resize(n_aggs * block_size);
+    if (nc == 1)
     {
-        R[i] = sqrt(R[i]);
-        scale = 1.0 / R[i];
-
-        col_start = T_csc->on_proc->idx1[i];
-        col_end = T_csc->on_proc->idx1[i+1];
-        for (int j = col_start; j < col_end; j++)
+        for (int a = 0; a < n_aggs; a++)
         {
-            T_csc->on_proc->vals[j] *= scale;
+            agg_R[a] = sqrt(G[a]);
         }
     }
-    
-    aligned_vector<double>& off_proc_R = comm->communicate(R);
-
-    for (int i = 0; i < off_proc_num_cols; i++)
+    else
     {
-        scale = 1.0 / off_proc_R[i];
-
-        col_start = T_csc->off_proc->idx1[i];
-        col_end = T_csc->off_proc->idx1[i+1];
-        for (int j = col_start; j < col_end; j++)
+        for (int a = 0; a < n_aggs; a++)
         {
-            T_csc->off_proc->vals[j] *= scale;
+            aggregate_cholesky(&(G[a*block_size]), &(agg_R[a*block_size]), nc, tol);
         }
     }
+    aligned_vector<double>& off_proc_R = comm->communicate(agg_R, block_size);
 
-    ParCSRMatrix* T = T_csc->to_ParCSR();
-    delete T_csc;
+    // Orthonormalize candidates of each aggregate (B_agg R^{-1})
+    for (int a = 0; a < total_aggs; a++)
+    {
+        const double* R_a = a < n_aggs ? &(agg_R[a*block_size])
+            : &(off_proc_R[(a - n_aggs)*block_size]);
+        row_start = agg_ptr[a];
+        if (nc == 1)
+        {
+            double scale = 1.0 / R_a[0];
+            for (int i = row_start; i < agg_ptr[a+1]; i++)
+            {
+                agg_B[i] *= scale;
+            }
+        }
+        else
+        {
+            aggregate_solve(&(agg_B[row_start*nc]), R_a, agg_ptr[a+1] - row_start, nc);
+        }
+    }
 
-    return T;
-}
+    // Coarse candidates, in the layout of B (candidate j of coarse
+    // point a*nc + k is R_a[k][j])
+    int n_coarse = n_aggs * nc;
+    R.resize(n_coarse * nc);
+    for (int a = 0; a < n_aggs; a++)
+    {
+        for (int k = 0; k < nc; k++)
+        {
+            for (int j = 0; j < nc; j++)
+            {
+                R[j*n_coarse + a*nc + k] = agg_R[a*block_size + k*nc + j];
+            }
+        }
+    }
 
+    // Initialize tentative interpolation, with columns a*nc + j for
+    // candidate j of aggregate a.  With multiple candidates, columns
+    // are numbered in a partition num_candidates times that of A.
+    int global_num_aggs;
+    RAPtor_MPI_Allreduce(&n_aggs, &global_num_aggs, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM,
+            A->partition->topology->comm);
+    Partition* part = A->partition;
+    if (nc > 1)
+    {
+        part = new Partition(A->partition->global_num_rows,
+                A->partition->global_num_cols * nc, A->partition->local_num_rows,
+                A->partition->local_num_cols * nc, A->partition->first_local_row,
+                A->partition->first_local_col * nc, A->partition->topology);
+    }
+    ParCSRMatrix* T = new ParCSRMatrix(part, A->global_num_rows, global_num_aggs * nc,
+            A->local_num_rows, n_coarse, off_proc_num_cols * nc);
+    if (nc > 1)
+    {
+        part->num_shared = 0;
+    }
 
+    T->on_proc_column_map.resize(n_coarse);
+    T->off_proc_column_map.resize(off_proc_num_cols * nc);
+    for (int a = 0; a < n_aggs; a++)
+    {
+        for (int j = 0; j < nc; j++)
+        {
+            T->on_proc_column_map[a*nc + j] = on_proc_column_map[a]*nc + j;
+        }
+    }
+    for (int a = 0; a < off_proc_num_cols; a++)
+    {
+        for (int j = 0; j < nc; j++)
+        {
+            T->off_proc_column_map[a*nc + j] = off_proc_column_map[a]*nc + j;
+        }
+    }
+    T->local_row_map = A->get_local_row_map();
 
+    // Each row of T holds the orthonormalized candidates of its aggregate
+    aligned_vector<int> row_pos(A->local_num_rows, -1);
+    for (int i = 0; i < agg_ptr[total_aggs]; i++)
+    {
+        row_pos[agg_rows[i]] = i;
+    }
+    T->on_proc->idx1[0] = 0;
+    T->off_proc->idx1[0] = 0;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        agg = row_aggs[i];
+        if (agg >= 0)
+        {
+            pos = row_pos[i];
+            for (int j = 0; j < nc; j++)
+            {
+                val = agg_B[pos*nc + j];
+                if (agg < n_aggs)
+                {
+                    T->on_proc->idx2.emplace_back(agg*nc + j);
+                    T->on_proc->vals.emplace_back(val);
+                }
+                else
+                {
+                    T->off_proc->idx2.emplace_back((agg - n_aggs)*nc + j);
+                    T->off_proc->vals.emplace_back(val);
+                }
+            }
+        }
+        T->on_proc->idx1[i+1] = T->on_proc->idx2.size();
+        T->off_proc->idx1[i+1] = T->off_proc->idx2.size();
+    }
+    T->on_proc->nnz = T->on_proc->idx2.size();
+    T->off_proc->nnz = T->off_proc->idx2.size();
+    T->local_nnz = T->on_proc->nnz + T->off_proc->nnz;
 
+    // Communicator of T (same as that of the aggregates for a single
+    // candidate)
+    if (nc == 1)
+    {
+        if (tap_comm) T->tap_comm = (TAPComm*) comm;
+        else T->comm = (ParComm*) comm;
+    }
+    else
+    {
+        comm->delete_comm();
+        if (tap_comm)
+        {
+            T->tap_comm = new TAPComm(T->partition, T->off_proc_column_map,
+                    T->on_proc_column_map, true, A->comm->mpi_comm);
+        }
+        else
+        {
+            T->comm = new ParComm(T->partition, T->off_proc_column_map,
+                    T->on_proc_column_map, A->comm->key, A->comm->mpi_comm);
+        }
+    }
 
+    return T;
+}
 
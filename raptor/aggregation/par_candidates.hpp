@@ -8,7 +8,43 @@
 
 using namespace raptor;
 
-// TODO -- currently only accepts constant vector
+// Cholesky factor (R^T R, row-major R) of the Gram matrix G of an
+// aggregate's candidates, dropping candidates below tol
+void aggregate_cholesky(const double* G, double* R, const int num_candidates,
+        const double tol);
+
+/**************************************************************
+ *****   Fit Candidates
+ **************************************************************
+ ***** Forms tentative interpolation T by restricting the near
+ ***** nullspace candidates B to each aggregate, and orthonormalizing
+ ***** them with a thin QR of each aggregate (B_agg = Q R).  Each
+ ***** aggregate has num_candidates columns in T, and R holds the
+ ***** coarse candidates.
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** A : ParCSRMatrix*
+ *****    Matrix being coarsened
+ ***** n_aggs : int
+ *****    Number of aggregates rooted on this process
+ ***** aggregates : aligned_vector<int>&
+ *****    Global aggregate (root column) of each local row, or
+ *****    negative if the row is in no aggregate
+ ***** B : aligned_vector<double>&
+ *****    Candidates, stored by candidate (B[j*local_num_rows + i]
+ *****    is candidate j at row i)
+ ***** R : aligned_vector<double>&
+ *****    Returns coarse candidates, in the same layout as B, with
+ *****    n_aggs * num_candidates rows
+ ***** num_candidates : int
+ *****    Number of candidates in B
+ ***** tol : double
+ *****    Candidates whose squared norm on an aggregate drops below
+ *****    tol times their original squared norm during
+ *****    orthogonalization are dropped from that aggregate (zero
+ *****    columns of T)
+ **************************************************************/
 ParCSRMatrix* fit_candidates(ParCSRMatrix* A, const int n_aggs, 
         const aligned_vector<int>& aggregates, 
         const aligned_vector<double>& B, aligned_vector<double>& R,
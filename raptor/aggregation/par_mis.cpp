@@ -77,7 +77,7 @@ void comm_finished(const ParCSRMatrix* A,
         {
             A->comm->send_data->int_buffer[start] = remaining;
             RAPtor_MPI_Isend(&(A->comm->send_data->int_buffer[start]), 1, RAPtor_MPI_INT, proc,
-                    finish_tag, RAPtor_MPI_COMM_WORLD, 
+                    finish_tag, A->comm->mpi_comm, 
                     &(A->comm->send_data->requests[n_sends++]));
         }
     }
@@ -89,7 +89,7 @@ void comm_finished(const ParCSRMatrix* A,
         if (active_recvs[i])
         {
             RAPtor_MPI_Irecv(&(A->comm->recv_data->int_buffer[start]), 1, RAPtor_MPI_INT, proc,
-                    finish_tag, RAPtor_MPI_COMM_WORLD, 
+                    finish_tag, A->comm->mpi_comm, 
                     &(A->comm->recv_data->requests[n_recvs++]));
         }
     }
@@ -110,7 +110,7 @@ void comm_finished(const ParCSRMatrix* A,
         if (active_sends[i])
         {
             RAPtor_MPI_Irecv(&(active_sends[i]), 1, RAPtor_MPI_INT, proc,
-                    finish_tag_T, RAPtor_MPI_COMM_WORLD, 
+                    finish_tag_T, A->comm->mpi_comm, 
                     &(A->comm->send_data->requests[n_sends++]));
         }
     }
@@ -125,7 +125,7 @@ void comm_finished(const ParCSRMatrix* A,
             active_recvs[i] = A->comm->recv_data->int_buffer[start];
             A->comm->recv_data->int_buffer[start] = remaining;
             RAPtor_MPI_Isend(&(A->comm->recv_data->int_buffer[start]), 1, RAPtor_MPI_INT, proc,
-                    finish_tag_T, RAPtor_MPI_COMM_WORLD, 
+                    finish_tag_T, A->comm->mpi_comm, 
                     &(A->comm->recv_data->requests[n_recvs++]));
         }
     }
@@ -172,7 +172,7 @@ void comm_coarse_dist1(const ParCSRMatrix* A,
             if (active_sends[i])
             {
                 RAPtor_MPI_Isend(&(A->comm->send_data->int_buffer[start]), end - start, RAPtor_MPI_INT, proc,
-                        tag, RAPtor_MPI_COMM_WORLD, &(A->comm->send_data->requests[n_sends++]));
+                        tag, A->comm->mpi_comm, &(A->comm->send_data->requests[n_sends++]));
             }
         }
 
@@ -185,7 +185,7 @@ void comm_coarse_dist1(const ParCSRMatrix* A,
             if (active_recvs[i])
             {
                 RAPtor_MPI_Irecv(&(A->comm->recv_data->int_buffer[start]), end - start, RAPtor_MPI_INT,
-                        proc, tag, RAPtor_MPI_COMM_WORLD, &(A->comm->recv_data->requests[n_recvs++]));
+                        proc, tag, A->comm->mpi_comm, &(A->comm->recv_data->requests[n_recvs++]));
             }
         }
 
@@ -207,8 +207,8 @@ int mis2(const ParCSRMatrix* A, aligned_vector<int>& states,
 {
     // Get MPI Information
     int rank, num_procs;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+    RAPtor_MPI_Comm_rank(A->comm->mpi_comm, &rank);
+    RAPtor_MPI_Comm_size(A->comm->mpi_comm, &num_procs);
 
     // Declare Variables
     int start, end, col;
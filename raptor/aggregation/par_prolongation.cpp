@@ -2,6 +2,8 @@
 // License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
 
 #include "aggregation/par_prolongation.hpp"
+#include "aggregation/par_candidates.hpp"
+#include "core/repro_sum.hpp"
 
 // Assuming weighting = local (not getting approx spectral radius)
 ParCSRMatrix* jacobi_prolongation(ParCSRMatrix* A, ParCSRMatrix* T, bool tap_comm,
@@ -63,7 +65,7 @@ ParCSRMatrix* jacobi_prolongation(ParCSRMatrix* A, ParCSRMatrix* T, bool tap_com
                 scaled_A->tap_mat_comm = new TAPComm(scaled_A->partition, 
                         scaled_A->off_proc_column_map,
                         scaled_A->on_proc_column_map, 
-                        false, RAPtor_MPI_COMM_WORLD);
+                        false, A->comm->mpi_comm);
             }
             AP_tmp = scaled_A->tap_mult(P);
         }
@@ -74,7 +76,7 @@ ParCSRMatrix* jacobi_prolongation(ParCSRMatrix* A, ParCSRMatrix* T, bool tap_com
                 scaled_A->comm = new ParComm(scaled_A->partition, 
                         scaled_A->off_proc_column_map,
                         scaled_A->on_proc_column_map, 
-                        9283, RAPtor_MPI_COMM_WORLD);
+                        A->comm->key, A->comm->mpi_comm);
             }
 
             AP_tmp = scaled_A->mult(P);
@@ -94,7 +96,7 @@ ParCSRMatrix* jacobi_prolongation(ParCSRMatrix* A, ParCSRMatrix* T, bool tap_com
     else
     {
         P->comm = new ParComm(P->partition, P->off_proc_column_map, 
-                P->on_proc_column_map, 9283, RAPtor_MPI_COMM_WORLD);
+                P->on_proc_column_map, A->comm->key, A->comm->mpi_comm);
     }
 
     delete scaled_A;
@@ -102,3 +104,510 @@ ParCSRMatrix* jacobi_prolongation(ParCSRMatrix* A, ParCSRMatrix* T, bool tap_com
     return P;
 }
 
+ParCSRMatrix* filter_matrix(ParCSRMatrix* A, strength_t strength_type,
+        double theta, bool tap_comm)
+{
+    int start, end, diag_pos;
+    double val;
+
+    // Sorts A, with diagonal first
+    aligned_vector<char> on_strong;
+    aligned_vector<char> off_strong;
+    A->strength_mask(strength_type, on_strong, off_strong, theta, tap_comm);
+
+    ParCSRMatrix* A_F = new ParCSRMatrix(A->partition, A->global_num_rows,
+            A->global_num_cols, A->local_num_rows, A->on_proc_num_cols,
+            A->off_proc_num_cols);
+    A_F->on_proc->idx2.reserve(A->on_proc->nnz);
+    A_F->on_proc->vals.reserve(A->on_proc->nnz);
+    A_F->off_proc->idx2.reserve(A->off_proc->nnz);
+    A_F->off_proc->vals.reserve(A->off_proc->nnz);
+
+    A_F->on_proc->idx1[0] = 0;
+    A_F->off_proc->idx1[0] = 0;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        start = A->on_proc->idx1[i];
+        end = A->on_proc->idx1[i+1];
+
+        // Empty rows stay empty
+        if (start == end && A->off_proc->idx1[i] == A->off_proc->idx1[i+1])
+        {
+            A_F->on_proc->idx1[i+1] = A_F->on_proc->idx2.size();
+            A_F->off_proc->idx1[i+1] = A_F->off_proc->idx2.size();
+            continue;
+        }
+
+        // Always keep diagonal (added, if missing, when weak entries exist)
+        diag_pos = A_F->on_proc->idx2.size();
+        A_F->on_proc->idx2.emplace_back(i);
+        A_F->on_proc->vals.emplace_back(0.0);
+        if (start < end && A->on_proc->idx2[start] == i)
+        {
+            A_F->on_proc->vals[diag_pos] = A->on_proc->vals[start++];
+        }
+
+        // Weak entries are lumped to the diagonal
+        for (int j = start; j < end; j++)
+        {
+            val = A->on_proc->vals[j];
+            if (on_strong[j])
+            {
+                A_F->on_proc->idx2.emplace_back(A->on_proc->idx2[j]);
+                A_F->on_proc->vals.emplace_back(val);
+            }
+            else
+            {
+                A_F->on_proc->vals[diag_pos] += val;
+            }
+        }
+        for (int j = A->off_proc->idx1[i]; j < A->off_proc->idx1[i+1]; j++)
+        {
+            val = A->off_proc->vals[j];
+            if (off_strong[j])
+            {
+                A_F->off_proc->idx2.emplace_back(A->off_proc->idx2[j]);
+                A_F->off_proc->vals.emplace_back(val);
+            }
+            else
+            {
+                A_F->on_proc->vals[diag_pos] += val;
+            }
+        }
+
+        A_F->on_proc->idx1[i+1] = A_F->on_proc->idx2.size();
+        A_F->off_proc->idx1[i+1] = A_F->off_proc->idx2.size();
+    }
+    A_F->on_proc->nnz = A_F->on_proc->idx2.size();
+    A_F->off_proc->nnz = A_F->off_proc->idx2.size();
+    A_F->local_nnz = A_F->on_proc->nnz + A_F->off_proc->nnz;
+
+    // A_F inherits the (sorted, diagonal first) ordering of A
+    A_F->on_proc->sorted = true;
+    A_F->on_proc->diag_first = true;
+    A_F->off_proc->sorted = true;
+
+    // Column maps (and communicators) are those of A
+    A_F->on_proc_column_map = A->get_on_proc_column_map();
+    A_F->local_row_map = A->get_local_row_map();
+    A_F->off_proc_column_map = A->get_off_proc_column_map();
+
+    A_F->comm = A->comm;
+    A_F->tap_comm = A->tap_comm;
+    A_F->tap_mat_comm = A->tap_mat_comm;
+
+    if (A_F->comm) A_F->comm->num_shared++;
+    if (A_F->tap_comm) A_F->tap_comm->num_shared++;
+    if (A_F->tap_mat_comm) A_F->tap_mat_comm->num_shared++;
+
+    return A_F;
+}
+
+// Position of each entry of M in the values of pattern P (on_proc values
+// first, then off_proc), or -1 if not in the pattern.  M and P share rows.
+static void pattern_positions(ParCSRMatrix* M, ParCSRMatrix* P,
+        aligned_vector<int>& on_pos, aligned_vector<int>& off_pos)
+{
+    int start, end, col, pos;
+    int P_on_nnz = P->on_proc->nnz;
+
+    IndexMap P_on_map(P->on_proc_column_map);
+    IndexMap P_off_map(P->off_proc_column_map);
+    aligned_vector<int> on_to_P(M->on_proc_num_cols);
+    aligned_vector<int> off_to_P(M->off_proc_num_cols);
+    for (int i = 0; i < M->on_proc_num_cols; i++)
+    {
+        on_to_P[i] = P_on_map[M->on_proc_column_map[i]];
+    }
+    for (int i = 0; i < M->off_proc_num_cols; i++)
+    {
+        off_to_P[i] = P_off_map[M->off_proc_column_map[i]];
+    }
+
+    aligned_vector<int> on_marker(P->on_proc_num_cols, -1);
+    aligned_vector<int> off_marker(P->off_proc_num_cols, -1);
+    on_pos.resize(M->on_proc->nnz);
+    off_pos.resize(M->off_proc->nnz);
+    for (int i = 0; i < M->local_num_rows; i++)
+    {
+        start = P->on_proc->idx1[i];
+        end = P->on_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            on_marker[P->on_proc->idx2[j]] = j;
+        }
+        for (int j = M->on_proc->idx1[i]; j < M->on_proc->idx1[i+1]; j++)
+        {
+            col = on_to_P[M->on_proc->idx2[j]];
+            pos = col >= 0 ? on_marker[col] : -1;
+            on_pos[j] = (pos >= start && pos < end) ? pos : -1;
+        }
+
+        start = P->off_proc->idx1[i];
+        end = P->off_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            off_marker[P->off_proc->idx2[j]] = j;
+        }
+        for (int j = M->off_proc->idx1[i]; j < M->off_proc->idx1[i+1]; j++)
+        {
+            col = off_to_P[M->off_proc->idx2[j]];
+            pos = col >= 0 ? off_marker[col] : -1;
+            off_pos[j] = (pos >= start && pos < end) ? P_on_nnz + pos : -1;
+        }
+    }
+}
+
+// Restricts the entries of M to pattern P, returning values aligned
+// with those of P
+static void restrict_to_pattern(ParCSRMatrix* M, ParCSRMatrix* P,
+        aligned_vector<double>& vals)
+{
+    aligned_vector<int> on_pos;
+    aligned_vector<int> off_pos;
+    pattern_positions(M, P, on_pos, off_pos);
+
+    vals.assign(P->local_nnz, 0.0);
+    for (int j = 0; j < M->on_proc->nnz; j++)
+    {
+        if (on_pos[j] >= 0) vals[on_pos[j]] += M->on_proc->vals[j];
+    }
+    for (int j = 0; j < M->off_proc->nnz; j++)
+    {
+        if (off_pos[j] >= 0) vals[off_pos[j]] += M->off_proc->vals[j];
+    }
+}
+
+static void set_pattern_values(ParCSRMatrix* P, const aligned_vector<double>& vals)
+{
+    int P_on_nnz = P->on_proc->nnz;
+    for (int j = 0; j < P_on_nnz; j++)
+    {
+        P->on_proc->vals[j] = vals[j];
+    }
+    for (int j = 0; j < P->off_proc->nnz; j++)
+    {
+        P->off_proc->vals[j] = vals[P_on_nnz + j];
+    }
+}
+
+static double pattern_inner_product(const aligned_vector<double>& x,
+        const aligned_vector<double>& y, RAPtor_MPI_Comm comm)
+{
+    double sum = 0.0;
+    if (reproducible_reductions)
+    {
+        ReproSum repro_sum;
+        for (int j = 0; j < (int) x.size(); j++)
+        {
+            repro_sum.add(x[j] * y[j]);
+        }
+        repro_allreduce(&repro_sum, &sum, 1, comm);
+        return sum;
+    }
+
+    for (int j = 0; j < (int) x.size(); j++)
+    {
+        sum += x[j] * y[j];
+    }
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &sum, 1, RAPtor_MPI_DOUBLE, RAPtor_MPI_SUM,
+            comm);
+    return sum;
+}
+
+/**************************************************************
+ *****   Project Constraints
+ **************************************************************
+ ***** Projects each row u_i of the values of P (within the
+ ***** pattern) onto the space of u_i B_i = 0, where B_i holds the
+ ***** coarse candidates of the columns in row i:
+ *****     u_i -= (u_i B_i) (B_i^T B_i)^{-1} B_i^T
+ ***** using the Cholesky factors R_i of B_i^T B_i
+ **************************************************************/
+static void project_constraints(ParCSRMatrix* P, aligned_vector<double>& vals,
+        const aligned_vector<int>& on_bc, const aligned_vector<double>& bc_on,
+        const aligned_vector<double>& bc_off, const aligned_vector<double>& R,
+        const int nc)
+{
+    int P_on_nnz = P->on_proc->nnz;
+    double val, diag;
+    const double* bc;
+    const double* R_i;
+    aligned_vector<double> y(nc);
+
+    for (int i = 0; i < P->local_num_rows; i++)
+    {
+        for (int k = 0; k < nc; k++)
+        {
+            y[k] = 0.0;
+        }
+
+        // y = u_i B_i
+        for (int j = P->on_proc->idx1[i]; j < P->on_proc->idx1[i+1]; j++)
+        {
+            bc = &(bc_on[on_bc[P->on_proc->idx2[j]]*nc]);
+            for (int k = 0; k < nc; k++)
+            {
+                y[k] += vals[j] * bc[k];
+            }
+        }
+        for (int j = P->off_proc->idx1[i]; j < P->off_proc->idx1[i+1]; j++)
+        {
+            bc = &(bc_off[P->off_proc->idx2[j]*nc]);
+            for (int k = 0; k < nc; k++)
+            {
+                y[k] += vals[P_on_nnz + j] * bc[k];
+            }
+        }
+
+        // y = (R_i^T R_i)^{-1} y, dropped candidates set to zero
+        R_i = &(R[i*nc*nc]);
+        for (int k = 0; k < nc; k++)
+        {
+            diag = R_i[k*nc + k];
+            val = y[k];
+            for (int l = 0; l < k; l++)
+            {
+                val -= R_i[l*nc + k] * y[l];
+            }
+            y[k] = diag != 0.0 ? val / diag : 0.0;
+        }
+        for (int k = nc - 1; k >= 0; k--)
+        {
+            diag = R_i[k*nc + k];
+            val = y[k];
+            for (int l = k + 1; l < nc; l++)
+            {
+                val -= R_i[k*nc + l] * y[l];
+            }
+            y[k] = diag != 0.0 ? val / diag : 0.0;
+        }
+
+        // u_i -= y B_i^T
+        for (int j = P->on_proc->idx1[i]; j < P->on_proc->idx1[i+1]; j++)
+        {
+            bc = &(bc_on[on_bc[P->on_proc->idx2[j]]*nc]);
+            for (int k = 0; k < nc; k++)
+            {
+                vals[j] -= y[k] * bc[k];
+            }
+        }
+        for (int j = P->off_proc->idx1[i]; j < P->off_proc->idx1[i+1]; j++)
+        {
+            bc = &(bc_off[P->off_proc->idx2[j]*nc]);
+            for (int k = 0; k < nc; k++)
+            {
+                vals[P_on_nnz + j] -= y[k] * bc[k];
+            }
+        }
+    }
+}
+
+// Constrained, Jacobi-preconditioned CG on the pattern of |A_pattern|^degree |T|
+ParCSRMatrix* energy_prolongation(ParCSRMatrix* A, ParCSRMatrix* T,
+        ParCSRMatrix* A_pattern, const aligned_vector<double>& B_coarse,
+        int num_candidates, bool tap_comm, int degree, int num_iterations)
+{
+    int nc = num_candidates;
+    int n_coarse = T->on_proc_num_cols;
+    int P_nnz;
+    double new_sum, old_sum, init_sum, beta, alpha, denom;
+    ParCSRMatrix* P_tmp;
+    ParCSRMatrix* AP;
+
+    // Sparsity pattern of P : |A_pattern|^degree |T|
+    ParCSRMatrix* A_abs = A_pattern->copy();
+    for (int j = 0; j < A_abs->on_proc->nnz; j++)
+    {
+        A_abs->on_proc->vals[j] = fabs(A_abs->on_proc->vals[j]);
+    }
+    for (int j = 0; j < A_abs->off_proc->nnz; j++)
+    {
+        A_abs->off_proc->vals[j] = fabs(A_abs->off_proc->vals[j]);
+    }
+    ParCSRMatrix* P = T->copy();
+    for (int j = 0; j < P->on_proc->nnz; j++)
+    {
+        P->on_proc->vals[j] = fabs(P->on_proc->vals[j]);
+    }
+    for (int j = 0; j < P->off_proc->nnz; j++)
+    {
+        P->off_proc->vals[j] = fabs(P->off_proc->vals[j]);
+    }
+    for (int d = 0; d < degree; d++)
+    {
+        P_tmp = A_abs->mult(P, tap_comm);
+        delete P;
+        P = P_tmp;
+    }
+    delete A_abs;
+    P_nnz = P->local_nnz;
+
+    // Coarse candidates of each column in pattern (fetching off_proc rows)
+    aligned_vector<double> bc_on;
+    if (n_coarse) bc_on.resize(n_coarse * nc);
+    for (int i = 0; i < n_coarse; i++)
+    {
+        for (int k = 0; k < nc; k++)
+        {
+            bc_on[i*nc + k] = B_coarse[k*n_coarse + i];
+        }
+    }
+    IndexMap T_on_map(T->on_proc_column_map);
+    aligned_vector<int> on_bc(P->on_proc_num_cols);
+    for (int i = 0; i < P->on_proc_num_cols; i++)
+    {
+        on_bc[i] = T_on_map[P->on_proc_column_map[i]];
+    }
+    CommPkg* bc_comm;
+    if (tap_comm)
+    {
+        bc_comm = new TAPComm(T->partition, P->off_proc_column_map,
+                T->on_proc_column_map, false);
+    }
+    else
+    {
+        bc_comm = new ParComm(T->partition, P->off_proc_column_map,
+                T->on_proc_column_map, A->comm->key, A->comm->mpi_comm);
+    }
+    aligned_vector<double> bc_off = bc_comm->communicate(bc_on, nc);
+    delete bc_comm;
+
+    // Cholesky factors of the constraint Gram matrix of each row
+    aligned_vector<double> G(nc*nc);
+    aligned_vector<double> R;
+    if (P->local_num_rows) R.resize(P->local_num_rows * nc * nc);
+    for (int i = 0; i < P->local_num_rows; i++)
+    {
+        std::fill(G.begin(), G.end(), 0.0);
+        for (int j = P->on_proc->idx1[i]; j < P->on_proc->idx1[i+1]; j++)
+        {
+            const double* bc = &(bc_on[on_bc[P->on_proc->idx2[j]]*nc]);
+            for (int k = 0; k < nc; k++)
+            {
+                for (int l = 0; l < nc; l++)
+                {
+                    G[k*nc + l] += bc[k] * bc[l];
+                }
+            }
+        }
+        for (int j = P->off_proc->idx1[i]; j < P->off_proc->idx1[i+1]; j++)
+        {
+            const double* bc = &(bc_off[P->off_proc->idx2[j]*nc]);
+            for (int k = 0; k < nc; k++)
+            {
+                for (int l = 0; l < nc; l++)
+                {
+                    G[k*nc + l] += bc[k] * bc[l];
+                }
+            }
+        }
+        aggregate_cholesky(G.data(), &(R[i*nc*nc]), nc, 1e-10);
+    }
+
+    // Inverse diagonal of A (Jacobi preconditioner)
+    aligned_vector<double> inv_diag;
+    if (A->local_num_rows) inv_diag.resize(A->local_num_rows, 0.0);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        for (int j = A->on_proc->idx1[i]; j < A->on_proc->idx1[i+1]; j++)
+        {
+            if (A->on_proc->idx2[j] == i)
+            {
+                if (A->on_proc->vals[j] != 0.0)
+                    inv_diag[i] = 1.0 / A->on_proc->vals[j];
+                break;
+            }
+        }
+    }
+
+    // Initial guess T, and residual -A T (within pattern, constrained)
+    aligned_vector<double> P_vals;
+    aligned_vector<double> res;
+    aligned_vector<double> Z(P_nnz);
+    aligned_vector<double> D(P_nnz);
+    aligned_vector<double> AD;
+    restrict_to_pattern(T, P, P_vals);
+    set_pattern_values(P, P_vals);
+    AP = A->mult(P, tap_comm);
+    restrict_to_pattern(AP, P, res);
+    delete AP;
+    for (int j = 0; j < P_nnz; j++)
+    {
+        res[j] = -res[j];
+    }
+    project_constraints(P, res, on_bc, bc_on, bc_off, R, nc);
+
+    old_sum = 0.0;
+    init_sum = 0.0;
+    for (int iter = 0; iter < num_iterations; iter++)
+    {
+        // Z = D^{-1} res
+        for (int i = 0; i < P->local_num_rows; i++)
+        {
+            for (int j = P->on_proc->idx1[i]; j < P->on_proc->idx1[i+1]; j++)
+            {
+                Z[j] = inv_diag[i] * res[j];
+            }
+            for (int j = P->off_proc->idx1[i]; j < P->off_proc->idx1[i+1]; j++)
+            {
+                Z[P->on_proc->nnz + j] = inv_diag[i] * res[P->on_proc->nnz + j];
+            }
+        }
+        project_constraints(P, Z, on_bc, bc_on, bc_off, R, nc);
+
+        new_sum = pattern_inner_product(res, Z, A->comm->mpi_comm);
+        if (iter == 0) init_sum = new_sum;
+        if (new_sum <= 1e-28 * init_sum || new_sum <= 0.0)
+        {
+            break;
+        }
+
+        // Update search direction
+        if (iter == 0)
+        {
+            D = Z;
+        }
+        else
+        {
+            beta = new_sum / old_sum;
+            for (int j = 0; j < P_nnz; j++)
+            {
+                D[j] = Z[j] + beta * D[j];
+            }
+        }
+        old_sum = new_sum;
+
+        // AD = A D (within pattern, constrained)
+        set_pattern_values(P, D);
+        AP = A->mult(P, tap_comm);
+        restrict_to_pattern(AP, P, AD);
+        delete AP;
+        project_constraints(P, AD, on_bc, bc_on, bc_off, R, nc);
+
+        denom = pattern_inner_product(D, AD, A->comm->mpi_comm);
+        if (denom <= 0.0)
+        {
+            break;
+        }
+        alpha = new_sum / denom;
+        for (int j = 0; j < P_nnz; j++)
+        {
+            P_vals[j] += alpha * D[j];
+            res[j] -= alpha * AD[j];
+        }
+    }
+    set_pattern_values(P, P_vals);
+
+    if (tap_comm)
+    {
+        P->init_tap_communicators();
+    }
+    else
+    {
+        P->comm = new ParComm(P->partition, P->off_proc_column_map, 
+                P->on_proc_column_map, A->comm->key, A->comm->mpi_comm);
+    }
+
+    return P;
+}
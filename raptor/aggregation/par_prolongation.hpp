@@ -11,5 +11,41 @@ using namespace raptor;
 
 ParCSRMatrix* jacobi_prolongation(ParCSRMatrix* A, ParCSRMatrix* T, bool tap_comm = false,
         double omega = 4.0/3, int num_smooth_steps = 1);
+
+/**************************************************************
+ *****   Filter Matrix
+ **************************************************************
+ ***** Returns A with weak connections (by the given strength of
+ ***** connection) removed and added to the diagonal, so that row
+ ***** sums are preserved.  Smoothing T with the filtered matrix
+ ***** keeps P (and the coarse operator) sparse.
+ **************************************************************/
+ParCSRMatrix* filter_matrix(ParCSRMatrix* A, strength_t strength_type,
+        double theta, bool tap_comm = false);
+
+/**************************************************************
+ *****   Energy Minimizing Prolongation
+ **************************************************************
+ ***** Minimizes the energy of each column of P, within the fixed
+ ***** sparsity pattern of |A_pattern|^degree |T|, subject to P
+ ***** interpolating the coarse candidates exactly as T does
+ ***** (P B_coarse = T B_coarse).  Performs num_iterations of
+ ***** Jacobi-preconditioned conjugate gradient, starting from T.
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** A : ParCSRMatrix*
+ *****    Matrix being coarsened
+ ***** T : ParCSRMatrix*
+ *****    Tentative interpolation
+ ***** A_pattern : ParCSRMatrix*
+ *****    Matrix defining the sparsity pattern (A, or filtered A)
+ ***** B_coarse : aligned_vector<double>&
+ *****    Coarse candidates, as returned by fit_candidates
+ **************************************************************/
+ParCSRMatrix* energy_prolongation(ParCSRMatrix* A, ParCSRMatrix* T,
+        ParCSRMatrix* A_pattern, const aligned_vector<double>& B_coarse,
+        int num_candidates = 1, bool tap_comm = false, int degree = 1,
+        int num_iterations = 4);
 #endif
 
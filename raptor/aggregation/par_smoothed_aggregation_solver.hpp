@@ -26,9 +26,12 @@ namespace raptor
             agg_type = _agg_type;
             prolong_type = _prolong_type;
             num_candidates = 1;
+            num_functions = 1;
             interp_tol = 1e-10;
             prolong_smooth_steps = _prolong_smooth_steps;
             prolong_weight = _prolong_weight;
+            filter_prolongation = false;
+            energy_iterations = 4;
         }
 
         ~ParSmoothedAggregationSolver()
@@ -37,7 +40,6 @@ namespace raptor
 
         void setup(ParCSRMatrix* Af) 
         {
-            // TODO -- add option for B to be passed as variable
             num_candidates = 1;
             B.resize(Af->local_num_rows);
             for (int i = 0; i < Af->local_num_rows; i++)
@@ -48,6 +50,22 @@ namespace raptor
             setup_helper(Af);
         }
 
+        // Setup with near nullspace candidates _B, stored by candidate
+        // (_B[j*local_num_rows + i] is candidate j at row i), such as
+        // the rigid body modes of elasticity.  Rows of Af are grouped
+        // in nodes of _num_functions consecutive unknowns, which are
+        // aggregated together.
+        void setup(ParCSRMatrix* Af, const aligned_vector<double>& _B,
+                int _num_candidates, int _num_functions = 1)
+        {
+            num_candidates = _num_candidates;
+            num_functions = _num_functions;
+            B.resize(Af->local_num_rows * num_candidates);
+            std::copy(_B.begin(), _B.begin() + B.size(), B.begin());
+
+            setup_helper(Af);
+        }
+
         void extend_hierarchy()
         {
             int level_ctr = levels.size() - 1;
@@ -65,8 +83,17 @@ namespace raptor
             aligned_vector<double> R;
             int n_aggs;
 
+            // Unknowns of each node are aggregated together (coarse
+            // levels have one unknown per candidate in each node)
+            int block_size = level_ctr == 0 ? num_functions : num_candidates;
+            ParCSRMatrix* A_node = A;
+            if (block_size > 1)
+            {
+                A_node = amalgamate(A, block_size, tap_level);
+            }
+
             // Form strength of connection
-            S = A->strength(strength_type, strong_threshold, tap_level, 
+            S = A_node->strength(strength_type, strong_threshold, tap_level, 
                     1, NULL);
 
             // Aggregate Nodes
@@ -74,22 +101,54 @@ namespace raptor
             {
                 case MIS:
                     mis2(S, states, off_proc_states, tap_level, weights);
-                    n_aggs = aggregate(A, S, states, off_proc_states, 
+                    n_aggs = aggregate(A_node, S, states, off_proc_states, 
                             aggregates, tap_level);
                     break;
             }
 
+            // Aggregate of each unknown, labeled by first unknown of
+            // the root node
+            if (block_size > 1)
+            {
+                aligned_vector<int> node_aggregates;
+                node_aggregates.swap(aggregates);
+                aggregates.resize(A->local_num_rows);
+                for (int i = 0; i < A->local_num_rows; i++)
+                {
+                    int agg = node_aggregates[i / block_size];
+                    aggregates[i] = agg >= 0 ? agg * block_size : -1;
+                }
+                delete A_node;
+            }
+
             // Form tentative interpolation
             T = fit_candidates(A, n_aggs, aggregates, B, R, 
                     num_candidates, false, interp_tol);
             
 
+            // Smooth with A, or with A filtered of weak connections
+            ParCSRMatrix* A_smooth = A;
+            if (filter_prolongation)
+            {
+                A_smooth = filter_matrix(A, strength_type, strong_threshold, 
+                        tap_level);
+            }
+
             switch (prolong_type)
             {
                 case JacobiProlongation:
-                    P = jacobi_prolongation(A, T, tap_level, 
+                    P = jacobi_prolongation(A_smooth, T, tap_level, 
                             prolong_weight, prolong_smooth_steps);
                     break;
+                case EnergyMinProlongation:
+                    P = energy_prolongation(A, T, A_smooth, R, num_candidates,
+                            tap_level, prolong_smooth_steps, energy_iterations);
+                    break;
+            }
+
+            if (A_smooth != A)
+            {
+                delete A_smooth;
             }
             levels[level_ctr]->P = P;
 
@@ -105,9 +164,12 @@ namespace raptor
             A->comm = new ParComm(A->partition, A->off_proc_column_map,
                     A->on_proc_column_map, levels[level_ctr-1]->A->comm->key,
                     levels[level_ctr-1]->A->comm->mpi_comm);
-            levels[level_ctr]->x.resize(A->global_num_rows, A->local_num_rows);
-            levels[level_ctr]->b.resize(A->global_num_rows, A->local_num_rows);
-            levels[level_ctr]->tmp.resize(A->global_num_rows, A->local_num_rows);
+            levels[level_ctr]->x.resize(A->global_num_rows, A->local_num_rows,
+                    A->partition->topology->comm);
+            levels[level_ctr]->b.resize(A->global_num_rows, A->local_num_rows,
+                    A->partition->topology->comm);
+            levels[level_ctr]->tmp.resize(A->global_num_rows, A->local_num_rows,
+                    A->partition->topology->comm);
             levels[level_ctr]->P = NULL;
 
             if (tap_amg >= 0 && tap_amg <= level_ctr)
@@ -121,7 +183,7 @@ namespace raptor
                         true, A->comm->mpi_comm);
             }
 
-            std::copy(R.begin(), R.end(), B.begin());
+            B.swap(R);
 
             delete AP;
             delete T;
@@ -138,6 +200,14 @@ namespace raptor
         int prolong_smooth_steps;
         int num_candidates;
 
+        // Smooth P with filtered A (weak connections lumped to diagonal)
+        bool filter_prolongation;
+
+        // CG iterations of energy minimizing prolongation, whose pattern
+        // is that of prolong_smooth_steps Jacobi smoothing steps
+        int energy_iterations;
+        int num_functions;
+
     };
 }
    
@@ -89,3 +89,185 @@ TEST(TestParCandidates, TestsInAggregation)
 
 
 
+
+TEST(TestParCandidates, TestMultipleCandidates)
+{ 
+    int grid[2] = {40, 40};
+    double* stencil = diffusion_stencil_2d();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    aligned_vector<int> states;
+    aligned_vector<int> off_proc_states;
+    aligned_vector<int> aggregates;
+    aligned_vector<double> B;
+    aligned_vector<double> R;
+
+    ParCSRMatrix* S = A->strength(Symmetric, 0.0);
+    mis2(S, states, off_proc_states);
+    int n_aggs = aggregate(A, S, states, off_proc_states, aggregates);
+
+    // Constant and linear (in x) candidates
+    int num_candidates = 2;
+    int n = A->local_num_rows;
+    B.resize(n * num_candidates);
+    for (int i = 0; i < n; i++)
+    {
+        int global_row = A->local_row_map[i];
+        B[i] = 1.0;
+        B[n + i] = (double) (global_row % grid[0]) / grid[0];
+    }
+
+    ParCSRMatrix* T = fit_candidates(A, n_aggs, aggregates, B, R, 
+            num_candidates, false, 1e-10);
+    ASSERT_EQ(T->on_proc_num_cols, n_aggs * num_candidates);
+    ASSERT_EQ((int) R.size(), n_aggs * num_candidates * num_candidates);
+
+    // Candidates are interpolated exactly from coarse candidates
+    ParVector Bc(T->global_num_cols, T->on_proc_num_cols);
+    ParVector Bf(A->global_num_rows, n);
+    for (int j = 0; j < num_candidates; j++)
+    {
+        for (int i = 0; i < T->on_proc_num_cols; i++)
+        {
+            Bc[i] = R[j*T->on_proc_num_cols + i];
+        }
+        T->mult(Bc, Bf);
+        for (int i = 0; i < n; i++)
+        {
+            if (aggregates[i] < 0) continue;
+            ASSERT_NEAR(Bf[i], B[j*n + i], 1e-10);
+        }
+    }
+
+    // Columns of T are orthonormal
+    ParCSRMatrix* TT = T->mult_T(T);
+    for (int i = 0; i < TT->local_num_rows; i++)
+    {
+        for (int j = TT->on_proc->idx1[i]; j < TT->on_proc->idx1[i+1]; j++)
+        {
+            int col = TT->on_proc_column_map[TT->on_proc->idx2[j]];
+            double val = col == T->on_proc_column_map[i] ? 1.0 : 0.0;
+            ASSERT_NEAR(TT->on_proc->vals[j], val, 1e-10);
+        }
+        for (int j = TT->off_proc->idx1[i]; j < TT->off_proc->idx1[i+1]; j++)
+        {
+            ASSERT_NEAR(TT->off_proc->vals[j], 0.0, 1e-10);
+        }
+    }
+
+    delete TT;
+    delete T;
+    delete S;
+    delete A;
+
+} // end of TEST(TestParCandidates, TestMultipleCandidates) //
+
+TEST(TestParCandidates, TestDependentCandidates)
+{ 
+    int grid[2] = {40, 40};
+    double* stencil = diffusion_stencil_2d();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    aligned_vector<int> states;
+    aligned_vector<int> off_proc_states;
+    aligned_vector<int> aggregates;
+    aligned_vector<double> B;
+    aligned_vector<double> R;
+
+    ParCSRMatrix* S = A->strength(Symmetric, 0.0);
+    mis2(S, states, off_proc_states);
+    int n_aggs = aggregate(A, S, states, off_proc_states, aggregates);
+
+    // Constant, linear, and their sum : the third candidate is
+    // dependent on every aggregate
+    int num_candidates = 3;
+    int n = A->local_num_rows;
+    B.resize(n * num_candidates);
+    for (int i = 0; i < n; i++)
+    {
+        int global_row = A->local_row_map[i];
+        B[i] = 1.0;
+        B[n + i] = (double) (global_row % grid[0]) / grid[0];
+        B[2*n + i] = B[i] + B[n + i];
+    }
+
+    ParCSRMatrix* T = fit_candidates(A, n_aggs, aggregates, B, R, 
+            num_candidates, false, 1e-10);
+    int n_coarse = T->on_proc_num_cols;
+    ASSERT_EQ(n_coarse, n_aggs * num_candidates);
+
+    // Dropped columns have a zero diagonal in R
+    aligned_vector<int> dropped(n_coarse);
+    for (int i = 0; i < n_coarse; i++)
+    {
+        int k = i % num_candidates;
+        dropped[i] = R[k*n_coarse + i] == 0.0;
+    }
+    for (int a = 0; a < n_aggs; a++)
+    {
+        ASSERT_TRUE(dropped[a*num_candidates + 2]);
+    }
+
+    // Dropped columns of T are exactly zero
+    for (int i = 0; i < T->local_num_rows; i++)
+    {
+        for (int j = T->on_proc->idx1[i]; j < T->on_proc->idx1[i+1]; j++)
+        {
+            if (dropped[T->on_proc->idx2[j]])
+            {
+                ASSERT_EQ(T->on_proc->vals[j], 0.0);
+            }
+        }
+    }
+
+    // Candidates are still interpolated exactly from coarse candidates
+    ParVector Bc(T->global_num_cols, n_coarse);
+    ParVector Bf(A->global_num_rows, n);
+    for (int j = 0; j < num_candidates; j++)
+    {
+        for (int i = 0; i < n_coarse; i++)
+        {
+            Bc[i] = R[j*n_coarse + i];
+        }
+        T->mult(Bc, Bf);
+        for (int i = 0; i < n; i++)
+        {
+            if (aggregates[i] < 0) continue;
+            ASSERT_NEAR(Bf[i], B[j*n + i], 1e-10);
+        }
+    }
+
+    // Remaining columns of T are orthonormal, dropped columns are zero
+    ParCSRMatrix* TT = T->mult_T(T);
+    for (int i = 0; i < TT->local_num_rows; i++)
+    {
+        for (int j = TT->on_proc->idx1[i]; j < TT->on_proc->idx1[i+1]; j++)
+        {
+            int col = TT->on_proc_column_map[TT->on_proc->idx2[j]];
+            if (dropped[i])
+            {
+                ASSERT_EQ(TT->on_proc->vals[j], 0.0);
+                continue;
+            }
+            double val = col == T->on_proc_column_map[i] ? 1.0 : 0.0;
+            ASSERT_NEAR(TT->on_proc->vals[j], val, 1e-10);
+        }
+        for (int j = TT->off_proc->idx1[i]; j < TT->off_proc->idx1[i+1]; j++)
+        {
+            if (dropped[i])
+            {
+                ASSERT_EQ(TT->off_proc->vals[j], 0.0);
+                continue;
+            }
+            ASSERT_NEAR(TT->off_proc->vals[j], 0.0, 1e-10);
+        }
+    }
+
+    delete TT;
+    delete T;
+    delete S;
+    delete A;
+
+} // end of TEST(TestParCandidates, TestDependentCandidates) //
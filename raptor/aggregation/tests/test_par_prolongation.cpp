@@ -50,6 +50,116 @@ TEST(TestParProlongation, TestsInAggregation)
 
 } // end of TEST(TestParSplitting, TestsInRuge_Stuben) //
 
+TEST(TestParProlongation, TestFilterMatrix)
+{ 
+    const char* A0_fn = "../../../../test_data/sas_A0.pm";
+    ParCSRMatrix* A = readParMatrix(A0_fn);
+    ParCSRMatrix* A_F = filter_matrix(A, Symmetric, 0.25);
+
+    int nnz, nnz_F;
+    int local_nnz = A->local_nnz;
+    int local_nnz_F = A_F->local_nnz;
+    MPI_Allreduce(&local_nnz, &nnz, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(&local_nnz_F, &nnz_F, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    ASSERT_LE(nnz_F, nnz);
+
+    // Weak entries are lumped to the diagonal, preserving row sums
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        double sum = 0.0;
+        double sum_F = 0.0;
+        for (int j = A->on_proc->idx1[i]; j < A->on_proc->idx1[i+1]; j++)
+            sum += A->on_proc->vals[j];
+        for (int j = A->off_proc->idx1[i]; j < A->off_proc->idx1[i+1]; j++)
+            sum += A->off_proc->vals[j];
+        for (int j = A_F->on_proc->idx1[i]; j < A_F->on_proc->idx1[i+1]; j++)
+            sum_F += A_F->on_proc->vals[j];
+        for (int j = A_F->off_proc->idx1[i]; j < A_F->off_proc->idx1[i+1]; j++)
+            sum_F += A_F->off_proc->vals[j];
+        ASSERT_NEAR(sum, sum_F, 1e-10);
+    }
+
+    delete A_F;
+    delete A;
 
+} // end of TEST(TestParProlongation, TestFilterMatrix) //
+
+TEST(TestParProlongation, TestEnergyProlongation)
+{ 
+    const char* A0_fn = "../../../../test_data/sas_A0.pm";
+    const char* T0_fn = "../../../../test_data/sas_T0.pm";
 
+    ParCSRMatrix* A = readParMatrix(A0_fn);
+    ParCSRMatrix* T = readParMatrix(T0_fn);
+
+    // Coarse candidates of the constant (T has orthonormal columns)
+    ParVector ones(A->global_num_rows, A->local_num_rows);
+    ParVector Bc(T->global_num_cols, T->on_proc_num_cols);
+    ones.set_const_value(1.0);
+    T->mult_T(ones, Bc);
+    aligned_vector<double> B_coarse(T->on_proc_num_cols);
+    for (int i = 0; i < T->on_proc_num_cols; i++)
+    {
+        B_coarse[i] = Bc.local[i];
+    }
+
+    ParCSRMatrix* P = energy_prolongation(A, T, A, B_coarse);
+
+    // P interpolates coarse candidates exactly as T does
+    ParVector TBc(A->global_num_rows, A->local_num_rows);
+    ParVector PBc(A->global_num_rows, A->local_num_rows);
+    T->mult(Bc, TBc);
+    P->mult(Bc, PBc);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        ASSERT_NEAR(PBc.local[i], TBc.local[i], 1e-8);
+    }
+
+    // Energy (trace of P^T A P) is no larger than that of T
+    ParCSRMatrix* AT = A->mult(T);
+    ParCSRMatrix* TAT = AT->mult_T(T);
+    ParCSRMatrix* AP = A->mult(P);
+    ParCSRMatrix* PAP = AP->mult_T(P);
+    double local_traces[2] = {0.0, 0.0};
+    double traces[2];
+    ParCSRMatrix* coarse[2] = {TAT, PAP};
+    for (int k = 0; k < 2; k++)
+    {
+        ParCSRMatrix* C = coarse[k];
+        for (int i = 0; i < C->local_num_rows; i++)
+        {
+            for (int j = C->on_proc->idx1[i]; j < C->on_proc->idx1[i+1]; j++)
+            {
+                if (C->on_proc_column_map[C->on_proc->idx2[j]] == C->local_row_map[i])
+                    local_traces[k] += C->on_proc->vals[j];
+            }
+        }
+    }
+    MPI_Allreduce(local_traces, traces, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    ASSERT_LE(traces[1], traces[0]);
+
+    // Same interpolation with reproducible reductions
+    reproducible_reductions = true;
+    ParCSRMatrix* P_repro = energy_prolongation(A, T, A, B_coarse);
+    reproducible_reductions = false;
+    ASSERT_EQ(P_repro->on_proc->nnz, P->on_proc->nnz);
+    ASSERT_EQ(P_repro->off_proc->nnz, P->off_proc->nnz);
+    for (int j = 0; j < P->on_proc->nnz; j++)
+    {
+        ASSERT_NEAR(P_repro->on_proc->vals[j], P->on_proc->vals[j], 1e-10);
+    }
+    for (int j = 0; j < P->off_proc->nnz; j++)
+    {
+        ASSERT_NEAR(P_repro->off_proc->vals[j], P->off_proc->vals[j], 1e-10);
+    }
+
+    delete P_repro;
+    delete PAP;
+    delete AP;
+    delete TAT;
+    delete AT;
+    delete P;
+    delete A;
+    delete T;
 
+} // end of TEST(TestParProlongation, TestEnergyProlongation) //
@@ -312,12 +312,15 @@ namespace raptor
         ***** -------------
         ***** _key : int (optional)
         *****    Tag to be used in RAPtor_MPI Communication (default 0)
+        ***** _comm : RAPtor_MPI_Comm (optional)
+        *****    Communicator to use.  Defaults to the communicator of
+        *****    the partition's topology.
         **************************************************************/
         ParComm(Partition* partition, int _key = 0, 
-                RAPtor_MPI_Comm _comm = RAPtor_MPI_COMM_WORLD,
+                RAPtor_MPI_Comm _comm = RAPtor_MPI_COMM_NULL,
                 CommData* r_data = NULL) : CommPkg(partition)
         {
-            mpi_comm = _comm;
+            mpi_comm = default_comm(_comm);
             key = _key;
             send_data = new NonContigData();
             if (r_data)
@@ -327,10 +330,10 @@ namespace raptor
         }
 
         ParComm(Topology* topology, int _key = 0, 
-                RAPtor_MPI_Comm _comm = RAPtor_MPI_COMM_WORLD,
+                RAPtor_MPI_Comm _comm = RAPtor_MPI_COMM_NULL,
                 CommData* r_data = NULL) : CommPkg(topology)
         {
-            mpi_comm = _comm;
+            mpi_comm = default_comm(_comm);
             key = _key;
             send_data = new NonContigData();
             if (r_data)
@@ -350,30 +353,33 @@ namespace raptor
         *****    Maps local off_proc columns indices to global
         ***** _key : int (optional)
         *****    Tag to be used in RAPtor_MPI Communication (default 9999)
+        ***** comm : RAPtor_MPI_Comm (optional)
+        *****    Communicator to use.  Defaults to the communicator of
+        *****    the partition's topology.
         **************************************************************/
         ParComm(Partition* partition,
                 const aligned_vector<int>& off_proc_column_map,
                 int _key = 9999,
-                RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD,
+                RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_NULL,
                 CommData* r_data = NULL) : CommPkg(partition)
         {
-            mpi_comm = comm;
-            init_par_comm(partition, off_proc_column_map, _key, comm, r_data);
+            mpi_comm = default_comm(comm);
+            init_par_comm(partition, off_proc_column_map, _key, mpi_comm, r_data);
         }
 
         ParComm(Partition* partition,
                 const aligned_vector<int>& off_proc_column_map,
                 const aligned_vector<int>& on_proc_column_map,
                 int _key = 9999, 
-                RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD,
+                RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_NULL,
                 CommData* r_data = NULL) : CommPkg(partition)
         {
-            mpi_comm = comm;
+            mpi_comm = default_comm(comm);
             int idx;
             int ctr = 0;
             aligned_vector<int> part_col_to_new;
 
-            init_par_comm(partition, off_proc_column_map, _key, comm, r_data);
+            init_par_comm(partition, off_proc_column_map, _key, mpi_comm, r_data);
             
             if (partition->local_num_cols)
             {
@@ -394,6 +400,13 @@ namespace raptor
 	    
         }
 
+        RAPtor_MPI_Comm default_comm(RAPtor_MPI_Comm comm)
+        {
+            if (comm == RAPtor_MPI_COMM_NULL)
+                return topology->comm;
+            return comm;
+        }
+
         void init_par_comm(Partition* partition,
                 const aligned_vector<int>& off_proc_column_map,
                 int _key, RAPtor_MPI_Comm comm,
@@ -456,7 +469,7 @@ namespace raptor
                 recv_sizes[recv_data->procs[i]] = 
                     recv_data->indptr[i+1] - recv_data->indptr[i];
             RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, recv_sizes.data(), num_procs, RAPtor_MPI_INT,
-                    RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+                    RAPtor_MPI_SUM, comm);
             if (profile) vec_t -= RAPtor_MPI_Wtime();
             recv_data->send(off_proc_column_map.data(), tag, comm);
             send_data->probe(recv_sizes[rank], tag, comm);
@@ -1021,7 +1034,7 @@ namespace raptor
 
             local_R_par_comm = new ParComm(partition, 3456, partition->topology->local_comm,
                     new NonContigData());
-            global_par_comm = new ParComm(partition, 5678, RAPtor_MPI_COMM_WORLD,
+            global_par_comm = new ParComm(partition, 5678, partition->topology->comm,
                     new DuplicateData());
 
             if (L_comm)
@@ -1056,7 +1069,7 @@ namespace raptor
         TAPComm(Partition* partition, 
                 const aligned_vector<int>& off_proc_column_map,
                 bool form_S = true,
-                RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD)
+                RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_NULL)
                 : CommPkg(partition)
         {
             if (form_S)
@@ -1073,7 +1086,7 @@ namespace raptor
                 const aligned_vector<int>& off_proc_column_map,
                 const aligned_vector<int>& on_proc_column_map,
                 bool form_S = true,
-                RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD)
+                RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_NULL)
                 : CommPkg(partition)
         {
             aligned_vector<int> on_proc_to_new;
@@ -1319,6 +1332,7 @@ namespace raptor
                 RAPtor_MPI_Comm comm)
         {
             // Get RAPtor_MPI Information
+            if (comm == RAPtor_MPI_COMM_NULL) comm = partition->topology->comm;
             int rank, num_procs;
             RAPtor_MPI_Comm_rank(comm, &rank);
             RAPtor_MPI_Comm_size(comm, &num_procs);
@@ -1384,6 +1398,7 @@ namespace raptor
                 RAPtor_MPI_Comm comm)
         {
             // Get RAPtor_MPI Information
+            if (comm == RAPtor_MPI_COMM_NULL) comm = partition->topology->comm;
             int rank, num_procs;
             RAPtor_MPI_Comm_rank(comm, &rank);
             RAPtor_MPI_Comm_size(comm, &num_procs);
@@ -0,0 +1,119 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#ifndef RAPTOR_CORE_INDEX_MAP_HPP
+#define RAPTOR_CORE_INDEX_MAP_HPP
+
+#include "types.hpp"
+
+/**************************************************************
+ *****   IndexMap Class
+ **************************************************************
+ ***** Flat map from global indices (rows or columns) to local
+ ***** indices, used in place of std::map when condensing
+ ***** off-process columns during setup.  Keys are stored in an
+ ***** open-addressing hash table (linear probing) of at least
+ ***** twice the number of keys, so lookups touch one or two
+ ***** contiguous entries and building the map performs a single
+ ***** allocation.
+ *****
+ ***** Attributes
+ ***** -------------
+ ***** keys : aligned_vector<int>
+ *****    Global index in each slot, or -1 if the slot is empty
+ ***** vals : aligned_vector<int>
+ *****    Local index in each slot
+ *****
+ ***** Methods
+ ***** -------
+ ***** build(globals)
+ *****    Maps globals[i] to i, for distinct nonnegative globals
+ *****    (in any order)
+ ***** find(global)
+ *****    Returns local index of global, or -1 if not in map
+ **************************************************************/
+namespace raptor
+{
+    // Sorts vec and removes duplicate entries
+    inline void sort_unique(aligned_vector<int>& vec)
+    {
+        std::sort(vec.begin(), vec.end());
+        vec.erase(std::unique(vec.begin(), vec.end()), vec.end());
+    }
+
+    class IndexMap
+    {
+    public:
+        IndexMap()
+        {
+            shift = 31;
+            mask = 0;
+        }
+
+        IndexMap(const aligned_vector<int>& globals)
+        {
+            build(globals);
+        }
+
+        void build(const aligned_vector<int>& globals)
+        {
+            int n = globals.size();
+            int size = 2;
+            shift = 31;
+            while (size < 2*n)
+            {
+                size <<= 1;
+                shift--;
+            }
+            mask = size - 1;
+
+            keys.assign(size, -1);
+            vals.resize(size);
+            for (int i = 0; i < n; i++)
+            {
+                int slot = hash(globals[i]);
+                while (keys[slot] != -1)
+                {
+                    slot = (slot + 1) & mask;
+                }
+                keys[slot] = globals[i];
+                vals[slot] = i;
+            }
+        }
+
+        int find(int global) const
+        {
+            if (keys.empty()) return -1;
+
+            int slot = hash(global);
+            while (keys[slot] != -1)
+            {
+                if (keys[slot] == global)
+                {
+                    return vals[slot];
+                }
+                slot = (slot + 1) & mask;
+            }
+            return -1;
+        }
+
+        int operator[](int global) const
+        {
+            return find(global);
+        }
+
+        aligned_vector<int> keys;
+        aligned_vector<int> vals;
+
+    private:
+        // Fibonacci hashing : top bits of global * 2^32/phi
+        int hash(int global) const
+        {
+            return (int) ((((uint32_t) global) * 2654435769u) >> shift) & mask;
+        }
+
+        int shift;
+        int mask;
+    };
+}
+
+#endif
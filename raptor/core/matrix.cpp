@@ -338,7 +338,10 @@ void CSR_to_CSR(const CSRMatrix* A, CSRMatrix* B, aligned_vector<T>& A_vals,
 
     B->idx1.resize(A->n_rows + 1);
     B->idx2.resize(A->nnz);
-    B_vals.resize(A->nnz);
+    if (A->data_size()) // Checking that matrix has values (not S)
+    {
+        B_vals.resize(A->nnz);
+    }
 
     B->idx1[0] = 0;
     for (int i = 0; i < A->n_rows; i++)
@@ -349,7 +352,13 @@ void CSR_to_CSR(const CSRMatrix* A, CSRMatrix* B, aligned_vector<T>& A_vals,
         for (int j = row_start; j < row_end; j++)
         {
             B->idx2[j] = A->idx2[j];
-            B_vals[j] = B->copy_val(A_vals[j]);
+        }
+        if (A->data_size())
+        {
+            for (int j = row_start; j < row_end; j++)
+            {
+                B_vals[j] = B->copy_val(A_vals[j]);
+            }
         }
     }
 
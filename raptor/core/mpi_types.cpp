@@ -328,4 +328,17 @@ int RAPtor_MPI_Comm_dup(MPI_Comm comm, MPI_Comm* new_comm)
     if (profile) new_comm_t += RAPtor_MPI_Wtime();
     return val;
 }
-
+int RAPtor_MPI_Type_contiguous(int count, RAPtor_MPI_Datatype oldtype,
+        RAPtor_MPI_Datatype* newtype)
+{
+    return MPI_Type_contiguous(count, oldtype, newtype);
+}
+int RAPtor_MPI_Type_commit(RAPtor_MPI_Datatype* datatype)
+{
+    return MPI_Type_commit(datatype);
+}
+int RAPtor_MPI_Op_create(RAPtor_MPI_User_function* user_fn, int commute,
+        RAPtor_MPI_Op* op)
+{
+    return MPI_Op_create(user_fn, commute, op);
+}
@@ -30,12 +30,14 @@ extern void average_profile(int n_iter);
 #define RAPtor_MPI_Request           MPI_Request
 #define RAPtor_MPI_Status            MPI_Status
 #define RAPtor_MPI_Op                MPI_Op
+#define RAPtor_MPI_User_function     MPI_User_function
 
 #define RAPtor_MPI_INT               MPI_INT
 #define RAPtor_MPI_DOUBLE            MPI_DOUBLE
 #define RAPtor_MPI_DOUBLE_INT        MPI_DOUBLE_INT
 #define RAPtor_MPI_LONG              MPI_LONG
 #define RAPtor_MPI_PACKED            MPI_PACKED
+#define RAPtor_MPI_BYTE              MPI_BYTE
 
 #define RAPtor_MPI_STATUS_IGNORE     MPI_STATUS_IGNORE
 #define RAPtor_MPI_STATUSES_IGNORE   MPI_STATUSES_IGNORE
@@ -130,4 +132,11 @@ extern int RAPtor_MPI_Group_incl(RAPtor_MPI_Group group, int n, const int ranks[
 extern int RAPtor_MPI_Group_free(RAPtor_MPI_Group* group);
 extern int RAPtor_MPI_Comm_dup(MPI_Comm comm, MPI_Comm* new_comm);
 
+// User Defined Types and Operations
+extern int RAPtor_MPI_Type_contiguous(int count, RAPtor_MPI_Datatype oldtype,
+        RAPtor_MPI_Datatype* newtype);
+extern int RAPtor_MPI_Type_commit(RAPtor_MPI_Datatype* datatype);
+extern int RAPtor_MPI_Op_create(RAPtor_MPI_User_function* user_fn, int commute,
+        RAPtor_MPI_Op* op);
+
 #endif
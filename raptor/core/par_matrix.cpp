@@ -80,31 +80,16 @@ void ParMatrix::condense_off_proc()
         return;
     }
 
-    int prev_col = -1;
-
-    std::map<int, int> orig_to_new;
-
     std::copy(off_proc->idx2.begin(), off_proc->idx2.end(),
             std::back_inserter(off_proc_column_map));
-    std::sort(off_proc_column_map.begin(), off_proc_column_map.end());
-
-    off_proc_num_cols = 0;
-    for (aligned_vector<int>::iterator it = off_proc_column_map.begin(); 
-            it != off_proc_column_map.end(); ++it)
-    {
-        if (*it != prev_col)
-        {
-            orig_to_new[*it] = off_proc_num_cols;
-            off_proc_column_map[off_proc_num_cols++] = *it;
-            prev_col = *it;
-        }
-    }
-    off_proc_column_map.resize(off_proc_num_cols);
+    sort_unique(off_proc_column_map);
+    off_proc_num_cols = off_proc_column_map.size();
 
+    IndexMap orig_to_new(off_proc_column_map);
     for (aligned_vector<int>::iterator it = off_proc->idx2.begin();
             it != off_proc->idx2.end(); ++it)
     {
-        *it = orig_to_new[*it];
+        *it = orig_to_new.find(*it);
     }
 }
 
@@ -114,8 +99,8 @@ void ParMatrix::finalize(bool create_comm)
     off_proc->sort();
 
     int rank, num_procs;
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(partition->topology->comm, &num_procs);
+    RAPtor_MPI_Comm_rank(partition->topology->comm, &rank);
 
     // Assume nonzeros in each on_proc column
     if (on_proc_num_cols > on_proc_column_map.size())
@@ -198,7 +183,8 @@ void bsr_to_csr_copy_helper(ParBSRMatrix* A, ParCSRMatrix* B)
     B->partition = new Partition(B->global_num_rows, B->global_num_cols,
                         B->on_proc->n_rows, B->on_proc->n_cols,
                         A->partition->first_local_row * A->on_proc->b_rows,
-                        A->partition->first_local_col * A->on_proc->b_cols);
+                        A->partition->first_local_col * A->on_proc->b_cols,
+                        A->partition->topology);
     B->local_num_rows = B->partition->local_num_rows;
 
     // Updated column and row maps - 
@@ -976,6 +962,7 @@ void ParMatrix::init_tap_communicators(RAPtor_MPI_Comm comm)
      * Initialize 
      * *******************************/
     // Get RAPtor_MPI Information
+    if (comm == RAPtor_MPI_COMM_NULL) comm = partition->topology->comm;
     int rank, num_procs;
     RAPtor_MPI_Comm_rank(comm, &rank);
     RAPtor_MPI_Comm_size(comm, &num_procs);
@@ -10,6 +10,7 @@
 #include "matrix.hpp"
 #include "par_vector.hpp"
 #include "comm_pkg.hpp"
+#include "index_map.hpp"
 #include "mpi_types.hpp"
 #include "partition.hpp"
 
@@ -257,7 +258,7 @@ namespace raptor
     ParMatrix* add(ParCSRMatrix* A);
     ParMatrix* subtract(ParCSRMatrix* A);
 
-    void init_tap_communicators(RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD);
+    void init_tap_communicators(RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_NULL);
     void update_tap_comm(ParMatrix* old, const aligned_vector<int>& old_to_new)
     {
         tap_comm = new TAPComm((TAPComm*) old->tap_comm, old_to_new, NULL);
@@ -574,8 +575,14 @@ namespace raptor
     void copy_helper(ParCSCMatrix* A);
     void copy_helper(ParCOOMatrix* A);
 
+    // Returns the pattern (without values) of the strong entries of A
     ParCSRMatrix* strength(strength_t strength_type, double theta = 0.0, 
             bool tap_amg = false, int num_variables = 1, int* variables = NULL);
+    // Flags the strong off-diagonal entries of on_proc and off_proc (one
+    // per nonzero, in the sorted, diagonal-first order of A)
+    void strength_mask(strength_t strength_type, aligned_vector<char>& on_strong,
+            aligned_vector<char>& off_strong, double theta = 0.0, 
+            bool tap_amg = false, int num_variables = 1, int* variables = NULL);
     ParCSRMatrix* aggregate();
     ParCSRMatrix* fit_candidates(double* B, double* R, int num_candidates, 
             double tol = 1e-10);
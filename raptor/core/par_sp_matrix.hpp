@@ -0,0 +1,91 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#ifndef RAPTOR_CORE_PARSPMATRIX_HPP
+#define RAPTOR_CORE_PARSPMATRIX_HPP
+
+#include "types.hpp"
+#include "par_matrix.hpp"
+#include "par_vector.hpp"
+
+/**************************************************************
+ *****   ParSPMatrix Class
+ **************************************************************
+ ***** Single precision copy of the values of a ParCSRMatrix.
+ ***** The sparsity pattern and communication packages of the
+ ***** original matrix are shared, and only the values are
+ ***** stored as float, halving the memory traffic of values in
+ ***** the products below.  Vectors (and the off-process values
+ ***** communicated during each product) remain double, and
+ ***** each product accumulates in double.
+ *****
+ ***** The values are copied in setup, so setup must be called
+ ***** again if the values of A change.
+ *****
+ ***** Attributes
+ ***** -------------
+ ***** A : ParCSRMatrix*
+ *****    Matrix holding pattern and communication (not owned)
+ ***** on_vals : aligned_vector<float>
+ *****    Values of A->on_proc
+ ***** off_vals : aligned_vector<float>
+ *****    Values of A->off_proc
+ *****
+ ***** Methods
+ ***** -------
+ ***** setup(ParCSRMatrix* A)
+ *****    Copies the values of A to single precision
+ ***** mult(x, b, tap)
+ *****    b = A*x
+ ***** mult_append(x, b, tap)
+ *****    b += A*x
+ ***** mult_T(x, b, tap)
+ *****    b = A^T*x
+ ***** residual(x, b, r, tap)
+ *****    r = b - A*x
+ **************************************************************/
+namespace raptor
+{
+    class ParSPMatrix
+    {
+    public:
+        ParSPMatrix()
+        {
+            A = NULL;
+        }
+
+        ParSPMatrix(ParCSRMatrix* _A)
+        {
+            setup(_A);
+        }
+
+        void setup(ParCSRMatrix* _A)
+        {
+            A = _A;
+
+            on_vals.resize(A->on_proc->vals.size());
+            for (int i = 0; i < (int) on_vals.size(); i++)
+            {
+                on_vals[i] = (float) A->on_proc->vals[i];
+            }
+
+            off_vals.resize(A->off_proc->vals.size());
+            for (int i = 0; i < (int) off_vals.size(); i++)
+            {
+                off_vals[i] = (float) A->off_proc->vals[i];
+            }
+        }
+
+        void mult(ParVector& x, ParVector& b, bool tap = false);
+        void mult_append(ParVector& x, ParVector& b, bool tap = false);
+        void mult_T(ParVector& x, ParVector& b, bool tap = false);
+        void residual(ParVector& x, ParVector& b, ParVector& r, bool tap = false);
+
+        CommPkg* get_comm(bool tap);
+
+        ParCSRMatrix* A;
+        aligned_vector<float> on_vals;
+        aligned_vector<float> off_vals;
+    };
+}
+
+#endif
@@ -1,6 +1,7 @@
 // Copyright (c) 2015-2017, RAPtor Developer Team
 // License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
 #include "par_vector.hpp"
+#include "repro_sum.hpp"
 
 using namespace raptor;
 
@@ -26,6 +27,153 @@ void ParVector::axpy(ParVector& x, data_t alpha)
     }
 }
 
+/**************************************************************
+*****   Vector AXPBY
+**************************************************************
+***** Sets the local vector to alpha*x + beta*values
+*****
+***** Parameters
+***** -------------
+***** x : ParVector&
+*****    Vector to be summed with
+***** alpha : data_t
+*****    Constant value to multiply each element of x by
+***** beta : data_t
+*****    Constant value to multiply each element of vector by
+**************************************************************/
+void ParVector::axpby(ParVector& x, data_t alpha, data_t beta)
+{
+    if (local_n)
+    {
+        local.axpby(x.local, alpha, beta);
+    }
+}
+
+/**************************************************************
+*****   Vector WAXPBY
+**************************************************************
+***** Sets the local vector to alpha*x + beta*y
+*****
+***** Parameters
+***** -------------
+***** x : ParVector&
+*****    First vector to be summed
+***** y : ParVector&
+*****    Second vector to be summed
+***** alpha : data_t
+*****    Constant value to multiply each element of x by
+***** beta : data_t
+*****    Constant value to multiply each element of y by
+**************************************************************/
+void ParVector::waxpby(ParVector& x, ParVector& y, data_t alpha, data_t beta)
+{
+    if (local_n)
+    {
+        local.waxpby(x.local, y.local, alpha, beta);
+    }
+}
+
+/**************************************************************
+*****   Vector AXPY Dot
+**************************************************************
+***** Performs axpy, and returns the global inner product of 
+***** the updated vector with z
+*****
+***** Parameters
+***** -------------
+***** x : ParVector&
+*****    Vector to be summed with
+***** alpha : data_t
+*****    Constant value to multiply each element of x by
+***** z : ParVector&
+*****    Vector to take inner product with
+**************************************************************/
+data_t ParVector::axpy_dot(ParVector& x, data_t alpha, ParVector& z, double* comm_t)
+{
+    data_t inner_prod = 0.0;
+
+    if (reproducible_reductions)
+    {
+        ReproSum sum;
+        axpy(x, alpha);
+        for (int i = 0; i < local_n; i++)
+        {
+            sum.add(local.values[i] * z.local.values[i]);
+        }
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+        repro_allreduce(&sum, &inner_prod, 1, comm);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+        return inner_prod;
+    }
+
+    if (local_n)
+    {
+        inner_prod = local.axpy_dot(x.local, alpha, z.local);
+    }
+
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &inner_prod, 1, RAPtor_MPI_DATA_T, RAPtor_MPI_SUM, comm);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+
+    return inner_prod;
+}
+
+/**************************************************************
+*****   Vector Multi Dot
+**************************************************************
+***** Calculates the global inner products of the vector with
+***** each of y[0], ..., y[n-1], in a single pass over the 
+***** local vector and a single allreduce
+*****
+***** Parameters
+***** -------------
+***** n : int
+*****    Number of inner products
+***** y : ParVector**
+*****    Vectors to take inner products with
+***** result : data_t*
+*****    Array of size n, returns inner products
+**************************************************************/
+void ParVector::multi_dot(int n, ParVector** y, data_t* result, double* comm_t)
+{
+    data_t val;
+
+    if (reproducible_reductions)
+    {
+        std::vector<ReproSum> sums(n);
+        for (int i = 0; i < local_n; i++)
+        {
+            val = local.values[i];
+            for (int j = 0; j < n; j++)
+            {
+                sums[j].add(val * y[j]->local.values[i]);
+            }
+        }
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+        repro_allreduce(sums.data(), result, n, comm);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+        return;
+    }
+
+    for (int j = 0; j < n; j++)
+    {
+        result[j] = 0.0;
+    }
+
+    for (int i = 0; i < local_n; i++)
+    {
+        val = local.values[i];
+        for (int j = 0; j < n; j++)
+        {
+            result[j] += val * y[j]->local.values[i];
+        }
+    }
+
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, result, n, RAPtor_MPI_DATA_T, RAPtor_MPI_SUM, comm);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+}
+
 /**************************************************************
 *****   Vector Scale
 **************************************************************
@@ -88,12 +236,27 @@ void ParVector::set_rand_values()
 data_t ParVector::norm(index_t p)
 {
     data_t result = 0.0;
+
+    if (reproducible_reductions)
+    {
+        ReproSum sum;
+        double val;
+        for (int i = 0; i < local_n; i++)
+        {
+            val = local.values[i];
+            if (fabs(val) > zero_tol)
+                sum.add(pow(val, p));
+        }
+        repro_allreduce(&sum, &result, 1, comm);
+        return pow(result, 1./p);
+    }
+
     if (local_n)
     {
         result = local.norm(p);
         result = pow(result, p); // undoing root of p from local operation
     }
-    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &result, 1, RAPtor_MPI_DATA_T, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &result, 1, RAPtor_MPI_DATA_T, RAPtor_MPI_SUM, comm);
     return pow(result, 1./p);
 }
 
@@ -105,17 +268,28 @@ data_t ParVector::inner_product(ParVector& x)
     if (local_n != x.local_n)
     {
         int rank;
-        RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+        RAPtor_MPI_Comm_rank(comm, &rank);
         printf("Error.  Cannot perform inner product.  Dimensions do not match.\n");
         exit(-1);
     }
 
+    if (reproducible_reductions)
+    {
+        ReproSum sum;
+        for (int i = 0; i < local_n; i++)
+        {
+            sum.add(local.values[i] * x.local.values[i]);
+        }
+        repro_allreduce(&sum, &inner_prod, 1, comm);
+        return inner_prod;
+    }
+
     if (local_n)
     {
         inner_prod = local.inner_product(x.local);
     }
 
-    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &inner_prod, 1, RAPtor_MPI_DATA_T, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &inner_prod, 1, RAPtor_MPI_DATA_T, RAPtor_MPI_SUM, comm);
     
     return inner_prod;
 }
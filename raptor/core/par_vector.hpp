@@ -25,6 +25,9 @@
  *****    Number of entries in the global vector
  ***** local_n : index_t
  *****    Dimension of the local portion of the vector
+ ***** comm : RAPtor_MPI_Comm
+ *****    Communicator over which the vector is distributed, used
+ *****    for all global reductions (default RAPtor_MPI_COMM_WORLD)
  ***** 
  ***** Methods
  ***** -------
@@ -34,10 +37,22 @@
  *****    Sets each element of the local vector to a random value
  ***** axpy(Vector& y, data_t alpha)
  *****    Performs axpy on local portion of vector
+ ***** axpby(ParVector& y, data_t alpha, data_t beta)
+ *****    Sets local vector to alpha*y + beta*vector
+ ***** waxpby(ParVector& x, ParVector& y, data_t alpha, data_t beta)
+ *****    Sets local vector to alpha*x + beta*y
+ ***** axpy_dot(ParVector& y, data_t alpha, ParVector& z)
+ *****    Performs axpy and returns global inner product with z
+ ***** multi_dot(int n, ParVector** y, data_t* result)
+ *****    Calculates n global inner products with a single reduction
  ***** scale(data_t alpha)
  *****    Multiplies entries of the local vector by a constant
  ***** norm(index_t p)
  *****    Calculates the p-norm of the global vector
+ *****
+ ***** If reproducible_reductions (core/repro_sum.hpp) is set, 
+ ***** global reductions sum exactly with ReproSum, so results do
+ ***** not depend on the number of processes.
  **************************************************************/
 namespace raptor
 {
@@ -56,10 +71,13 @@ namespace raptor
         *****    Number of entries in global vector
         ***** lcl_n : index_t
         *****    Number of entries of global vector stored locally
+        ***** _comm : RAPtor_MPI_Comm (optional)
+        *****    Communicator over which the vector is distributed
         **************************************************************/
-        ParVector(index_t glbl_n, int lcl_n)
+        ParVector(index_t glbl_n, int lcl_n,
+                RAPtor_MPI_Comm _comm = RAPtor_MPI_COMM_WORLD)
         {
-            resize(glbl_n, lcl_n);
+            resize(glbl_n, lcl_n, _comm);
         }
 
         ParVector(const ParVector& x)
@@ -75,6 +93,7 @@ namespace raptor
         ParVector()
         {
             local_n = 0;
+            comm = RAPtor_MPI_COMM_WORLD;
         }
 
         /**************************************************************
@@ -93,10 +112,17 @@ namespace raptor
             local.resize(local_n);
         }
 
+        void resize(index_t glbl_n, int lcl_n, RAPtor_MPI_Comm _comm)
+        {
+            comm = _comm;
+            resize(glbl_n, lcl_n);
+        }
+
         void copy(const ParVector& x)
         {
             global_n = x.global_n;
             local_n = x.local_n;
+            comm = x.comm;
             local.copy(x.local);
         }
 
@@ -134,6 +160,82 @@ namespace raptor
         **************************************************************/
         void axpy(ParVector& y, data_t alpha);
 
+        /**************************************************************
+        *****   Vector AXPBY
+        **************************************************************
+        ***** Sets the local vector to alpha*y + beta*values
+        *****
+        ***** Parameters
+        ***** -------------
+        ***** y : ParVector&
+        *****    ParVector to be summed with
+        ***** alpha : data_t
+        *****    Constant value to multiply each element of y by
+        ***** beta : data_t
+        *****    Constant value to multiply each element of vector by
+        **************************************************************/
+        void axpby(ParVector& y, data_t alpha, data_t beta);
+
+        /**************************************************************
+        *****   Vector WAXPBY
+        **************************************************************
+        ***** Sets the local vector to alpha*x + beta*y
+        *****
+        ***** Parameters
+        ***** -------------
+        ***** x : ParVector&
+        *****    First ParVector to be summed
+        ***** y : ParVector&
+        *****    Second ParVector to be summed
+        ***** alpha : data_t
+        *****    Constant value to multiply each element of x by
+        ***** beta : data_t
+        *****    Constant value to multiply each element of y by
+        **************************************************************/
+        void waxpby(ParVector& x, ParVector& y, data_t alpha, data_t beta);
+
+        /**************************************************************
+        *****   Vector AXPY Dot
+        **************************************************************
+        ***** Performs axpy, and returns the global inner product of
+        ***** the updated vector with z.  The local vector is only
+        ***** traversed once.
+        *****
+        ***** Parameters
+        ***** -------------
+        ***** y : ParVector&
+        *****    ParVector to be summed with
+        ***** alpha : data_t
+        *****    Constant value to multiply each element of y by
+        ***** z : ParVector&
+        *****    ParVector to take inner product with (may be this)
+        ***** comm_t : double* (optional)
+        *****    Accumulates the time spent in the reduction
+        **************************************************************/
+        data_t axpy_dot(ParVector& y, data_t alpha, ParVector& z,
+                double* comm_t = NULL);
+
+        /**************************************************************
+        *****   Vector Multi Dot
+        **************************************************************
+        ***** Calculates the global inner products of this vector with
+        ***** each of y[0], ..., y[n-1], reduced with a single 
+        ***** allreduce.
+        *****
+        ***** Parameters
+        ***** -------------
+        ***** n : int
+        *****    Number of inner products
+        ***** y : ParVector**
+        *****    ParVectors to take inner products with
+        ***** result : data_t*
+        *****    Array of size n, returns inner products
+        ***** comm_t : double* (optional)
+        *****    Accumulates the time spent in the reduction
+        **************************************************************/
+        void multi_dot(int n, ParVector** y, data_t* result,
+                double* comm_t = NULL);
+
         /**************************************************************
         *****   Vector Scale
         **************************************************************
@@ -173,6 +275,7 @@ namespace raptor
         Vector local;
         int global_n;
         int local_n;
+        RAPtor_MPI_Comm comm;
     };
 
 }
@@ -43,8 +43,18 @@ namespace raptor
         int avg_num;
         int extra;
 
-        RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-        RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+        if (_topology == NULL)
+        {
+            topology = new Topology();
+        }
+        else
+        {
+            topology = _topology;
+            topology->num_shared++;
+        }
+
+        RAPtor_MPI_Comm_rank(topology->comm, &rank);
+        RAPtor_MPI_Comm_size(topology->comm, &num_procs);
 
         global_num_rows = _global_num_rows;
         global_num_cols = _global_num_cols;
@@ -97,6 +107,14 @@ namespace raptor
         num_shared = 0;
 
         create_assumed_partition();
+    }
+
+    Partition(index_t _global_num_rows, index_t _global_num_cols,
+            index_t _brows, index_t _bcols, Topology* _topology = NULL)
+    {
+        int rank, num_procs;
+        int avg_num_blocks, global_num_row_blocks, global_num_col_blocks;
+        int extra;
 
         if (_topology == NULL)
         {
@@ -107,17 +125,9 @@ namespace raptor
             topology = _topology;
             topology->num_shared++;
         }
-    }
 
-    Partition(index_t _global_num_rows, index_t _global_num_cols,
-            index_t _brows, index_t _bcols, Topology* _topology = NULL)
-    {
-        int rank, num_procs;
-        int avg_num_blocks, global_num_row_blocks, global_num_col_blocks;
-        int extra;
-
-        RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-        RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+        RAPtor_MPI_Comm_rank(topology->comm, &rank);
+        RAPtor_MPI_Comm_size(topology->comm, &num_procs);
 
         global_num_rows = _global_num_rows;
         global_num_cols = _global_num_cols;
@@ -173,7 +183,13 @@ namespace raptor
         num_shared = 0;
 
         create_assumed_partition();
+    }
 
+    Partition(index_t _global_num_rows, index_t _global_num_cols,
+            int _local_num_rows, int _local_num_cols,
+            index_t _first_local_row, index_t _first_local_col,
+            Topology* _topology = NULL)
+    {
         if (_topology == NULL)
         {
             topology = new Topology();
@@ -183,13 +199,7 @@ namespace raptor
             topology = _topology;
             topology->num_shared++;
         }
-    }
 
-    Partition(index_t _global_num_rows, index_t _global_num_cols,
-            int _local_num_rows, int _local_num_cols,
-            index_t _first_local_row, index_t _first_local_col,
-            Topology* _topology = NULL)
-    {
         global_num_rows = _global_num_rows;
         global_num_cols = _global_num_cols;
         local_num_rows = _local_num_rows;
@@ -202,16 +212,6 @@ namespace raptor
         num_shared = 0;
 
         create_assumed_partition();
-
-        if (_topology == NULL)
-        {
-            topology = new Topology();
-        }
-        else
-        {
-            topology = _topology;
-            topology->num_shared++;
-        }
     }
 
     Partition(Topology* _topology = NULL)
@@ -251,15 +251,15 @@ namespace raptor
 
         num_shared = 0;
 
+        topology = A->topology;
+        topology->num_shared++;
+
         assumed_num_cols = B->assumed_num_cols;
         first_cols.resize(B->first_cols.size());
         std::copy(B->first_cols.begin(), B->first_cols.end(),
                 first_cols.begin());
 
         create_assumed_partition();
-
-        topology = A->topology;
-        topology->num_shared++;
     }
 
     Partition* transpose()
@@ -285,15 +285,15 @@ namespace raptor
     {
         // Get RAPtor_MPI Information
         int rank, num_procs;
-        RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-        RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+        RAPtor_MPI_Comm_rank(topology->comm, &rank);
+        RAPtor_MPI_Comm_size(topology->comm, &num_procs);
         
         assumed_num_cols = global_num_cols / num_procs;
         if (global_num_cols % num_procs) assumed_num_cols++;
 
         first_cols.resize(num_procs+1);
         RAPtor_MPI_Allgather(&(first_local_col), 1, RAPtor_MPI_INT, first_cols.data(), 1, RAPtor_MPI_INT,
-                        RAPtor_MPI_COMM_WORLD);
+                        topology->comm);
         first_cols[num_procs] = global_num_cols;
     }
 
@@ -301,8 +301,8 @@ namespace raptor
             aligned_vector<int>& off_proc_col_to_proc) 
     {
         int rank, num_procs;
-        RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-        RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+        RAPtor_MPI_Comm_rank(topology->comm, &rank);
+        RAPtor_MPI_Comm_size(topology->comm, &num_procs);
 
         int global_col, assumed_proc;
         int ctr = 0;
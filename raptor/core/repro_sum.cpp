@@ -0,0 +1,69 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "repro_sum.hpp"
+
+namespace raptor
+{
+    bool reproducible_reductions = false;
+
+    void repro_sum_op(void* in, void* inout, int* len, RAPtor_MPI_Datatype* type)
+    {
+        ReproSum* in_sums = (ReproSum*) in;
+        ReproSum* inout_sums = (ReproSum*) inout;
+        for (int i = 0; i < *len; i++)
+        {
+            inout_sums[i].add(in_sums[i]);
+        }
+    }
+
+    // The datatype and operation are created on first use
+    void repro_init(RAPtor_MPI_Datatype* type, RAPtor_MPI_Op* op)
+    {
+        static bool initialized = false;
+        static RAPtor_MPI_Datatype repro_type;
+        static RAPtor_MPI_Op repro_op;
+
+        if (!initialized)
+        {
+            RAPtor_MPI_Type_contiguous(sizeof(ReproSum), RAPtor_MPI_BYTE, &repro_type);
+            RAPtor_MPI_Type_commit(&repro_type);
+            RAPtor_MPI_Op_create(&repro_sum_op, 1, &repro_op);
+            initialized = true;
+        }
+
+        *type = repro_type;
+        *op = repro_op;
+    }
+
+    void repro_allreduce(ReproSum* sums, double* result, int n,
+            RAPtor_MPI_Comm comm)
+    {
+        RAPtor_MPI_Datatype type;
+        RAPtor_MPI_Op op;
+        repro_init(&type, &op);
+
+        for (int i = 0; i < n; i++)
+        {
+            sums[i].normalize();
+        }
+        RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, sums, n, type, op, comm);
+        for (int i = 0; i < n; i++)
+        {
+            result[i] = sums[i].value();
+        }
+    }
+
+    void repro_iallreduce(ReproSum* sums, int n, RAPtor_MPI_Comm comm,
+            RAPtor_MPI_Request* request)
+    {
+        RAPtor_MPI_Datatype type;
+        RAPtor_MPI_Op op;
+        repro_init(&type, &op);
+
+        for (int i = 0; i < n; i++)
+        {
+            sums[i].normalize();
+        }
+        RAPtor_MPI_Iallreduce(RAPtor_MPI_IN_PLACE, sums, n, type, op, comm, request);
+    }
+}
@@ -0,0 +1,182 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#ifndef RAPTOR_CORE_REPRO_SUM_HPP
+#define RAPTOR_CORE_REPRO_SUM_HPP
+
+#include <cmath>
+#include <stdint.h>
+
+#include "types.hpp"
+#include "mpi_types.hpp"
+
+// 32-bit limbs covering every bit position of a double
+// (2^-1074 to 2^1024), plus headroom for carries
+#define REPRO_NUM_LIMBS 70
+#define REPRO_OFFSET 1127
+#define REPRO_MAX_ADDS (1 << 20)
+
+/**************************************************************
+ *****   ReproSum Class
+ **************************************************************
+ ***** Exact (fixed point) accumulator for sums of doubles.  Each
+ ***** value is split into 32-bit limbs stored in 64-bit
+ ***** integers, so additions are exact, and the final sum is
+ ***** independent of the order in which values are added and of
+ ***** how they are distributed across processes.  The result is
+ ***** rounded to double only in value().
+ *****
+ ***** Accumulators are combined across processes with
+ ***** repro_allreduce, which uses a single commutative MPI_Op.
+ *****
+ ***** Attributes
+ ***** -------------
+ ***** limbs : int64_t[REPRO_NUM_LIMBS]
+ *****    Limb i holds bits 32*i to 32*i+31 of the sum, scaled by
+ *****    2^REPRO_OFFSET.  Carries are propagated in normalize().
+ ***** special : double
+ *****    Sum of non-finite values (inf or nan), added normally
+ ***** num_adds : int
+ *****    Additions since the last normalize
+ **************************************************************/
+namespace raptor
+{
+    // If true, ParVector reductions and the inner products of the
+    // Krylov methods use ReproSum (default false)
+    extern bool reproducible_reductions;
+
+    class ReproSum
+    {
+    public:
+        ReproSum()
+        {
+            clear();
+        }
+
+        void clear()
+        {
+            for (int i = 0; i < REPRO_NUM_LIMBS; i++)
+            {
+                limbs[i] = 0;
+            }
+            special = 0.0;
+            num_adds = 0;
+        }
+
+        void add(double val)
+        {
+            if (val == 0.0) return;
+            if (!std::isfinite(val))
+            {
+                special += val;
+                return;
+            }
+
+            // val = m * 2^(e-53), with m a 53-bit integer
+            int e;
+            double f = frexp(val, &e);
+            int64_t m = (int64_t) ldexp(f, 53);
+            int pos = e + REPRO_OFFSET - 53;
+            int idx = pos >> 5;
+            int shift = pos & 31;
+
+            uint64_t a = (uint64_t) (m < 0 ? -m : m);
+            int64_t lo = (int64_t) ((a << shift) & 0xffffffffULL);
+            uint64_t rest = shift ? (a >> (32 - shift)) : (a >> 32);
+            int64_t mid = (int64_t) (rest & 0xffffffffULL);
+            int64_t hi = (int64_t) (rest >> 32);
+
+            if (m < 0)
+            {
+                limbs[idx] -= lo;
+                limbs[idx+1] -= mid;
+                limbs[idx+2] -= hi;
+            }
+            else
+            {
+                limbs[idx] += lo;
+                limbs[idx+1] += mid;
+                limbs[idx+2] += hi;
+            }
+
+            if (++num_adds == REPRO_MAX_ADDS) normalize();
+        }
+
+        void add(const ReproSum& other)
+        {
+            for (int i = 0; i < REPRO_NUM_LIMBS; i++)
+            {
+                limbs[i] += other.limbs[i];
+            }
+            special += other.special;
+            normalize();
+        }
+
+        // Propagate carries, so limbs 0 to REPRO_NUM_LIMBS-2 are
+        // in [0, 2^32) and the last limb holds the sign
+        void normalize()
+        {
+            int64_t low, carry;
+            for (int i = 0; i < REPRO_NUM_LIMBS - 1; i++)
+            {
+                low = limbs[i] & 0xffffffffLL;
+                carry = (limbs[i] - low) / 4294967296LL;
+                limbs[i] = low;
+                limbs[i+1] += carry;
+            }
+            num_adds = 0;
+        }
+
+        double value()
+        {
+            if (special != 0.0)
+            {
+                return special;
+            }
+
+            normalize();
+
+            // A negative sum is held in two's complement form, so
+            // negate a copy before converting its magnitude
+            ReproSum mag = *this;
+            double sign = 1.0;
+            if (limbs[REPRO_NUM_LIMBS - 1] < 0)
+            {
+                for (int i = 0; i < REPRO_NUM_LIMBS; i++)
+                {
+                    mag.limbs[i] = -limbs[i];
+                }
+                mag.normalize();
+                sign = -1.0;
+            }
+
+            double result = 0.0;
+            for (int i = REPRO_NUM_LIMBS - 1; i >= 0; i--)
+            {
+                if (mag.limbs[i])
+                {
+                    result += ldexp((double) mag.limbs[i], 32*i - REPRO_OFFSET);
+                }
+            }
+            return sign * result;
+        }
+
+        int64_t limbs[REPRO_NUM_LIMBS];
+        double special;
+        int num_adds;
+    };
+
+    /**************************************************************
+     *****   Reproducible Allreduce
+     **************************************************************
+     ***** Sums n accumulators across comm with a single allreduce,
+     ***** returning the rounded sums in result.  The nonblocking
+     ***** version reduces sums in place, and sums[i].value() may
+     ***** be read once the request completes.
+     **************************************************************/
+    void repro_allreduce(ReproSum* sums, double* result, int n,
+            RAPtor_MPI_Comm comm);
+    void repro_iallreduce(ReproSum* sums, int n, RAPtor_MPI_Comm comm,
+            RAPtor_MPI_Request* request);
+}
+
+#endif
@@ -49,8 +49,8 @@ void TAPComm::split_off_proc_cols(const aligned_vector<int>& off_proc_column_map
     int global_col;
     int off_proc_num_cols = off_proc_column_map.size();
 
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+    RAPtor_MPI_Comm_rank(topology->comm, &rank);
+    RAPtor_MPI_Comm_size(topology->comm, &num_procs);
     rank_node = topology->get_node(rank);
 
     // Reserve size in vectors
@@ -356,9 +356,9 @@ void TAPComm::form_global_par_comm(aligned_vector<int>& orig_procs)
 {
     int rank, num_procs;
     int local_rank;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_rank(topology->comm, &rank);
     RAPtor_MPI_Comm_rank(topology->local_comm, &local_rank);
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+    RAPtor_MPI_Comm_size(topology->comm, &num_procs);
 
     int n_sends;
     int proc, node;
@@ -499,7 +499,7 @@ void TAPComm::form_global_par_comm(aligned_vector<int>& orig_procs)
         send_p[proc] = 1;
     }
     RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, send_p.data(), num_procs, RAPtor_MPI_INT,
-            RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+            RAPtor_MPI_SUM, topology->comm);
     int recv_n = send_p[rank];
     sendbuf.resize(recv_n);
     sendbuf_sizes.resize(recv_n);
@@ -509,14 +509,14 @@ void TAPComm::form_global_par_comm(aligned_vector<int>& orig_procs)
     {
         node = global_recv->procs[i];
         proc = topology->get_global_proc(node, local_rank);
-        RAPtor_MPI_Isend(&(node_sizes[node]), 1, RAPtor_MPI_INT, proc, 9876, RAPtor_MPI_COMM_WORLD,
+        RAPtor_MPI_Isend(&(node_sizes[node]), 1, RAPtor_MPI_INT, proc, 9876, topology->comm,
                 &(global_recv->requests[i]));
     }
     for (int i = 0; i < recv_n; i++)
     {
-        RAPtor_MPI_Probe(RAPtor_MPI_ANY_SOURCE, 9876, RAPtor_MPI_COMM_WORLD, &recv_status);
+        RAPtor_MPI_Probe(RAPtor_MPI_ANY_SOURCE, 9876, topology->comm, &recv_status);
         proc = recv_status.RAPtor_MPI_SOURCE;
-        RAPtor_MPI_Recv(&recvbuf, 1, RAPtor_MPI_INT, proc, 9876, RAPtor_MPI_COMM_WORLD, 
+        RAPtor_MPI_Recv(&recvbuf, 1, RAPtor_MPI_INT, proc, 9876, topology->comm, 
                 &recv_status);
         sendbuf[i] = proc;
         sendbuf_sizes[i] = recvbuf;
@@ -580,15 +580,15 @@ void TAPComm::form_global_par_comm(aligned_vector<int>& orig_procs)
     {
         proc = global_par_comm->send_data->procs[i];
         RAPtor_MPI_Isend(&(global_par_comm->send_data->procs[i]), 1, RAPtor_MPI_INT, proc, 6789, 
-                RAPtor_MPI_COMM_WORLD, &(global_par_comm->send_data->requests[i]));
+                topology->comm, &(global_par_comm->send_data->requests[i]));
     }
     // Recv processes from which rank must recv
     for (int i = 0; i < global_recv->num_msgs; i++)
     {
-        RAPtor_MPI_Probe(RAPtor_MPI_ANY_SOURCE, 6789, RAPtor_MPI_COMM_WORLD, &recv_status);
+        RAPtor_MPI_Probe(RAPtor_MPI_ANY_SOURCE, 6789, topology->comm, &recv_status);
         proc = recv_status.RAPtor_MPI_SOURCE;
         node = topology->get_node(proc);
-        RAPtor_MPI_Recv(&recvbuf, 1, RAPtor_MPI_INT, proc, 6789, RAPtor_MPI_COMM_WORLD, &recv_status);
+        RAPtor_MPI_Recv(&recvbuf, 1, RAPtor_MPI_INT, proc, 6789, topology->comm, &recv_status);
         idx = node_to_idx[node];
         global_recv->procs[idx] = proc;
     }
@@ -618,7 +618,7 @@ void TAPComm::form_global_par_comm(aligned_vector<int>& orig_procs)
         start = global_recv->indptr[i];
         end = global_recv->indptr[i+1];
         RAPtor_MPI_Isend(&(send_buffer[2*start]), 2*(end - start),
-                RAPtor_MPI_INT, proc, 5432, RAPtor_MPI_COMM_WORLD,
+                RAPtor_MPI_INT, proc, 5432, topology->comm,
                 &(global_recv->requests[i]));
         
     }
@@ -628,10 +628,10 @@ void TAPComm::form_global_par_comm(aligned_vector<int>& orig_procs)
     for (int i = 0; i < global_par_comm->send_data->num_msgs; i++)
     {
         proc = global_par_comm->send_data->procs[i];
-        RAPtor_MPI_Probe(proc, 5432, RAPtor_MPI_COMM_WORLD, &recv_status);
+        RAPtor_MPI_Probe(proc, 5432, topology->comm, &recv_status);
         RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INT, &count);
         int recvbuf[count];
-        RAPtor_MPI_Recv(recvbuf, count, RAPtor_MPI_INT, proc, 5432, RAPtor_MPI_COMM_WORLD, &recv_status);
+        RAPtor_MPI_Recv(recvbuf, count, RAPtor_MPI_INT, proc, 5432, topology->comm, &recv_status);
         for (int j = 0; j < count; j += 2)
         {
            global_par_comm->send_data->indices.emplace_back(recvbuf[j]);
@@ -667,7 +667,7 @@ void TAPComm::form_local_S_par_comm(aligned_vector<int>& orig_procs)
 {
     int rank;
     int local_rank;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_rank(topology->comm, &rank);
     RAPtor_MPI_Comm_rank(topology->local_comm, &local_rank);
 
     // Find local_col_starts for all procs local to node, and sort
@@ -982,7 +982,7 @@ void TAPComm::form_simple_R_par_comm(aligned_vector<int>& off_node_column_map,
         aligned_vector<int>& off_node_col_to_proc)
 {
     int rank, local_rank;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_rank(topology->comm, &rank);
     RAPtor_MPI_Comm_rank(topology->local_comm, &local_rank);
 
     int proc, local_proc;
@@ -1056,8 +1056,8 @@ void TAPComm::form_simple_global_comm(aligned_vector<int>& off_proc_col_to_proc)
     RAPtor_MPI_Status recv_status;
     RAPtor_MPI_Request barrier_request;
 
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+    RAPtor_MPI_Comm_rank(topology->comm, &rank);
+    RAPtor_MPI_Comm_size(topology->comm, &num_procs);
 
     aligned_vector<int> proc_sizes(num_procs, 0);
     aligned_vector<int> proc_ctr;
@@ -1109,7 +1109,7 @@ void TAPComm::form_simple_global_comm(aligned_vector<int>& off_proc_col_to_proc)
     aligned_vector<int> recv_sizes(num_procs, 0);
     for (int i = 0; i < global_recv->num_msgs; i++)
         recv_sizes[global_recv->procs[i]] = global_recv->indptr[i+1] - global_recv->indptr[i];
-    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, recv_sizes.data(), num_procs, RAPtor_MPI_INT, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, recv_sizes.data(), num_procs, RAPtor_MPI_INT, RAPtor_MPI_SUM, topology->comm);
 
     for (int i = 0; i < global_recv->num_msgs; i++)
     {
@@ -1117,9 +1117,9 @@ void TAPComm::form_simple_global_comm(aligned_vector<int>& off_proc_col_to_proc)
         start = global_recv->indptr[i];
         end = global_recv->indptr[i+1];
         RAPtor_MPI_Isend(&(global_recv->indices[start]), end - start, RAPtor_MPI_INT,
-                proc, 6789, RAPtor_MPI_COMM_WORLD, &(global_recv->requests[i]));
+                proc, 6789, topology->comm, &(global_recv->requests[i]));
     }
-    global_par_comm->send_data->probe(recv_sizes[rank], 6789, RAPtor_MPI_COMM_WORLD);
+    global_par_comm->send_data->probe(recv_sizes[rank], 6789, topology->comm);
     global_par_comm->recv_data->waitall();
 }
 
@@ -0,0 +1,57 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+
+} // end of main() //
+
+TEST(IndexMapTest, TestsInCore)
+{
+    // Unsorted, with duplicates, and strided so keys share low bits
+    aligned_vector<int> globals;
+    for (int i = 0; i < 1000; i++)
+    {
+        globals.emplace_back(((i * 7919) % 1000) * 1024);
+        if (i % 3 == 0) globals.emplace_back(i * 1024);
+    }
+
+    sort_unique(globals);
+    ASSERT_EQ((int) globals.size(), 1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ(globals[i], i * 1024);
+    }
+
+    IndexMap map(globals);
+    for (int i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ(map.find(i * 1024), i);
+        ASSERT_EQ(map[i * 1024], i);
+        ASSERT_EQ(map.find(i * 1024 + 1), -1);
+    }
+    ASSERT_EQ(map.find(1000 * 1024), -1);
+
+    // Unsorted keys map to their position
+    aligned_vector<int> rows = {42, 7, 1000000, 3};
+    map.build(rows);
+    for (int i = 0; i < (int) rows.size(); i++)
+    {
+        ASSERT_EQ(map.find(rows[i]), i);
+    }
+
+    // Empty maps
+    aligned_vector<int> empty;
+    map.build(empty);
+    ASSERT_EQ(map.find(0), -1);
+    IndexMap empty_map;
+    ASSERT_EQ(empty_map.find(5), -1);
+
+} // end of TEST(IndexMapTest, TestsInCore) //
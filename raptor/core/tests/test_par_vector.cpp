@@ -68,3 +68,130 @@ TEST(ParVectorTest, TestsInCore)
     
 } // end of TEST(ParVectorTest, TestsInCore) //
 
+
+TEST(ParVectorFusedTest, TestsInCore)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int global_n = 100;
+    int local_n = global_n / num_procs;
+    int first_n = rank * ( global_n / num_procs);
+    if (global_n % num_procs > rank)
+    {
+        local_n++;
+        first_n += rank;
+    }
+    else
+    {
+        first_n += (global_n % num_procs);
+    }
+
+    ParVector x(global_n, local_n);
+    ParVector y(global_n, local_n);
+    ParVector w(global_n, local_n);
+    ParVector ref(global_n, local_n);
+    for (int i = 0; i < local_n; i++)
+    {
+        x[i] = 1.0 + (first_n + i) % 7;
+        y[i] = 2.0 - (first_n + i) % 5;
+    }
+
+    // axpby : w = 2*x + 3*w
+    w.copy(y);
+    w.axpby(x, 2.0, 3.0);
+    ref.copy(y);
+    ref.scale(3.0);
+    ref.axpy(x, 2.0);
+    for (int i = 0; i < local_n; i++)
+    {
+        ASSERT_NEAR(w[i], ref[i], 1e-14);
+    }
+
+    // waxpby : w = 2*x - y
+    w.waxpby(x, y, 2.0, -1.0);
+    ref.copy(x);
+    ref.scale(2.0);
+    ref.axpy(y, -1.0);
+    for (int i = 0; i < local_n; i++)
+    {
+        ASSERT_NEAR(w[i], ref[i], 1e-14);
+    }
+
+    // axpy_dot : w += 0.5*y, returns (w, x)
+    double dot = w.axpy_dot(y, 0.5, x);
+    ref.axpy(y, 0.5);
+    ASSERT_NEAR(dot, ref.inner_product(x), 1e-10);
+    for (int i = 0; i < local_n; i++)
+    {
+        ASSERT_NEAR(w[i], ref[i], 1e-14);
+    }
+
+    // multi_dot : (x, x), (x, y), (x, w) with one reduction
+    double dots[3];
+    ParVector* vecs[3] = {&x, &y, &w};
+    x.multi_dot(3, vecs, dots);
+    ASSERT_NEAR(dots[0], x.inner_product(x), 1e-10);
+    ASSERT_NEAR(dots[1], x.inner_product(y), 1e-10);
+    ASSERT_NEAR(dots[2], x.inner_product(w), 1e-10);
+
+} // end of TEST(ParVectorFusedTest, TestsInCore) //
+
+TEST(ParVectorReproducibleTest, TestsInCore)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int global_n = 1000;
+    int local_n = global_n / num_procs;
+    int first_n = rank * ( global_n / num_procs);
+    if (global_n % num_procs > rank)
+    {
+        local_n++;
+        first_n += rank;
+    }
+    else
+    {
+        first_n += (global_n % num_procs);
+    }
+
+    // Values of widely varying magnitude, so the floating point
+    // sum depends on the order of additions
+    aligned_vector<double> vals(global_n);
+    for (int i = 0; i < global_n; i++)
+    {
+        srand(i);
+        vals[i] = ldexp(((double)rand()) / RAND_MAX - 0.5, (i * 37) % 120 - 60);
+    }
+
+    ParVector v(global_n, local_n);
+    ParVector w(global_n, local_n);
+    for (int i = 0; i < local_n; i++)
+    {
+        v[i] = vals[first_n + i];
+        w[i] = 1.0;
+    }
+
+    // Exact sums, added in reverse order on every process
+    ReproSum dot_sum, norm_sum;
+    for (int i = global_n - 1; i >= 0; i--)
+    {
+        dot_sum.add(vals[i]);
+        norm_sum.add(vals[i] * vals[i]);
+    }
+
+    reproducible_reductions = true;
+    double dot = v.inner_product(w);
+    double nrm = v.norm(2);
+    double multi[2];
+    ParVector* W[2] = {&w, &v};
+    v.multi_dot(2, W, multi);
+    reproducible_reductions = false;
+
+    ASSERT_EQ(dot, dot_sum.value());
+    ASSERT_EQ(nrm, sqrt(norm_sum.value()));
+    ASSERT_EQ(multi[0], dot);
+    ASSERT_EQ(multi[1], norm_sum.value());
+} // end of TEST(ParVectorReproducibleTest, TestsInCore) //
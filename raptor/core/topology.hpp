@@ -17,12 +17,20 @@
  *****
  ***** Attributes
  ***** -------------
- ***** global_num_indices : index_t
- *****    Number of rows to be partitioned
- ***** first_local_idx : index_t
- *****    First global index of a row in partition local to rank
- ***** local_num_indices : index_t
- *****    Number of rows local to rank's partition
+ ***** PPN : int
+ *****    Number of processes per node
+ ***** rank_ordering : int
+ *****    Mapping of ranks to nodes (0: round robin, 1: SMP style,
+ *****    2: folded round robin)
+ ***** num_nodes : int
+ *****    Number of nodes spanned by comm
+ ***** comm : RAPtor_MPI_Comm
+ *****    Communicator over which the partition is distributed.
+ *****    All ranks are relative to comm (defaults to
+ *****    RAPtor_MPI_COMM_WORLD).  The communicator is not owned
+ *****    by the topology and is not freed.
+ ***** local_comm : RAPtor_MPI_Comm
+ *****    Intra-node communicator (split from comm)
  *****
  ***** Methods
  ***** ---------
@@ -32,11 +40,14 @@ namespace raptor
   class Topology
   {
   public:
-    Topology(int _PPN = 16, int _standard_rank_ordering = 1)
+    Topology(int _PPN = 16, int _standard_rank_ordering = 1,
+            RAPtor_MPI_Comm _comm = RAPtor_MPI_COMM_WORLD)
     {     
+        comm = _comm;
+
         int rank, num_procs;
-        RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-        RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+        RAPtor_MPI_Comm_rank(comm, &rank);
+        RAPtor_MPI_Comm_size(comm, &num_procs);
 
         int rank_node;
 
@@ -65,7 +76,7 @@ namespace raptor
         rank_node = get_node(rank);
 
         // Create intra-node communicator
-        RAPtor_MPI_Comm_split(RAPtor_MPI_COMM_WORLD, rank_node, rank, &local_comm);
+        RAPtor_MPI_Comm_split(comm, rank_node, rank, &local_comm);
         num_shared = 0;
     }
 
@@ -98,7 +109,7 @@ namespace raptor
         else
         { 
             int rank;
-            RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+            RAPtor_MPI_Comm_rank(comm, &rank);
             if (rank == 0)
             {
                 printf("This RAPtor_MPI rank ordering is not supported!\n");
@@ -120,7 +131,7 @@ namespace raptor
         else
         { 
             int rank;
-            RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+            RAPtor_MPI_Comm_rank(comm, &rank);
             if (rank == 0)
             {
                 printf("This RAPtor_MPI rank ordering is not supported!\n");
@@ -153,7 +164,7 @@ namespace raptor
         else
         { 
             int rank;
-            RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+            RAPtor_MPI_Comm_rank(comm, &rank);
             if (rank == 0)
             {
                 printf("This RAPtor_MPI rank ordering is not supported!\n");
@@ -167,6 +178,7 @@ namespace raptor
     int num_shared;
     int num_nodes;
 
+    RAPtor_MPI_Comm comm;
     RAPtor_MPI_Comm local_comm;
   };
 }
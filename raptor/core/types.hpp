@@ -160,8 +160,9 @@ namespace raptor
     enum coarsen_t {RS, CLJP, Falgout, PMIS, HMIS};
     enum interp_t {Direct, ModClassical, Extended};
     enum agg_t {MIS};
-    enum prolong_t {JacobiProlongation};
-    enum relax_t {Jacobi, SOR, SSOR};
+    enum prolong_t {JacobiProlongation, EnergyMinProlongation};
+    enum relax_t {Jacobi, SOR, SSOR, Chebyshev, L1Jacobi, L1SOR, L1SSOR, 
+        MulticolorSSOR};
 
     template<typename T, typename U> 
     U sum_func(const U& a, const T&b)
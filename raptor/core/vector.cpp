@@ -58,6 +58,79 @@ void Vector::axpy(Vector& x, data_t alpha)
     }
 }
 
+/**************************************************************
+*****   Vector AXPBY
+**************************************************************
+***** Sets the vector to alpha*x + beta*values, in a single 
+***** pass
+*****
+***** Parameters
+***** -------------
+***** x : Vector&
+*****    Vector to be summed with
+***** alpha : data_t
+*****    Constant value to multiply each element of x by
+***** beta : data_t
+*****    Constant value to multiply each element of vector by
+**************************************************************/
+void Vector::axpby(Vector& x, data_t alpha, data_t beta)
+{
+    for (index_t i = 0; i < num_values; i++)
+    {
+        values[i] = alpha*x.values[i] + beta*values[i];
+    }
+}
+
+/**************************************************************
+*****   Vector WAXPBY
+**************************************************************
+***** Sets the vector to alpha*x + beta*y
+*****
+***** Parameters
+***** -------------
+***** x : Vector&
+*****    First vector to be summed
+***** y : Vector&
+*****    Second vector to be summed
+***** alpha : data_t
+*****    Constant value to multiply each element of x by
+***** beta : data_t
+*****    Constant value to multiply each element of y by
+**************************************************************/
+void Vector::waxpby(Vector& x, Vector& y, data_t alpha, data_t beta)
+{
+    for (index_t i = 0; i < num_values; i++)
+    {
+        values[i] = alpha*x.values[i] + beta*y.values[i];
+    }
+}
+
+/**************************************************************
+*****   Vector AXPY Dot
+**************************************************************
+***** Performs axpy, and returns the inner product of the 
+***** updated vector with z, in a single pass
+*****
+***** Parameters
+***** -------------
+***** x : Vector&
+*****    Vector to be summed with
+***** alpha : data_t
+*****    Constant value to multiply each element of x by
+***** z : Vector&
+*****    Vector to take inner product with
+**************************************************************/
+data_t Vector::axpy_dot(Vector& x, data_t alpha, Vector& z)
+{
+    data_t result = 0.0;
+    for (index_t i = 0; i < num_values; i++)
+    {
+        values[i] += x.values[i]*alpha;
+        result += values[i] * z.values[i];
+    }
+    return result;
+}
+
 /**************************************************************
 *****   Vector Copy
 **************************************************************
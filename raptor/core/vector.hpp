@@ -26,6 +26,12 @@
 // axpy(Vector& y, data_t alpha)
 //    Multiplies each element by a constant, alpha, and then
 //    adds corresponding values from y
+// axpby(Vector& y, data_t alpha, data_t beta)
+//    Sets vector to alpha*y + beta*vector
+// waxpby(Vector& x, Vector& y, data_t alpha, data_t beta)
+//    Sets vector to alpha*x + beta*y
+// axpy_dot(Vector& y, data_t alpha, Vector& z)
+//    Performs axpy and returns inner product with z
 // scale(data_t alpha)
 //    Multiplies entries of vector by a constant
 // norm(index_t p)
@@ -112,6 +118,59 @@ public:
     **************************************************************/
     void axpy(Vector& y, data_t alpha);
 
+    /**************************************************************
+    *****   Vector AXPBY
+    **************************************************************
+    ***** Sets the vector to alpha*y + beta*values, in a single 
+    ***** pass
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** y : Vector&
+    *****    Vector to be summed with
+    ***** alpha : data_t
+    *****    Constant value to multiply each element of y by
+    ***** beta : data_t
+    *****    Constant value to multiply each element of vector by
+    **************************************************************/
+    void axpby(Vector& y, data_t alpha, data_t beta);
+
+    /**************************************************************
+    *****   Vector WAXPBY
+    **************************************************************
+    ***** Sets the vector to alpha*x + beta*y, without first 
+    ***** copying x
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** x : Vector&
+    *****    First vector to be summed
+    ***** y : Vector&
+    *****    Second vector to be summed
+    ***** alpha : data_t
+    *****    Constant value to multiply each element of x by
+    ***** beta : data_t
+    *****    Constant value to multiply each element of y by
+    **************************************************************/
+    void waxpby(Vector& x, Vector& y, data_t alpha, data_t beta);
+
+    /**************************************************************
+    *****   Vector AXPY Dot
+    **************************************************************
+    ***** Performs axpy, and returns the inner product of the 
+    ***** updated vector with z, in a single pass
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** y : Vector&
+    *****    Vector to be summed with
+    ***** alpha : data_t
+    *****    Constant value to multiply each element of y by
+    ***** z : Vector&
+    *****    Vector to take inner product with (may be this vector)
+    **************************************************************/
+    data_t axpy_dot(Vector& y, data_t alpha, Vector& z);
+
     /**************************************************************
     *****   Vector Copy
     **************************************************************
@@ -19,8 +19,8 @@ void BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double
      */
 
     int rank, num_procs;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+    RAPtor_MPI_Comm_size(b.comm, &num_procs);
 
     ParVector r;
     ParVector r_star;
@@ -32,6 +32,9 @@ void BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double
     int iter;
     data_t alpha, beta, omega;
     data_t rr_inner, next_inner, Apr_inner, As_inner, AsAs_inner;
+    data_t inner[2];
+    ParVector* As_vecs[2];
+    ParVector* r_vecs[2];
     double norm_r;
 
     // Same max iterations definition as pyAMG
@@ -41,11 +44,12 @@ void BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double
     }
 
     // Fixed Constructors
-    r.resize(b.global_n, b.local_n);
-    r_star.resize(b.global_n, b.local_n);
-    p.resize(b.global_n, b.local_n);
-    Ap.resize(b.global_n, b.local_n);
-    As.resize(b.global_n, b.local_n);
+    r.resize(b.global_n, b.local_n, b.comm);
+    r_star.resize(b.global_n, b.local_n, b.comm);
+    s.resize(b.global_n, b.local_n, b.comm);
+    p.resize(b.global_n, b.local_n, b.comm);
+    Ap.resize(b.global_n, b.local_n, b.comm);
+    As.resize(b.global_n, b.local_n, b.comm);
 
     // r0 = b - A * x0
     A->residual(x, b, r);
@@ -76,13 +80,15 @@ void BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double
         alpha = rr_inner / Apr_inner;
 
         // s_i = r_i - alpha_i * Ap_i
-        s.copy(r);
-        s.axpy(Ap, -1.0*alpha);
+        s.waxpby(r, Ap, 1.0, -1.0*alpha);
 
-        // omega_i = (As_i, s_i) / (As_i, As_i)
+        // omega_i = (As_i, s_i) / (As_i, As_i), single reduction
         A->mult(s, As);
-        As_inner = As.inner_product(s);
-        AsAs_inner = As.inner_product(As);
+        As_vecs[0] = &s;
+        As_vecs[1] = &As;
+        As.multi_dot(2, As_vecs, inner);
+        As_inner = inner[0];
+        AsAs_inner = inner[1];
         omega = As_inner / AsAs_inner;
 
         // x_{i+1} = x_i + alpha_i * p_i + omega_i * s_i
@@ -90,21 +96,24 @@ void BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double
         x.axpy(s, omega);
 
         // r_{i+1} = s_i - omega_i * As_i
-        r.copy(s);
-        r.axpy(As, -1.0*omega);
+        r.waxpby(s, As, 1.0, -1.0*omega);
+
+        // (r_{i+1}, r_star) and (r_{i+1}, r_{i+1}), single reduction
+        r_vecs[0] = &r_star;
+        r_vecs[1] = &r;
+        r.multi_dot(2, r_vecs, inner);
+        next_inner = inner[0];
 
         // beta_i = (r_{i+1}, r_star) / (r_i, r_star) * alpha_i / omega_i
-        next_inner = r.inner_product(r_star);
         beta = (next_inner / rr_inner) * (alpha / omega);
 
         // p_{i+1} = r_{i+1} + beta_i * (p_i - omega_i * Ap_i)
-        p.scale(beta);
+        p.axpby(Ap, -1.0*beta*omega, beta);
         p.axpy(r, 1.0);
-        p.axpy(Ap, -1.0*beta*omega);
 
         // Update next inner product
         rr_inner = next_inner;
-        norm_r = r.norm(2);
+        norm_r = sqrt(inner[1]);
         res.push_back(norm_r);
 
         iter++;
@@ -128,8 +137,8 @@ void BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double
 void SeqInner_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double>& res, double tol, int max_iter)
 {
     int rank, num_procs;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+    RAPtor_MPI_Comm_size(b.comm, &num_procs);
 
     ParVector r;
     ParVector r_star;
@@ -150,11 +159,11 @@ void SeqInner_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vect
     }
 
     // Fixed Constructors
-    r.resize(b.global_n, b.local_n);
-    r_star.resize(b.global_n, b.local_n);
-    p.resize(b.global_n, b.local_n);
-    Ap.resize(b.global_n, b.local_n);
-    As.resize(b.global_n, b.local_n);
+    r.resize(b.global_n, b.local_n, b.comm);
+    r_star.resize(b.global_n, b.local_n, b.comm);
+    p.resize(b.global_n, b.local_n, b.comm);
+    Ap.resize(b.global_n, b.local_n, b.comm);
+    As.resize(b.global_n, b.local_n, b.comm);
 
     // r0 = b - A * x0
     A->residual(x, b, r);
@@ -249,8 +258,8 @@ void Pre_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, ParMultilevel *ml
      */
 
     int rank, num_procs;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+    RAPtor_MPI_Comm_size(b.comm, &num_procs);
 
     ParVector r;
     ParVector r_star;
@@ -265,6 +274,9 @@ void Pre_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, ParMultilevel *ml
     int iter;
     data_t alpha, beta, omega;
     data_t rr_inner, next_inner, Apr_inner, As_inner, AsAs_inner;
+    data_t inner[2];
+    ParVector* As_vecs[2];
+    ParVector* r_vecs[2];
     double norm_r;
 
     // Same max iterations definition as pyAMG
@@ -274,11 +286,14 @@ void Pre_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, ParMultilevel *ml
     }
 
     // Fixed Constructors
-    r.resize(b.global_n, b.local_n);
-    r_star.resize(b.global_n, b.local_n);
-    p.resize(b.global_n, b.local_n);
-    Ap.resize(b.global_n, b.local_n);
-    As.resize(b.global_n, b.local_n);
+    r.resize(b.global_n, b.local_n, b.comm);
+    r_star.resize(b.global_n, b.local_n, b.comm);
+    s.resize(b.global_n, b.local_n, b.comm);
+    p.resize(b.global_n, b.local_n, b.comm);
+    Ap.resize(b.global_n, b.local_n, b.comm);
+    As.resize(b.global_n, b.local_n, b.comm);
+    p_hat.resize(b.global_n, b.local_n, b.comm);
+    s_hat.resize(b.global_n, b.local_n, b.comm);
 
     // BEGIN ALGORITHM
     // r0 = b - A * x0
@@ -300,6 +315,8 @@ void Pre_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, ParMultilevel *ml
         tol = tol * norm_r;
     }
 
+    iter = 0;
+
     // Main BiCGStab Loop
     while (norm_r > tol && iter < max_iter)
     {
@@ -314,18 +331,20 @@ void Pre_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, ParMultilevel *ml
         alpha = rr_inner / Apr_inner;
 
         // s_i = r_i - alpha_i * Ap_i
-        s.copy(r);
-        s.axpy(Ap, -1.0*alpha);
+        s.waxpby(r, Ap, 1.0, -1.0*alpha);
 
         // s_i = M^-1 s_i
         // Apply preconditioner
         s_hat.set_const_value(0.0);
         ml->cycle(s_hat, s);
 
-        // omega_i = (As_i, s_i) / (As_i, As_i)
+        // omega_i = (As_i, s_i) / (As_i, As_i), single reduction
         A->mult(s_hat, As);
-        As_inner = As.inner_product(s);
-        AsAs_inner = As.inner_product(As);
+        As_vecs[0] = &s;
+        As_vecs[1] = &As;
+        As.multi_dot(2, As_vecs, inner);
+        As_inner = inner[0];
+        AsAs_inner = inner[1];
         omega = As_inner / AsAs_inner;
 
         // x_{i+1} = x_i + alpha_i * p_i + omega_i * s_i
@@ -333,21 +352,24 @@ void Pre_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, ParMultilevel *ml
         x.axpy(s_hat, omega);
 
         // r_{i+1} = s_i - omega_i * As_i
-        r.copy(s);
-        r.axpy(As, -1.0*omega);
+        r.waxpby(s, As, 1.0, -1.0*omega);
+
+        // (r_{i+1}, r_star) and (r_{i+1}, r_{i+1}), single reduction
+        r_vecs[0] = &r_star;
+        r_vecs[1] = &r;
+        r.multi_dot(2, r_vecs, inner);
+        next_inner = inner[0];
 
         // beta_i = (r_{i+1}, r_star) / (r_i, r_star) * alpha_i / omega_i
-        next_inner = r.inner_product(r_star);
         beta = (next_inner / rr_inner) * (alpha / omega);
 
         // p_{i+1} = r_{i+1} + beta_i * (p_i - omega_i * Ap_i)
-        p.scale(beta);
+        p.axpby(Ap, -1.0*beta*omega, beta);
         p.axpy(r, 1.0);
-        p.axpy(Ap, -1.0*beta*omega);
 
         // Update next inner product
         rr_inner = next_inner;
-        norm_r = r.norm(2);
+        norm_r = sqrt(inner[1]);
         res.push_back(norm_r);
 
         iter++;
@@ -373,8 +395,8 @@ void Pre_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, ParMultilevel *ml
 void SeqNorm_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double>& res, double tol, int max_iter)
 {
     int rank, num_procs;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+    RAPtor_MPI_Comm_size(b.comm, &num_procs);
 
     ParVector r;
     ParVector r_star;
@@ -395,11 +417,11 @@ void SeqNorm_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vecto
     }
 
     // Fixed Constructors
-    r.resize(b.global_n, b.local_n);
-    r_star.resize(b.global_n, b.local_n);
-    p.resize(b.global_n, b.local_n);
-    Ap.resize(b.global_n, b.local_n);
-    As.resize(b.global_n, b.local_n);
+    r.resize(b.global_n, b.local_n, b.comm);
+    r_star.resize(b.global_n, b.local_n, b.comm);
+    p.resize(b.global_n, b.local_n, b.comm);
+    Ap.resize(b.global_n, b.local_n, b.comm);
+    As.resize(b.global_n, b.local_n, b.comm);
 
     // r0 = b - A * x0
     A->residual(x, b, r);
@@ -482,8 +504,8 @@ void SeqNorm_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vecto
 void SeqInnerSeqNorm_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double>& res, double tol, int max_iter)
 {
     int rank, num_procs;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+    RAPtor_MPI_Comm_size(b.comm, &num_procs);
 
     ParVector r;
     ParVector r_star;
@@ -504,11 +526,11 @@ void SeqInnerSeqNorm_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, align
     }
 
     // Fixed Constructors
-    r.resize(b.global_n, b.local_n);
-    r_star.resize(b.global_n, b.local_n);
-    p.resize(b.global_n, b.local_n);
-    Ap.resize(b.global_n, b.local_n);
-    As.resize(b.global_n, b.local_n);
+    r.resize(b.global_n, b.local_n, b.comm);
+    r_star.resize(b.global_n, b.local_n, b.comm);
+    p.resize(b.global_n, b.local_n, b.comm);
+    Ap.resize(b.global_n, b.local_n, b.comm);
+    As.resize(b.global_n, b.local_n, b.comm);
 
     // r0 = b - A * x0
     A->residual(x, b, r);
@@ -611,8 +633,8 @@ void PI_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<dou
      */
 
     int rank, num_procs;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+    RAPtor_MPI_Comm_size(b.comm, &num_procs);
     
     // Create communicators for partial inner products
     create_partial_inner_comm(inner_comm, root_comm, frac, x, inner_color, root_color, inner_root, procs_in_group, part_global);
@@ -638,11 +660,11 @@ void PI_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<dou
     }
 
     // Fixed Constructors
-    r.resize(b.global_n, b.local_n);
-    r_star.resize(b.global_n, b.local_n);
-    p.resize(b.global_n, b.local_n);
-    Ap.resize(b.global_n, b.local_n);
-    As.resize(b.global_n, b.local_n);
+    r.resize(b.global_n, b.local_n, b.comm);
+    r_star.resize(b.global_n, b.local_n, b.comm);
+    p.resize(b.global_n, b.local_n, b.comm);
+    Ap.resize(b.global_n, b.local_n, b.comm);
+    As.resize(b.global_n, b.local_n, b.comm);
 
     // BEGIN ALGORITHM
     // r0 = b - A * x0
@@ -756,8 +778,8 @@ void PrePI_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<
      */
 
     int rank, num_procs;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+    RAPtor_MPI_Comm_size(b.comm, &num_procs);
     
     // Create communicators for partial inner products
     create_partial_inner_comm(inner_comm, root_comm, frac, x, inner_color, root_color, inner_root, procs_in_group, part_global);
@@ -790,11 +812,11 @@ void PrePI_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<
     }
 
     // Fixed Constructors
-    r.resize(b.global_n, b.local_n);
-    r_star.resize(b.global_n, b.local_n);
-    p.resize(b.global_n, b.local_n);
-    Ap.resize(b.global_n, b.local_n);
-    As.resize(b.global_n, b.local_n);
+    r.resize(b.global_n, b.local_n, b.comm);
+    r_star.resize(b.global_n, b.local_n, b.comm);
+    p.resize(b.global_n, b.local_n, b.comm);
+    Ap.resize(b.global_n, b.local_n, b.comm);
+    As.resize(b.global_n, b.local_n, b.comm);
 
     // BEGIN ALGORITHM
     // r0 = b - A * x0
@@ -0,0 +1,266 @@
+// Copyright (c) 2015, Raptor Developer Team, University of Illinois at Urbana-Champaign
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "krylov/par_bicgstab_l.hpp"
+
+using namespace raptor;
+
+/**************************************************************
+ *****   Right Preconditioned Product
+ **************************************************************
+ ***** w = A*M^{-1}*v, with z holding M^{-1}*v (or v if ml is
+ ***** NULL)
+ **************************************************************/
+static void precond_mult(ParCSRMatrix* A, ParMultilevel* ml, ParVector& v,
+        ParVector& z, ParVector& w)
+{
+    if (ml)
+    {
+        z.set_const_value(0.0);
+        ml->cycle(z, v);
+        A->mult(z, w);
+    }
+    else
+    {
+        A->mult(v, w);
+    }
+}
+
+/**************************************************************
+ *****   Dense Solve
+ **************************************************************
+ ***** Solves the n x n system M*y = f (M row-wise, overwritten)
+ ***** by Gaussian elimination with partial pivoting
+ **************************************************************/
+static void dense_solve(int n, aligned_vector<double>& M, aligned_vector<double>& f,
+        aligned_vector<double>& y)
+{
+    int piv;
+    double val;
+
+    for (int k = 0; k < n; k++)
+    {
+        piv = k;
+        for (int i = k + 1; i < n; i++)
+        {
+            if (fabs(M[i*n + k]) > fabs(M[piv*n + k])) piv = i;
+        }
+        if (piv != k)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                std::swap(M[k*n + j], M[piv*n + j]);
+            }
+            std::swap(f[k], f[piv]);
+        }
+        for (int i = k + 1; i < n; i++)
+        {
+            val = M[i*n + k] / M[k*n + k];
+            for (int j = k; j < n; j++)
+            {
+                M[i*n + j] -= val * M[k*n + j];
+            }
+            f[i] -= val * f[k];
+        }
+    }
+
+    for (int i = n - 1; i >= 0; i--)
+    {
+        val = f[i];
+        for (int j = i + 1; j < n; j++)
+        {
+            val -= M[i*n + j] * y[j];
+        }
+        y[i] = val / M[i*n + i];
+    }
+}
+
+void BiCGStab_l(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b,
+        aligned_vector<double>& res, int l, double tol, int max_iter,
+        ReductionPolicy* policy)
+{
+    /*           A : ParCSRMatrix for system to solve
+     *          ml : preconditioner (or NULL)
+     *           x : ParVector solution to solve for
+     *           b : ParVector rhs of system to solve
+     *         res : vector containing residuals of each iteration
+     *           l : degree of minimal residual polynomial
+     *         tol : tolerance for convergence
+     *    max_iter : maximum number of (outer) iterations
+     *      policy : reduction policy for inner products
+     */
+
+    int rank;
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+
+    // BiCG coefficients and residual norms use a full reduction if
+    // policy is approximate
+    FullReduction full_reduction;
+    if (policy == NULL) policy = &full_reduction;
+    ReductionPolicy* bicg_policy = policy->exact() ? policy : &full_reduction;
+
+    int iter;
+    int num_gram = (l+1)*(l+2)/2;
+    data_t rho0, rho1, alpha, beta, omega, gamma;
+    double norm_r;
+
+    aligned_vector<data_t> inner(num_gram);
+    aligned_vector<double> G(l*l);
+    aligned_vector<double> f(l);
+    aligned_vector<double> coef(l);
+    std::vector<ParVector*> dot_x(num_gram);
+    std::vector<ParVector*> dot_y(num_gram);
+
+    // Same max iterations definition as pyAMG, per BiCG step
+    if (max_iter <= 0)
+    {
+        max_iter = (((int)(1.3*b.global_n)) + 2) / l + 1;
+    }
+
+    // r[0..l] and u[0..l] : residuals and search directions, and their
+    // images under A*M^{-1}
+    std::vector<ParVector> r(l+1);
+    std::vector<ParVector> u(l+1);
+    for (int i = 0; i <= l; i++)
+    {
+        r[i].resize(b.global_n, b.local_n, b.comm);
+        u[i].resize(b.global_n, b.local_n, b.comm);
+    }
+    ParVector r_star(b.global_n, b.local_n, b.comm);
+    ParVector y(b.global_n, b.local_n, b.comm);
+    ParVector z(b.global_n, b.local_n, b.comm);
+
+    // r0 = b - A * x0, and the update to x0 is M^{-1}y
+    A->residual(x, b, r[0]);
+    r_star.copy(r[0]);
+    u[0].set_const_value(0.0);
+    y.set_const_value(0.0);
+
+    rho0 = 1.0;
+    alpha = 0.0;
+    omega = 1.0;
+    iter = 0;
+
+    // Main BiCGStab(l) Loop
+    while (true)
+    {
+        // (r_0, r*) and (r_0, r_0), single reduction
+        dot_x[0] = &(r[0]);
+        dot_y[0] = &r_star;
+        dot_x[1] = &(r[0]);
+        dot_y[1] = &(r[0]);
+        bicg_policy->dot(2, dot_x.data(), dot_y.data(), inner.data());
+        rho1 = inner[0];
+        norm_r = sqrt(inner[1]);
+        res.push_back(norm_r);
+
+        if (iter == 0 && norm_r != 0.0)
+        {
+            tol = tol * norm_r;
+        }
+        if (norm_r <= tol || iter >= max_iter) break;
+
+        rho0 = -omega * rho0;
+
+        // BiCG Part
+        for (int j = 0; j < l; j++)
+        {
+            if (j > 0)
+            {
+                rho1 = bicg_policy->dot(r[j], r_star);
+            }
+            beta = alpha * (rho1 / rho0);
+            rho0 = rho1;
+
+            // u_i = r_i - beta*u_i, u_{j+1} = A*M^{-1}*u_j
+            for (int i = 0; i <= j; i++)
+            {
+                u[i].axpby(r[i], 1.0, -beta);
+            }
+            precond_mult(A, ml, u[j], z, u[j+1]);
+
+            // alpha = rho / (u_{j+1}, r*)
+            gamma = bicg_policy->dot(u[j+1], r_star);
+            alpha = rho0 / gamma;
+
+            // r_i -= alpha*u_{i+1}, r_{j+1} = A*M^{-1}*r_j
+            for (int i = 0; i <= j; i++)
+            {
+                r[i].axpy(u[i+1], -alpha);
+            }
+            precond_mult(A, ml, r[j], z, r[j+1]);
+
+            y.axpy(u[0], alpha);
+        }
+
+        // MR Part : Gram matrix of r_0, ..., r_l in a single reduction
+        int idx = 0;
+        for (int i = 0; i <= l; i++)
+        {
+            for (int j = i; j <= l; j++)
+            {
+                dot_x[idx] = &(r[i]);
+                dot_y[idx] = &(r[j]);
+                idx++;
+            }
+        }
+        policy->dot(num_gram, dot_x.data(), dot_y.data(), inner.data());
+
+        // Minimize ||r_0 - sum_j coef_j r_j|| over coef_1, ..., coef_l
+        idx = 0;
+        for (int i = 0; i <= l; i++)
+        {
+            for (int j = i; j <= l; j++)
+            {
+                if (i == 0)
+                {
+                    if (j > 0) f[j-1] = inner[idx];
+                }
+                else
+                {
+                    G[(i-1)*l + (j-1)] = inner[idx];
+                    G[(j-1)*l + (i-1)] = inner[idx];
+                }
+                idx++;
+            }
+        }
+        dense_solve(l, G, f, coef);
+        omega = coef[l-1];
+
+        // y += sum coef_j r_{j-1}, r_0 -= sum coef_j r_j,
+        // u_0 -= sum coef_j u_j
+        for (int j = 1; j <= l; j++)
+        {
+            y.axpy(r[j-1], coef[j-1]);
+            r[0].axpy(r[j], -coef[j-1]);
+            u[0].axpy(u[j], -coef[j-1]);
+        }
+
+        iter++;
+    }
+
+    // x = x0 + M^{-1}y
+    if (ml)
+    {
+        z.set_const_value(0.0);
+        ml->cycle(z, y);
+        x.axpy(z, 1.0);
+    }
+    else
+    {
+        x.axpy(y, 1.0);
+    }
+
+    if (rank == 0)
+    {
+        if (iter == max_iter)
+        {
+            printf("Max Iterations Reached.\n");
+            printf("2 Norm of Residual: %lg\n\n", norm_r);
+        }
+        else
+        {
+            printf("%d Iteration required to converge\n", iter);
+            printf("2 Norm of Residual: %lg\n\n", norm_r);
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef RAPTOR_KRYLOV_PAR_BICGSTAB_L_HPP
+#define RAPTOR_KRYLOV_PAR_BICGSTAB_L_HPP
+
+#include "core/types.hpp"
+#include "core/par_matrix.hpp"
+#include "core/par_vector.hpp"
+#include "multilevel/par_multilevel.hpp"
+#include "krylov/par_reduction.hpp"
+#include <vector>
+
+using namespace raptor;
+
+/**************************************************************
+ *****   BiCGStab(l)
+ **************************************************************
+ ***** Right-preconditioned BiCGStab(l) (Sleijpen and Fokkema),
+ ***** with an optional AMG preconditioner (ml may be NULL).  Each
+ ***** outer iteration performs l BiCG steps followed by a 
+ ***** minimal residual polynomial of degree l, which is more
+ ***** robust than BiCGStab (l = 1) for nonsymmetric problems
+ ***** with complex eigenvalues.
+ *****
+ ***** Every BiCG step needs two reductions, and the minimal
+ ***** residual step reduces the (l+1)x(l+1) Gram matrix of the
+ ***** residuals with one more, for 2l+1 reductions per outer 
+ ***** iteration.  The residual norm is batched with the first 
+ ***** BiCG reduction.  Inner products are formed through policy 
+ ***** (a FullReduction if NULL).  An approximate policy is only
+ ***** used for the minimal residual step, as in PI_BiCGStab.
+ *****
+ ***** Each outer iteration counts as one iteration, and res
+ ***** holds the residual norm after each outer iteration.
+ **************************************************************/
+void BiCGStab_l(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, 
+        aligned_vector<double>& res, int l = 2, double tol = 1e-05, 
+        int max_iter = -1, ReductionPolicy* policy = NULL);
+
+#endif
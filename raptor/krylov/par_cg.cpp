@@ -2,13 +2,14 @@
 // License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
 #include "krylov/par_cg.hpp"
 #include "multilevel/par_multilevel.hpp"
+#include "core/repro_sum.hpp"
 
 using namespace raptor;
 
 void CG(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double>& res, double tol, int max_iter, double* comm_t)
 {
     int rank;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
 
     ParVector r;
     ParVector p;
@@ -27,9 +28,9 @@ void CG(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double>& res
     }
 
     // Fixed Constructors
-    r.resize(b.global_n, b.local_n);
-    p.resize(b.global_n, b.local_n);
-    Ap.resize(b.global_n, b.local_n);
+    r.resize(b.global_n, b.local_n, b.comm);
+    p.resize(b.global_n, b.local_n, b.comm);
+    Ap.resize(b.global_n, b.local_n, b.comm);
 
     // r0 = b - A * x0
     A->residual(x, b, r);
@@ -70,27 +71,28 @@ if (comm_t) *comm_t += RAPtor_MPI_Wtime();
         }
         alpha = rr_inner / App_inner;
 
+        // x_{i+1} = x_i + alpha_i * p_i
         x.axpy(p, alpha);
 
-        // x_{i+1} = x_i + alpha_i * p_i
+        // r_{i+1} = r_i - alpha_i * A*p_i, fused with 
+        // (r_{i+1}, r_{i+1}) unless residual is recomputed
         if ((iter % recompute_r) && iter > 0)
         {
-            r.axpy(Ap, -1.0*alpha);
+            next_inner = r.axpy_dot(Ap, -1.0*alpha, r, comm_t);
         }
         else
         {
             A->residual(x, b, r);
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+            next_inner = r.inner_product(r);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
         }
 
         // beta_i = (r_{i+1}, r_{i+1}) / (r_i, r_i)
-if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
-        next_inner = r.inner_product(r);
-if (comm_t) *comm_t += RAPtor_MPI_Wtime();
         beta = next_inner / rr_inner;
 
         // p_{i+1} = r_{i+1} + beta_i * p_i
-        p.scale(beta);
-        p.axpy(r, 1.0);
+        p.axpby(r, 1.0, beta);
 
         // Update next inner product
         rr_inner = next_inner;
@@ -118,10 +120,18 @@ if (comm_t) *comm_t += RAPtor_MPI_Wtime();
 }
 
 
+/**************************************************************
+ *****   Preconditioned CG
+ **************************************************************
+ ***** (A*p, p) is reduced explicitly each iteration rather than
+ ***** through the Chronopoulos and Gear recurrence, which is only
+ ***** valid for symmetric preconditioners (it breaks down with a
+ ***** forward SOR V-cycle, for example).
+ **************************************************************/
 void PCG(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, aligned_vector<double>& res, double tol, int max_iter, double* precond_t, double* comm_t)
 {
     int rank;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
 
     ParVector r;
     ParVector z;
@@ -141,10 +151,10 @@ void PCG(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, aligned
     }
 
     // Fixed Constructors
-    r.resize(b.global_n, b.local_n);
-    z.resize(b.global_n, b.local_n);
-    p.resize(b.global_n, b.local_n);
-    Ap.resize(b.global_n, b.local_n);
+    r.resize(b.global_n, b.local_n, b.comm);
+    z.resize(b.global_n, b.local_n, b.comm);
+    p.resize(b.global_n, b.local_n, b.comm);
+    Ap.resize(b.global_n, b.local_n, b.comm);
 
     // Initial b_norm (preconditioned)
     z.set_const_value(0.0);
@@ -238,8 +248,7 @@ if (comm_t) *comm_t += RAPtor_MPI_Wtime();
         }
         else
         {
-            p.scale(beta);
-            p.axpy(z, 1.0);
+            p.axpby(z, 1.0, beta);
         }
 
         // Update next inner product
@@ -262,3 +271,175 @@ if (comm_t) *comm_t += RAPtor_MPI_Wtime();
     return;
 }
 
+
+/**************************************************************
+ *****   Pipelined Preconditioned CG
+ **************************************************************
+ ***** Ghysels and Vanroose pipelined PCG.  Both inner products
+ ***** of an iteration, (r, u) and (w, u), are reduced with a
+ ***** single non-blocking allreduce, which is overlapped with 
+ ***** the preconditioner application m = M^{-1}w and the SpMV
+ ***** n = Am.  Requires four extra vectors compared to PCG, and
+ ***** residuals are updated recursively, so the attainable 
+ ***** accuracy can be slightly lower.
+ *****
+ ***** Residuals stored in res are the preconditioned norm 
+ ***** sqrt((r, M^{-1}r)), relative to that of b.
+ **************************************************************/
+void PipelinedPCG(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, aligned_vector<double>& res, double tol, int max_iter, double* precond_t, double* comm_t)
+{
+    int rank;
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+
+    ParVector r, u, w, m, n;
+    ParVector p, s, q, z;
+
+    int iter;
+    data_t alpha, beta;
+    data_t gamma, gamma_old, delta;
+    data_t inner[2];
+    ReproSum repro_inner[2];
+    double norm_b, norm_r;
+    RAPtor_MPI_Request request;
+
+    if (max_iter <= 0)
+    {
+        max_iter = ((int)(1.3*b.global_n)) + 2;
+    }
+
+    // Fixed Constructors
+    r.resize(b.global_n, b.local_n, b.comm);
+    u.resize(b.global_n, b.local_n, b.comm);
+    w.resize(b.global_n, b.local_n, b.comm);
+    m.resize(b.global_n, b.local_n, b.comm);
+    n.resize(b.global_n, b.local_n, b.comm);
+    p.resize(b.global_n, b.local_n, b.comm);
+    s.resize(b.global_n, b.local_n, b.comm);
+    q.resize(b.global_n, b.local_n, b.comm);
+    z.resize(b.global_n, b.local_n, b.comm);
+
+    // Initial b_norm (preconditioned)
+    u.set_const_value(0.0);
+if (precond_t) *precond_t -= RAPtor_MPI_Wtime();
+    ml->cycle(u, b);
+if (precond_t) *precond_t += RAPtor_MPI_Wtime();
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+    norm_b = sqrt(b.inner_product(u));
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+    if (norm_b < zero_tol) norm_b = 1.0;
+
+    // r0 = b - A*x0, u0 = M^{-1}r0, w0 = A*u0
+    A->residual(x, b, r);
+    u.set_const_value(0.0);
+if (precond_t) *precond_t -= RAPtor_MPI_Wtime();
+    ml->cycle(u, r);
+if (precond_t) *precond_t += RAPtor_MPI_Wtime();
+    A->mult(u, w);
+
+    gamma_old = 0.0;
+    alpha = 0.0;
+    iter = 0;
+
+    // Main Pipelined CG Loop
+    while (iter < max_iter)
+    {
+        // Start reduction of gamma = (r, u) and delta = (w, u)
+        if (reproducible_reductions)
+        {
+            repro_inner[0].clear();
+            repro_inner[1].clear();
+            for (int i = 0; i < b.local_n; i++)
+            {
+                repro_inner[0].add(r[i] * u[i]);
+                repro_inner[1].add(w[i] * u[i]);
+            }
+            repro_iallreduce(repro_inner, 2, b.comm, &request);
+        }
+        else
+        {
+            inner[0] = 0.0;
+            inner[1] = 0.0;
+            if (b.local_n)
+            {
+                inner[0] = r.local.inner_product(u.local);
+                inner[1] = w.local.inner_product(u.local);
+            }
+            RAPtor_MPI_Iallreduce(RAPtor_MPI_IN_PLACE, inner, 2, RAPtor_MPI_DATA_T, 
+                    RAPtor_MPI_SUM, b.comm, &request);
+        }
+
+        // m = M^{-1}w, n = A*m, overlapped with reduction
+        m.set_const_value(0.0);
+if (precond_t) *precond_t -= RAPtor_MPI_Wtime();
+        ml->cycle(m, w);
+if (precond_t) *precond_t += RAPtor_MPI_Wtime();
+        A->mult(m, n);
+
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+        RAPtor_MPI_Wait(&request, RAPtor_MPI_STATUS_IGNORE);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+        if (reproducible_reductions)
+        {
+            inner[0] = repro_inner[0].value();
+            inner[1] = repro_inner[1].value();
+        }
+        gamma = inner[0];
+        delta = inner[1];
+
+        norm_r = sqrt(fabs(gamma));
+        res.emplace_back(norm_r / norm_b);
+        if (norm_r / norm_b < tol) break;
+
+        if (iter > 0)
+        {
+            beta = gamma / gamma_old;
+            alpha = gamma / (delta - beta * gamma / alpha);
+        }
+        else
+        {
+            beta = 0.0;
+            alpha = gamma / delta;
+        }
+        if (alpha < 0.0)
+        {
+            if (rank == 0)
+            {
+                printf("Indefinite matrix detected in CG! Aborting...\n");
+            }
+            exit(-1);
+        }
+
+        for (int i = 0; i < b.local_n; i++)
+        {
+            // z = n + beta*z, q = m + beta*q, s = w + beta*s, p = u + beta*p
+            z[i] = n[i] + beta * z[i];
+            q[i] = m[i] + beta * q[i];
+            s[i] = w[i] + beta * s[i];
+            p[i] = u[i] + beta * p[i];
+
+            // x += alpha*p, r -= alpha*s, u -= alpha*q, w -= alpha*z
+            x[i] += alpha * p[i];
+            r[i] -= alpha * s[i];
+            u[i] -= alpha * q[i];
+            w[i] -= alpha * z[i];
+        }
+
+        gamma_old = gamma;
+        iter++;
+    }
+
+    if (rank == 0)
+    {
+        if (iter == max_iter)
+        {
+            printf("Max Iterations Reached.\n");
+        }
+        else
+        {
+            printf("%d Iteration required to converge\n", iter);
+        }
+        printf("Relative Residual: %lg\n\n", res.back());
+    }
+
+    return;
+}
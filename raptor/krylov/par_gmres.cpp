@@ -0,0 +1,289 @@
+// Copyright (c) 2015, Raptor Developer Team, University of Illinois at Urbana-Champaign
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "krylov/par_gmres.hpp"
+#include "core/repro_sum.hpp"
+
+using namespace raptor;
+
+/**************************************************************
+ *****   Fused Classical Gram-Schmidt
+ **************************************************************
+ ***** Orthogonalizes w against the first k columns of the 
+ ***** contiguous basis V, storing coefficients in h.  The inner
+ ***** products and ||w||^2 share a single allreduce, and the 
+ ***** norm of the orthogonalized vector is found from 
+ ***** ||w||^2 - ||h||^2.  If more than half of the digits 
+ ***** cancel, a second pass is performed.
+ *****
+ ***** Returns the norm of the orthogonalized w.
+ **************************************************************/
+double fused_cgs(const aligned_vector<double>& V, int k, ParVector& w,
+        double* h, aligned_vector<double>& inner)
+{
+    int n = w.local_n;
+    double w_norm2, h_norm2;
+    double val;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        // Local inner products (V_i, w) and (w, w)
+        if (reproducible_reductions)
+        {
+            std::vector<ReproSum> sums(k + 1);
+            for (int i = 0; i < k; i++)
+            {
+                const double* v_i = &V[i*n];
+                for (int j = 0; j < n; j++)
+                {
+                    sums[i].add(v_i[j] * w[j]);
+                }
+            }
+            for (int j = 0; j < n; j++)
+            {
+                sums[k].add(w[j] * w[j]);
+            }
+            repro_allreduce(sums.data(), inner.data(), k + 1, w.comm);
+        }
+        else
+        {
+            for (int i = 0; i <= k; i++)
+            {
+                inner[i] = 0.0;
+            }
+            for (int i = 0; i < k; i++)
+            {
+                const double* v_i = &V[i*n];
+                val = 0.0;
+                for (int j = 0; j < n; j++)
+                {
+                    val += v_i[j] * w[j];
+                }
+                inner[i] = val;
+            }
+            for (int j = 0; j < n; j++)
+            {
+                inner[k] += w[j] * w[j];
+            }
+            RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, inner.data(), k + 1,
+                    RAPtor_MPI_DATA_T, RAPtor_MPI_SUM, w.comm);
+        }
+
+        // w -= V*h
+        h_norm2 = 0.0;
+        for (int i = 0; i < k; i++)
+        {
+            const double* v_i = &V[i*n];
+            val = inner[i];
+            for (int j = 0; j < n; j++)
+            {
+                w[j] -= val * v_i[j];
+            }
+            h[i] += val;
+            h_norm2 += val * val;
+        }
+        w_norm2 = inner[k] - h_norm2;
+
+        if (w_norm2 > 0.5 * inner[k]) break;
+    }
+
+    if (w_norm2 < 0.0) w_norm2 = 0.0;
+    return sqrt(w_norm2);
+}
+
+void gmres_helper(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b,
+        aligned_vector<double>& res, double tol, int max_iter, int restart,
+        bool flexible)
+{
+    int rank;
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+
+    int n = b.local_n;
+    int m = restart;
+    int iter, k;
+    double norm_r, b_norm, h_norm;
+    double temp;
+
+    ParVector r(b.global_n, n, b.comm);
+    ParVector v(b.global_n, n, b.comm);
+    ParVector z(b.global_n, n, b.comm);
+    ParVector w(b.global_n, n, b.comm);
+
+    // Contiguous Krylov basis (and preconditioned basis for FGMRES)
+    aligned_vector<double> V((m+1) * n);
+    aligned_vector<double> Z;
+    if (flexible) Z.resize(m * n);
+
+    // Hessenberg matrix (column-major), Givens rotations, rhs
+    aligned_vector<double> H((m+1) * m);
+    aligned_vector<double> cs(m);
+    aligned_vector<double> sn(m);
+    aligned_vector<double> g(m+1);
+    aligned_vector<double> y(m);
+    aligned_vector<double> inner(m+1);
+
+    if (max_iter <= 0)
+    {
+        max_iter = ((int)(1.3*b.global_n)) + 2;
+    }
+
+    b_norm = b.norm(2);
+    if (b_norm < zero_tol) b_norm = 1.0;
+
+    // r0 = b - A * x0
+    A->residual(x, b, r);
+    norm_r = r.norm(2);
+    res.emplace_back(norm_r / b_norm);
+
+    if (norm_r != 0.0)
+    {
+        tol = tol * norm_r;
+    }
+
+    iter = 0;
+
+    // Restart Loop
+    while (norm_r > tol && iter < max_iter)
+    {
+        // v_0 = r / ||r||
+        for (int i = 0; i < n; i++)
+        {
+            V[i] = r[i] / norm_r;
+        }
+        std::fill(H.begin(), H.end(), 0.0);
+        std::fill(g.begin(), g.end(), 0.0);
+        g[0] = norm_r;
+
+        // Arnoldi
+        for (k = 0; k < m && iter < max_iter; )
+        {
+            // z = M^{-1}v_k, w = A*z
+            std::copy(&V[k*n], &V[k*n] + n, v.local.values.begin());
+            if (ml)
+            {
+                z.set_const_value(0.0);
+                ml->cycle(z, v);
+            }
+            else
+            {
+                z.copy(v);
+            }
+            if (flexible)
+            {
+                std::copy(z.local.values.begin(), z.local.values.end(), &Z[k*n]);
+            }
+            A->mult(z, w);
+
+            // Orthogonalize against v_0, ..., v_k
+            double* h = &H[k*(m+1)];
+            h_norm = fused_cgs(V, k+1, w, h, inner);
+            h[k+1] = h_norm;
+            if (h_norm > zero_tol)
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    V[(k+1)*n + i] = w[i] / h_norm;
+                }
+            }
+
+            // Apply previous rotations to new column
+            for (int i = 0; i < k; i++)
+            {
+                temp = cs[i] * h[i] + sn[i] * h[i+1];
+                h[i+1] = -sn[i] * h[i] + cs[i] * h[i+1];
+                h[i] = temp;
+            }
+
+            // Form rotation eliminating h[k+1]
+            temp = sqrt(h[k]*h[k] + h[k+1]*h[k+1]);
+            cs[k] = h[k] / temp;
+            sn[k] = h[k+1] / temp;
+            h[k] = temp;
+            h[k+1] = 0.0;
+            g[k+1] = -sn[k] * g[k];
+            g[k] = cs[k] * g[k];
+
+            norm_r = fabs(g[k+1]);
+            res.emplace_back(norm_r / b_norm);
+            iter++;
+            k++;
+
+            if (norm_r <= tol || h_norm <= zero_tol) break;
+        }
+
+        // Solve upper triangular H*y = g
+        for (int i = k - 1; i >= 0; i--)
+        {
+            temp = g[i];
+            for (int j = i + 1; j < k; j++)
+            {
+                temp -= H[j*(m+1) + i] * y[j];
+            }
+            y[i] = temp / H[i*(m+1) + i];
+        }
+
+        // x += M^{-1}V*y (or Z*y for FGMRES)
+        if (flexible)
+        {
+            for (int j = 0; j < k; j++)
+            {
+                const double* z_j = &Z[j*n];
+                for (int i = 0; i < n; i++)
+                {
+                    x[i] += y[j] * z_j[i];
+                }
+            }
+        }
+        else
+        {
+            v.set_const_value(0.0);
+            for (int j = 0; j < k; j++)
+            {
+                const double* v_j = &V[j*n];
+                for (int i = 0; i < n; i++)
+                {
+                    v[i] += y[j] * v_j[i];
+                }
+            }
+            if (ml)
+            {
+                z.set_const_value(0.0);
+                ml->cycle(z, v);
+                x.axpy(z, 1.0);
+            }
+            else
+            {
+                x.axpy(v, 1.0);
+            }
+        }
+
+        // Recompute true residual before restarting
+        A->residual(x, b, r);
+        norm_r = r.norm(2);
+    }
+
+    if (rank == 0)
+    {
+        if (iter == max_iter)
+        {
+            printf("Max Iterations Reached.\n");
+            printf("2 Norm of Residual: %lg\n\n", norm_r);
+        }
+        else
+        {
+            printf("%d Iteration required to converge\n", iter);
+            printf("2 Norm of Residual: %lg\n\n", norm_r);
+        }
+    }
+}
+
+void GMRES(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, 
+        aligned_vector<double>& res, double tol, int max_iter, int restart)
+{
+    gmres_helper(A, ml, x, b, res, tol, max_iter, restart, false);
+}
+
+void FGMRES(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, 
+        aligned_vector<double>& res, double tol, int max_iter, int restart)
+{
+    gmres_helper(A, ml, x, b, res, tol, max_iter, restart, true);
+}
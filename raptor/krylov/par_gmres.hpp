@@ -0,0 +1,36 @@
+#ifndef RAPTOR_KRYLOV_PAR_GMRES_HPP
+#define RAPTOR_KRYLOV_PAR_GMRES_HPP
+
+#include "core/types.hpp"
+#include "core/par_matrix.hpp"
+#include "core/par_vector.hpp"
+#include "multilevel/par_multilevel.hpp"
+#include <vector>
+
+using namespace raptor;
+
+/**************************************************************
+ *****   Restarted GMRES
+ **************************************************************
+ ***** Right-preconditioned GMRES(restart), with an optional
+ ***** AMG preconditioner (ml may be NULL).  FGMRES stores the
+ ***** preconditioned basis, so the preconditioner may change
+ ***** between iterations.
+ *****
+ ***** The Krylov basis is stored in one contiguous block of 
+ ***** local values.  Each iteration orthogonalizes with classical
+ ***** Gram-Schmidt, reducing all inner products and the norm of
+ ***** the new vector with a single allreduce.  A second pass 
+ ***** (and reduction) is only performed when cancellation is 
+ ***** detected.
+ *****
+ ***** Residuals stored in res are relative to the norm of b.
+ **************************************************************/
+void GMRES(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, 
+        aligned_vector<double>& res, double tol = 1e-05, int max_iter = -1, 
+        int restart = 30);
+void FGMRES(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, 
+        aligned_vector<double>& res, double tol = 1e-05, int max_iter = -1, 
+        int restart = 30);
+
+#endif
@@ -0,0 +1,346 @@
+// Copyright (c) 2015, Raptor Developer Team, University of Illinois at Urbana-Champaign
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "krylov/par_idr.hpp"
+
+using namespace raptor;
+
+/**************************************************************
+ *****   Right Preconditioned Product
+ **************************************************************
+ ***** w = A*M^{-1}*v, with z holding M^{-1}*v (or v if ml is
+ ***** NULL)
+ **************************************************************/
+static void precond_mult(ParCSRMatrix* A, ParMultilevel* ml, ParVector& v,
+        ParVector& z, ParVector& w)
+{
+    if (ml)
+    {
+        z.set_const_value(0.0);
+        ml->cycle(z, v);
+        A->mult(z, w);
+    }
+    else
+    {
+        A->mult(v, w);
+    }
+}
+
+/**************************************************************
+ *****   Shadow Space
+ **************************************************************
+ ***** Fills P with s orthonormal vectors, with entries hashed
+ ***** from the global row and column so they are independent of
+ ***** the partition
+ **************************************************************/
+static void form_shadow_space(std::vector<ParVector>& P, int first_row)
+{
+    int s = P.size();
+    uint32_t h;
+    data_t val;
+
+    for (int j = 0; j < s; j++)
+    {
+        for (int i = 0; i < P[j].local_n; i++)
+        {
+            h = ((uint32_t) (first_row + i + 1)) * 2654435761u
+                ^ ((uint32_t) (j + 1)) * 40503u;
+            h ^= h >> 13;
+            h *= 0x5bd1e995u;
+            h ^= h >> 15;
+            P[j][i] = (h / 4294967295.0) - 0.5;
+        }
+
+        // Modified Gram-Schmidt
+        for (int k = 0; k < j; k++)
+        {
+            val = P[j].inner_product(P[k]);
+            P[j].axpy(P[k], -val);
+        }
+        val = P[j].norm(2);
+        P[j].scale(1.0 / val);
+    }
+}
+
+void IDR(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b,
+        aligned_vector<double>& res, int s, double tol, int max_iter,
+        ReductionPolicy* policy)
+{
+    /*           A : ParCSRMatrix for system to solve
+     *          ml : preconditioner (or NULL)
+     *           x : ParVector solution to solve for
+     *           b : ParVector rhs of system to solve
+     *         res : vector containing residuals of each iteration
+     *           s : dimension of the shadow space
+     *         tol : tolerance for convergence
+     *    max_iter : maximum number of iterations
+     *      policy : reduction policy for inner products
+     */
+
+    int rank;
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+
+    // Biorthogonalization and residual norms use a full reduction if
+    // policy is approximate
+    FullReduction full_reduction;
+    if (policy == NULL) policy = &full_reduction;
+    ReductionPolicy* exact_policy = policy->exact() ? policy : &full_reduction;
+
+    int iter;
+    bool pending, converged;
+    data_t beta, omega, rho, val;
+    data_t norm_sq;
+    double norm_r;
+    double kappa = 0.7;
+
+    // M = P^T G (column-major, lower triangular), f = P^T r
+    aligned_vector<data_t> M(s*s, 0.0);
+    aligned_vector<data_t> f(s);
+    aligned_vector<data_t> c(s);
+    aligned_vector<data_t> alpha(s);
+    aligned_vector<data_t> inner(2*s + 2);
+    std::vector<ParVector*> dot_x(2*s + 2);
+    std::vector<ParVector*> dot_y(2*s + 2);
+    ParVector* r_ptr;
+
+    if (max_iter <= 0)
+    {
+        max_iter = ((int)(1.3*b.global_n)) + 2;
+    }
+
+    std::vector<ParVector> P(s);
+    std::vector<ParVector> G(s);
+    std::vector<ParVector> U(s);
+    for (int i = 0; i < s; i++)
+    {
+        P[i].resize(b.global_n, b.local_n, b.comm);
+        G[i].resize(b.global_n, b.local_n, b.comm);
+        U[i].resize(b.global_n, b.local_n, b.comm);
+        G[i].set_const_value(0.0);
+        U[i].set_const_value(0.0);
+        M[i*s + i] = 1.0;
+    }
+    form_shadow_space(P, A->partition->first_local_row);
+
+    ParVector r(b.global_n, b.local_n, b.comm);
+    ParVector v(b.global_n, b.local_n, b.comm);
+    ParVector q(b.global_n, b.local_n, b.comm);
+    ParVector t(b.global_n, b.local_n, b.comm);
+    ParVector y(b.global_n, b.local_n, b.comm);
+    ParVector z(b.global_n, b.local_n, b.comm);
+    r_ptr = &r;
+
+    // r0 = b - A * x0, and the update to x0 is M^{-1}y
+    A->residual(x, b, r);
+    y.set_const_value(0.0);
+
+    // f = P^T r
+    for (int i = 0; i < s; i++)
+    {
+        dot_x[i] = &(P[i]);
+        dot_y[i] = &r;
+    }
+    exact_policy->dot(s, dot_x.data(), dot_y.data(), f.data());
+    norm_sq = exact_policy->dot(r, r);
+    norm_r = sqrt(norm_sq);
+    res.emplace_back(norm_r);
+
+    if (norm_r != 0.0)
+    {
+        tol = tol * norm_r;
+    }
+
+    omega = 1.0;
+    iter = 0;
+    pending = false;
+    converged = norm_r <= tol;
+
+    // Main IDR(s) Loop
+    while (!converged && iter < max_iter)
+    {
+        for (int k = 0; k < s; k++)
+        {
+            // Solve lower triangular M(k:s, k:s) c = f(k:s)
+            for (int i = k; i < s; i++)
+            {
+                val = f[i];
+                for (int j = k; j < i; j++)
+                {
+                    val -= M[j*s + i] * c[j];
+                }
+                c[i] = val / M[i*s + i];
+            }
+
+            // v = r - G(:, k:s) c, U_k = U(:, k:s) c + omega*v
+            v.copy(r);
+            for (int i = k; i < s; i++)
+            {
+                v.axpy(G[i], -c[i]);
+            }
+            q.copy(v);
+            q.scale(omega);
+            for (int i = k; i < s; i++)
+            {
+                q.axpy(U[i], c[i]);
+            }
+            U[k].copy(q);
+            precond_mult(A, ml, U[k], z, G[k]);
+
+            // Complete residual norm of the previous step
+            if (pending)
+            {
+                exact_policy->wait();
+                pending = false;
+                norm_r = sqrt(norm_sq);
+                res.push_back(norm_r);
+                if (norm_r <= tol)
+                {
+                    converged = true;
+                    break;
+                }
+            }
+
+            // P^T G_k, single reduction
+            for (int i = 0; i < s; i++)
+            {
+                dot_x[i] = &(P[i]);
+                dot_y[i] = &(G[k]);
+            }
+            exact_policy->dot(s, dot_x.data(), dot_y.data(), inner.data());
+
+            // Biorthogonalize G_k against G_0, ..., G_{k-1}
+            for (int i = 0; i < k; i++)
+            {
+                val = inner[i];
+                for (int j = 0; j < i; j++)
+                {
+                    val -= M[j*s + i] * alpha[j];
+                }
+                alpha[i] = val / M[i*s + i];
+            }
+            for (int i = 0; i < k; i++)
+            {
+                G[k].axpy(G[i], -alpha[i]);
+                U[k].axpy(U[i], -alpha[i]);
+            }
+            for (int i = k; i < s; i++)
+            {
+                val = inner[i];
+                for (int j = 0; j < k; j++)
+                {
+                    val -= M[j*s + i] * alpha[j];
+                }
+                M[k*s + i] = val;
+            }
+
+            // r -= beta*G_k, y += beta*U_k
+            beta = f[k] / M[k*s + k];
+            r.axpy(G[k], -beta);
+            y.axpy(U[k], beta);
+            iter++;
+
+            // Start residual norm, completed during the next step
+            exact_policy->start(1, &r_ptr, &r_ptr, &norm_sq);
+            pending = true;
+
+            for (int i = k + 1; i < s; i++)
+            {
+                f[i] -= beta * M[k*s + i];
+            }
+
+            if (iter >= max_iter) break;
+        }
+        if (converged || iter >= max_iter) break;
+
+        // Dimension reduction step : t = A*M^{-1}*r
+        precond_mult(A, ml, r, z, t);
+
+        if (pending)
+        {
+            exact_policy->wait();
+            pending = false;
+            norm_r = sqrt(norm_sq);
+            res.push_back(norm_r);
+            if (norm_r <= tol)
+            {
+                converged = true;
+                break;
+            }
+        }
+
+        // (t, r), (t, t), P^T t and P^T r, single reduction
+        dot_x[0] = &t;
+        dot_y[0] = &r;
+        dot_x[1] = &t;
+        dot_y[1] = &t;
+        for (int i = 0; i < s; i++)
+        {
+            dot_x[2 + i] = &(P[i]);
+            dot_y[2 + i] = &t;
+            dot_x[2 + s + i] = &(P[i]);
+            dot_y[2 + s + i] = &r;
+        }
+        if (policy->exact())
+        {
+            policy->dot(2*s + 2, dot_x.data(), dot_y.data(), inner.data());
+        }
+        else
+        {
+            policy->dot(2, dot_x.data(), dot_y.data(), inner.data());
+            exact_policy->dot(2*s, &dot_x[2], &dot_y[2], &inner[2]);
+        }
+
+        // omega minimizes ||r - omega*t||, increased if the angle
+        // between t and r is large (maintaining convergence)
+        omega = inner[0] / inner[1];
+        rho = inner[0] / sqrt(inner[1] * norm_sq);
+        if (fabs(rho) < kappa)
+        {
+            omega *= kappa / fabs(rho);
+        }
+
+        // y += omega*r, r -= omega*t, f = P^T r
+        y.axpy(r, omega);
+        r.axpy(t, -omega);
+        for (int i = 0; i < s; i++)
+        {
+            f[i] = inner[2 + s + i] - omega * inner[2 + i];
+        }
+        iter++;
+
+        exact_policy->start(1, &r_ptr, &r_ptr, &norm_sq);
+        pending = true;
+    }
+
+    if (pending)
+    {
+        exact_policy->wait();
+        norm_r = sqrt(norm_sq);
+        res.push_back(norm_r);
+    }
+
+    // x = x0 + M^{-1}y
+    if (ml)
+    {
+        z.set_const_value(0.0);
+        ml->cycle(z, y);
+        x.axpy(z, 1.0);
+    }
+    else
+    {
+        x.axpy(y, 1.0);
+    }
+
+    if (rank == 0)
+    {
+        if (norm_r > tol)
+        {
+            printf("Max Iterations Reached.\n");
+            printf("2 Norm of Residual: %lg\n\n", norm_r);
+        }
+        else
+        {
+            printf("%d Iteration required to converge\n", iter);
+            printf("2 Norm of Residual: %lg\n\n", norm_r);
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef RAPTOR_KRYLOV_PAR_IDR_HPP
+#define RAPTOR_KRYLOV_PAR_IDR_HPP
+
+#include "core/types.hpp"
+#include "core/par_matrix.hpp"
+#include "core/par_vector.hpp"
+#include "multilevel/par_multilevel.hpp"
+#include "krylov/par_reduction.hpp"
+#include <vector>
+
+using namespace raptor;
+
+/**************************************************************
+ *****   IDR(s)
+ **************************************************************
+ ***** Right-preconditioned IDR(s) with biorthogonalization (van
+ ***** Gijzen and Sonneveld), with an optional AMG preconditioner
+ ***** (ml may be NULL).  The shadow space P holds s random 
+ ***** orthonormal vectors, and is generated from global indices so
+ ***** it does not depend on the number of processes.
+ *****
+ ***** Each step reduces P^T g (with the biorthogonalization
+ ***** recovered from these s values) in one reduction, and each
+ ***** dimension reduction step forms (t, r), (t, t) and P^T r
+ ***** together.  The residual norm after each step is reduced
+ ***** with the policy's start/wait, overlapping the
+ ***** preconditioner and SpMV of the following step when policy
+ ***** is a NonblockingReduction.  Inner products are formed 
+ ***** through policy (a FullReduction if NULL).  An approximate
+ ***** policy is only used for (t, r) and (t, t) in the dimension
+ ***** reduction step.
+ *****
+ ***** Each step (one product with A) counts as one iteration, and
+ ***** res holds the residual norm after each iteration.
+ **************************************************************/
+void IDR(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, 
+        aligned_vector<double>& res, int s = 4, double tol = 1e-05, 
+        int max_iter = -1, ReductionPolicy* policy = NULL);
+
+#endif
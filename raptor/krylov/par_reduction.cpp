@@ -0,0 +1,143 @@
+// Copyright (c) 2015, Raptor Developer Team, University of Illinois at Urbana-Champaign
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "krylov/par_reduction.hpp"
+#include "krylov/partial_inner.hpp"
+
+using namespace raptor;
+
+/**************************************************************
+ *****   Full Reduction
+ **************************************************************/
+void FullReduction::start(int n, ParVector** x, ParVector** y, data_t* result)
+{
+    int local_n = x[0]->local_n;
+
+    if (reproducible_reductions)
+    {
+        std::vector<ReproSum> sums(n);
+        for (int j = 0; j < n; j++)
+        {
+            for (int i = 0; i < local_n; i++)
+            {
+                sums[j].add(x[j]->local[i] * y[j]->local[i]);
+            }
+        }
+        repro_allreduce(sums.data(), result, n, x[0]->comm);
+        return;
+    }
+
+    for (int j = 0; j < n; j++)
+    {
+        result[j] = 0.0;
+        if (local_n)
+        {
+            result[j] = x[j]->local.inner_product(y[j]->local);
+        }
+    }
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, result, n, RAPtor_MPI_DATA_T, 
+            RAPtor_MPI_SUM, x[0]->comm);
+}
+
+/**************************************************************
+ *****   Nonblocking Reduction
+ **************************************************************/
+void NonblockingReduction::start(int n, ParVector** x, ParVector** y, data_t* result)
+{
+    int local_n = x[0]->local_n;
+
+    wait();
+    pending = result;
+    num_pending = n;
+
+    if (reproducible_reductions)
+    {
+        sums.resize(n);
+        for (int j = 0; j < n; j++)
+        {
+            sums[j].clear();
+            for (int i = 0; i < local_n; i++)
+            {
+                sums[j].add(x[j]->local[i] * y[j]->local[i]);
+            }
+        }
+        repro_iallreduce(sums.data(), n, x[0]->comm, &request);
+        return;
+    }
+
+    for (int j = 0; j < n; j++)
+    {
+        result[j] = 0.0;
+        if (local_n)
+        {
+            result[j] = x[j]->local.inner_product(y[j]->local);
+        }
+    }
+    RAPtor_MPI_Iallreduce(RAPtor_MPI_IN_PLACE, result, n, RAPtor_MPI_DATA_T, 
+            RAPtor_MPI_SUM, x[0]->comm, &request);
+}
+
+void NonblockingReduction::wait()
+{
+    if (pending == NULL) return;
+
+    RAPtor_MPI_Wait(&request, RAPtor_MPI_STATUS_IGNORE);
+    if (reproducible_reductions)
+    {
+        for (int j = 0; j < num_pending; j++)
+        {
+            pending[j] = sums[j].value();
+        }
+    }
+    pending = NULL;
+}
+
+/**************************************************************
+ *****   Partial Reduction
+ **************************************************************/
+PartialReduction::PartialReduction(ParVector& x, double frac)
+{
+    inner_color = 0;
+    root_color = 0;
+    inner_root = 0;
+    procs_in_group = 1;
+    group = 0;
+    num_groups = 1 / frac;
+    if (num_groups < 1) num_groups = 1;
+
+    create_partial_inner_comm(inner_comm, root_comm, frac, x, inner_color, 
+            root_color, inner_root, procs_in_group, part_global);
+}
+
+PartialReduction::~PartialReduction()
+{
+    if (inner_comm != RAPtor_MPI_COMM_NULL)
+    {
+        RAPtor_MPI_Comm_free(&inner_comm);
+    }
+    if (root_comm != RAPtor_MPI_COMM_NULL)
+    {
+        RAPtor_MPI_Comm_free(&root_comm);
+    }
+}
+
+void PartialReduction::start(int n, ParVector** x, ParVector** y, data_t* result)
+{
+    // Each inner product is computed by the next group of processes
+    for (int j = 0; j < n; j++)
+    {
+        result[j] = partial_inner(inner_comm, root_comm, *(x[j]), *(y[j]), 
+                inner_color, group, inner_root, procs_in_group, part_global);
+        group = (group + 1) % num_groups;
+    }
+}
+
+/**************************************************************
+ *****   Sequential Reduction
+ **************************************************************/
+void SequentialReduction::start(int n, ParVector** x, ParVector** y, data_t* result)
+{
+    for (int j = 0; j < n; j++)
+    {
+        result[j] = sequential_inner(*(x[j]), *(y[j]));
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef RAPTOR_KRYLOV_PAR_REDUCTION_HPP
+#define RAPTOR_KRYLOV_PAR_REDUCTION_HPP
+
+#include "core/types.hpp"
+#include "core/par_vector.hpp"
+#include "core/repro_sum.hpp"
+#include <vector>
+
+using namespace raptor;
+
+/**************************************************************
+ *****   ReductionPolicy Class
+ **************************************************************
+ ***** Determines how the inner products of a Krylov method are
+ ***** reduced across processes.  A solver forms a batch of
+ ***** inner products result[i] = (x[i], y[i]) with start(), may
+ ***** perform independent local work, and calls wait() before
+ ***** reading result.  Only one batch may be outstanding.
+ *****
+ ***** Policies
+ ***** -------------
+ ***** FullReduction : one blocking allreduce per batch
+ *****    (the default when a solver is passed NULL)
+ ***** NonblockingReduction : one Iallreduce per batch, completed
+ *****    in wait(), so it overlaps any work between the two calls
+ ***** PartialReduction : each inner product is approximated from
+ *****    a fraction of the processes (see partial_inner), rotating
+ *****    through the groups of processes
+ ***** SequentialReduction : inner products summed in rank order
+ *****    (see sequential_inner), for reproducibility testing
+ *****
+ ***** Methods
+ ***** -------
+ ***** start(n, x, y, result)
+ *****    Begins result[i] = (x[i], y[i]) for i < n
+ ***** wait()
+ *****    Completes the batch begun by start
+ ***** dot(n, x, y, result)
+ *****    start followed by wait
+ ***** exact()
+ *****    False if results only approximate the inner products, in
+ *****    which case solvers use a full reduction for convergence 
+ *****    checks and for coefficients that must be exact
+ **************************************************************/
+class ReductionPolicy
+{
+    public:
+        virtual ~ReductionPolicy() {}
+
+        virtual void start(int n, ParVector** x, ParVector** y, data_t* result) = 0;
+        virtual void wait() {}
+        virtual bool exact()
+        {
+            return true;
+        }
+
+        void dot(int n, ParVector** x, ParVector** y, data_t* result)
+        {
+            start(n, x, y, result);
+            wait();
+        }
+
+        data_t dot(ParVector& x, ParVector& y)
+        {
+            ParVector* xp = &x;
+            ParVector* yp = &y;
+            data_t result;
+            dot(1, &xp, &yp, &result);
+            return result;
+        }
+};
+
+class FullReduction : public ReductionPolicy
+{
+    public:
+        void start(int n, ParVector** x, ParVector** y, data_t* result);
+};
+
+class NonblockingReduction : public ReductionPolicy
+{
+    public:
+        NonblockingReduction()
+        {
+            pending = NULL;
+        }
+
+        ~NonblockingReduction()
+        {
+            wait();
+        }
+
+        void start(int n, ParVector** x, ParVector** y, data_t* result);
+        void wait();
+
+    private:
+        data_t* pending;
+        int num_pending;
+        std::vector<ReproSum> sums;
+        RAPtor_MPI_Request request;
+};
+
+class PartialReduction : public ReductionPolicy
+{
+    public:
+        // Splits the processes holding x into groups of (about)
+        // frac of the processes
+        PartialReduction(ParVector& x, double frac);
+        ~PartialReduction();
+
+        void start(int n, ParVector** x, ParVector** y, data_t* result);
+        bool exact()
+        {
+            return false;
+        }
+
+    private:
+        RAPtor_MPI_Comm inner_comm;
+        RAPtor_MPI_Comm root_comm;
+        int inner_color;
+        int root_color;
+        int inner_root;
+        int procs_in_group;
+        int part_global;
+        int num_groups;
+        int group;
+};
+
+class SequentialReduction : public ReductionPolicy
+{
+    public:
+        void start(int n, ParVector** x, ParVector** y, data_t* result);
+};
+
+#endif
@@ -0,0 +1,70 @@
+// Copyright (c) 2015, Raptor Developer Team, University of Illinois at Urbana-Champaign
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "krylov/par_refinement.hpp"
+
+using namespace raptor;
+
+void IterativeRefinement(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, 
+        ParVector& b, aligned_vector<double>& res, double tol, 
+        int max_iter, int inner_cycles, double stall_factor)
+{
+    int rank;
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+
+    ParVector r(b.global_n, b.local_n, b.comm);
+    ParVector e(b.global_n, b.local_n, b.comm);
+
+    int iter = 0;
+    double b_norm, r_norm, prev_norm;
+
+    b_norm = b.norm(2);
+    if (b_norm < zero_tol) b_norm = 1.0;
+
+    // r0 = b - A * x0 (double)
+    A->residual(x, b, r);
+    r_norm = r.norm(2) / b_norm;
+    res.emplace_back(r_norm);
+
+    while (r_norm > tol && iter < max_iter)
+    {
+        iter++;
+
+        // Approximately solve A e = r
+        e.set_const_value(0.0);
+        for (int i = 0; i < inner_cycles; i++)
+        {
+            ml->cycle(e, r);
+        }
+
+        // x = x + e, r = b - A * x (double)
+        x.axpy(e, 1.0);
+        A->residual(x, b, r);
+
+        prev_norm = r_norm;
+        r_norm = r.norm(2) / b_norm;
+        res.emplace_back(r_norm);
+
+        // Fall back to a double precision cycle if refinement stalls
+        if (ml->mixed_precision && r_norm > stall_factor * prev_norm)
+        {
+            if (rank == 0)
+            {
+                printf("Refinement stalled, switching to double precision\n");
+            }
+            ml->set_mixed_precision(false);
+        }
+    }
+
+    if (rank == 0)
+    {
+        if (r_norm > tol)
+        {
+            printf("Max Iterations Reached.\n");
+        }
+        else
+        {
+            printf("%d Iteration required to converge\n", iter);
+        }
+        printf("Relative Residual: %lg\n\n", r_norm);
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef RAPTOR_KRYLOV_PAR_REFINEMENT_HPP
+#define RAPTOR_KRYLOV_PAR_REFINEMENT_HPP
+
+#include "core/types.hpp"
+#include "core/par_matrix.hpp"
+#include "core/par_vector.hpp"
+#include "multilevel/par_multilevel.hpp"
+#include <vector>
+
+using namespace raptor;
+
+/**************************************************************
+ *****   Mixed Precision Iterative Refinement
+ **************************************************************
+ ***** Solves Ax = b by iterative refinement.  Each iteration
+ ***** forms r = b - Ax in double, approximately solves Ae = r
+ ***** with inner_cycles V-cycles of ml, and updates x += e in
+ ***** double.  If ml is mixed precision, the inner solves only
+ ***** read single precision values of A and P, while the final
+ ***** solution is accurate to double precision.
+ *****
+ ***** If an iteration reduces the residual by less than
+ ***** stall_factor, ml is switched to double precision
+ ***** (ml->set_mixed_precision(false)) for the remaining
+ ***** iterations.
+ *****
+ ***** Residuals stored in res are relative to the norm of b.
+ **************************************************************/
+void IterativeRefinement(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, 
+        ParVector& b, aligned_vector<double>& res, double tol = 1e-10, 
+        int max_iter = 100, int inner_cycles = 1, double stall_factor = 0.9);
+
+#endif
@@ -0,0 +1,663 @@
+// Copyright (c) 2015, Raptor Developer Team, University of Illinois at Urbana-Champaign
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "krylov/par_sstep.hpp"
+#include "core/repro_sum.hpp"
+#include <numeric>
+#include <algorithm>
+
+using namespace raptor;
+
+ParMatrixPowers::ParMatrixPowers(ParCSRMatrix* _A, int _depth)
+{
+    int n = _A->local_num_rows;
+    int first_col, last_col, col, idx;
+    A = _A;
+    depth = _depth;
+
+    // Local rows with global column indices
+    aligned_vector<int> send_ptr(n + 1);
+    aligned_vector<int> global_cols;
+    aligned_vector<double> values;
+    if (A->local_nnz)
+    {
+        global_cols.reserve(A->local_nnz);
+        values.reserve(A->local_nnz);
+    }
+    send_ptr[0] = 0;
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = A->on_proc->idx1[i]; j < A->on_proc->idx1[i+1]; j++)
+        {
+            global_cols.emplace_back(A->on_proc_column_map[A->on_proc->idx2[j]]);
+            values.emplace_back(A->on_proc->vals[j]);
+        }
+        for (int j = A->off_proc->idx1[i]; j < A->off_proc->idx1[i+1]; j++)
+        {
+            global_cols.emplace_back(A->off_proc_column_map[A->off_proc->idx2[j]]);
+            values.emplace_back(A->off_proc->vals[j]);
+        }
+        send_ptr[i+1] = global_cols.size();
+    }
+
+    // Ghosts one hop away are the off_proc columns of A.  Rows of
+    // ghosts fewer than depth hops away are fetched, level by level,
+    // and their new columns form the next level.
+    first_col = A->partition->first_local_col;
+    last_col = A->partition->last_local_col;
+    aligned_vector<int> level_ghosts = A->off_proc_column_map;
+    aligned_vector<int> all_ghosts = level_ghosts;
+    aligned_vector<int> all_levels(level_ghosts.size(), 1);
+    std::vector<CSRMatrix*> level_rows;
+    std::vector<aligned_vector<int> > level_row_ghosts;
+    for (int level = 1; level < depth && level_ghosts.size(); level++)
+    {
+        ParComm* level_comm = new ParComm(A->partition, level_ghosts,
+                A->on_proc_column_map, A->comm->key, A->comm->mpi_comm);
+        CSRMatrix* rows = level_comm->communicate(send_ptr, global_cols, values);
+        delete level_comm;
+        level_rows.push_back(rows);
+        level_row_ghosts.push_back(level_ghosts);
+
+        IndexMap known(all_ghosts);
+        aligned_vector<int> next_ghosts;
+        for (int j = 0; j < rows->idx1[level_ghosts.size()]; j++)
+        {
+            col = rows->idx2[j];
+            if (col >= first_col && col <= last_col) continue;
+            if (known[col] >= 0) continue;
+            next_ghosts.emplace_back(col);
+        }
+        std::sort(next_ghosts.begin(), next_ghosts.end());
+        next_ghosts.erase(std::unique(next_ghosts.begin(), next_ghosts.end()),
+                next_ghosts.end());
+
+        for (int j = 0; j < (int) next_ghosts.size(); j++)
+        {
+            all_ghosts.emplace_back(next_ghosts[j]);
+            all_levels.emplace_back(level + 1);
+        }
+        level_ghosts.swap(next_ghosts);
+    }
+
+    // Sort ghosts by global index (required by ParComm)
+    int n_ghosts = all_ghosts.size();
+    aligned_vector<int> order(n_ghosts);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](const int i, const int j)
+            {
+                return all_ghosts[i] < all_ghosts[j];
+            });
+    ghost_map.resize(n_ghosts);
+    ghost_level.resize(n_ghosts);
+    for (int i = 0; i < n_ghosts; i++)
+    {
+        ghost_map[i] = all_ghosts[order[i]];
+        ghost_level[i] = all_levels[order[i]];
+    }
+    IndexMap global_to_ghost(ghost_map);
+
+    off_to_ghost.resize(A->off_proc_num_cols);
+    for (int i = 0; i < A->off_proc_num_cols; i++)
+    {
+        off_to_ghost[i] = global_to_ghost[A->off_proc_column_map[i]];
+    }
+
+    // Ghost rows, with columns indexed as local rows followed by ghosts
+    int* part_to_col = A->map_partition_to_local();
+    row_ptr.emplace_back(0);
+    for (int k = 0; k < (int) level_rows.size(); k++)
+    {
+        CSRMatrix* rows = level_rows[k];
+        aligned_vector<int>& ghosts = level_row_ghosts[k];
+        for (int i = 0; i < (int) ghosts.size(); i++)
+        {
+            ghost_rows.emplace_back(global_to_ghost[ghosts[i]]);
+            for (int j = rows->idx1[i]; j < rows->idx1[i+1]; j++)
+            {
+                col = rows->idx2[j];
+                if (col >= first_col && col <= last_col)
+                {
+                    idx = part_to_col[col - first_col];
+                }
+                else
+                {
+                    idx = n + global_to_ghost[col];
+                }
+                row_cols.emplace_back(idx);
+                row_vals.emplace_back(rows->vals[j]);
+            }
+            row_ptr.emplace_back(row_cols.size());
+        }
+        delete rows;
+    }
+    delete[] part_to_col;
+
+    comm = new ParComm(A->partition, ghost_map, A->on_proc_column_map,
+            A->comm->key, A->comm->mpi_comm);
+}
+
+void ParMatrixPowers::mult(std::vector<ParVector>& Y, const aligned_vector<int>& block_ptr)
+{
+    int n = A->local_num_rows;
+    int n_ghosts = ghost_map.size();
+    int num_blocks = block_ptr.size() - 1;
+    int len, max_level, first;
+    double sum;
+
+    // Powers beyond depth require additional exchanges
+    for (int k = 0; k < num_blocks; k++)
+    {
+        len = block_ptr[k+1] - block_ptr[k];
+        if (len - 1 > depth)
+        {
+            for (int b = 0; b < num_blocks; b++)
+            {
+                for (int j = block_ptr[b] + 1; j < block_ptr[b+1]; j++)
+                {
+                    A->mult(Y[j-1], Y[j]);
+                }
+            }
+            return;
+        }
+    }
+
+    // Single exchange of ghost values of the first vector of each block
+    aligned_vector<double> send_vals(n * num_blocks);
+    for (int i = 0; i < n; i++)
+    {
+        for (int k = 0; k < num_blocks; k++)
+        {
+            send_vals[i*num_blocks + k] = Y[block_ptr[k]][i];
+        }
+    }
+    aligned_vector<double>& recv_vals = comm->communicate(send_vals, num_blocks);
+
+    aligned_vector<double> prev(n + n_ghosts);
+    aligned_vector<double> next(n + n_ghosts);
+    for (int k = 0; k < num_blocks; k++)
+    {
+        first = block_ptr[k];
+        len = block_ptr[k+1] - first;
+        for (int i = 0; i < n; i++)
+        {
+            prev[i] = Y[first][i];
+        }
+        for (int i = 0; i < n_ghosts; i++)
+        {
+            prev[n + i] = recv_vals[i*num_blocks + k];
+        }
+
+        for (int j = 1; j < len; j++)
+        {
+            // A^{j-1} y is complete on ghosts within len-j hops, so
+            // A^j y can be formed on ghost rows within len-1-j hops
+            max_level = len - 1 - j;
+            for (int i = 0; i < n; i++)
+            {
+                sum = 0.0;
+                for (int l = A->on_proc->idx1[i]; l < A->on_proc->idx1[i+1]; l++)
+                {
+                    sum += A->on_proc->vals[l] * prev[A->on_proc->idx2[l]];
+                }
+                for (int l = A->off_proc->idx1[i]; l < A->off_proc->idx1[i+1]; l++)
+                {
+                    sum += A->off_proc->vals[l] 
+                        * prev[n + off_to_ghost[A->off_proc->idx2[l]]];
+                }
+                next[i] = sum;
+                Y[first + j][i] = sum;
+            }
+            for (int r = 0; r < (int) ghost_rows.size(); r++)
+            {
+                int g = ghost_rows[r];
+                if (ghost_level[g] > max_level) continue;
+                sum = 0.0;
+                for (int l = row_ptr[r]; l < row_ptr[r+1]; l++)
+                {
+                    sum += row_vals[l] * prev[row_cols[l]];
+                }
+                next[n + g] = sum;
+            }
+            prev.swap(next);
+        }
+    }
+}
+
+/**************************************************************
+ *****   Block Gram Matrix
+ **************************************************************
+ ***** Forms G = Y^T Y, and g = Y^T v if v is not NULL, with a
+ ***** single allreduce.  G is stored row-wise, m x m.
+ **************************************************************/
+void block_gram(std::vector<ParVector>& Y, aligned_vector<double>& G,
+        ParVector* v, aligned_vector<double>& g)
+{
+    int m = Y.size();
+    int n = m * m;
+    int local_n = Y[0].local_n;
+    double val;
+
+    aligned_vector<double> inner(n + (v ? m : 0), 0.0);
+    if (reproducible_reductions)
+    {
+        // Accumulate the upper triangle and Y^T v exactly
+        std::vector<ReproSum> sums(inner.size());
+        for (int i = 0; i < m; i++)
+        {
+            for (int j = i; j < m; j++)
+            {
+                for (int k = 0; k < local_n; k++)
+                {
+                    sums[i*m + j].add(Y[i][k] * Y[j][k]);
+                }
+            }
+            if (v)
+            {
+                for (int k = 0; k < local_n; k++)
+                {
+                    sums[n + i].add(Y[i][k] * (*v)[k]);
+                }
+            }
+        }
+        repro_allreduce(sums.data(), inner.data(), inner.size(), Y[0].comm);
+        for (int i = 0; i < m; i++)
+        {
+            for (int j = i + 1; j < m; j++)
+            {
+                inner[j*m + i] = inner[i*m + j];
+            }
+        }
+    }
+    else
+    {
+        if (local_n)
+        {
+            for (int i = 0; i < m; i++)
+            {
+                for (int j = i; j < m; j++)
+                {
+                    val = Y[i].local.inner_product(Y[j].local);
+                    inner[i*m + j] = val;
+                    inner[j*m + i] = val;
+                }
+                if (v)
+                {
+                    inner[n + i] = Y[i].local.inner_product(v->local);
+                }
+            }
+        }
+        RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, inner.data(), inner.size(),
+                RAPtor_MPI_DATA_T, RAPtor_MPI_SUM, Y[0].comm);
+    }
+
+    G.resize(n);
+    std::copy(inner.begin(), inner.begin() + n, G.begin());
+    if (v)
+    {
+        g.resize(m);
+        std::copy(inner.begin() + n, inner.end(), g.begin());
+    }
+}
+
+/**************************************************************
+ *****   Basis Shift
+ **************************************************************
+ ***** Coordinates of A*Yv in the monomial basis Y, which is
+ ***** formed of blocks [y, Ay, A^2y, ...] starting at block_ptr.
+ ***** The last coordinate of each block must be zero.
+ **************************************************************/
+void basis_shift(const aligned_vector<int>& block_ptr, const aligned_vector<double>& v,
+        aligned_vector<double>& Bv)
+{
+    std::fill(Bv.begin(), Bv.end(), 0.0);
+    for (int k = 0; k < (int) block_ptr.size() - 1; k++)
+    {
+        for (int j = block_ptr[k]; j < block_ptr[k+1] - 1; j++)
+        {
+            Bv[j+1] = v[j];
+        }
+    }
+}
+
+// Returns u^T G v
+double gram_inner(const aligned_vector<double>& G, const aligned_vector<double>& u,
+        const aligned_vector<double>& v)
+{
+    int m = u.size();
+    double result = 0.0;
+    double row_sum;
+    for (int i = 0; i < m; i++)
+    {
+        if (u[i] == 0.0) continue;
+        row_sum = 0.0;
+        for (int j = 0; j < m; j++)
+        {
+            row_sum += G[i*m + j] * v[j];
+        }
+        result += u[i] * row_sum;
+    }
+    return result;
+}
+
+// Returns u^T v
+double coord_inner(const aligned_vector<double>& u, const aligned_vector<double>& v)
+{
+    double result = 0.0;
+    for (int i = 0; i < (int) u.size(); i++)
+    {
+        result += u[i] * v[i];
+    }
+    return result;
+}
+
+/**************************************************************
+ *****   Basis Recovery
+ **************************************************************
+ ***** x += Y*x_c, r = Y*r_c, p = Y*p_c, in a single pass over
+ ***** the local rows
+ **************************************************************/
+void basis_recover(std::vector<ParVector>& Y, ParVector& x, ParVector& r, ParVector& p,
+        const aligned_vector<double>& x_c, const aligned_vector<double>& r_c,
+        const aligned_vector<double>& p_c)
+{
+    int m = Y.size();
+    double x_sum, r_sum, p_sum, y;
+    for (int i = 0; i < x.local_n; i++)
+    {
+        x_sum = 0.0;
+        r_sum = 0.0;
+        p_sum = 0.0;
+        for (int j = 0; j < m; j++)
+        {
+            y = Y[j][i];
+            x_sum += x_c[j] * y;
+            r_sum += r_c[j] * y;
+            p_sum += p_c[j] * y;
+        }
+        x[i] += x_sum;
+        r[i] = r_sum;
+        p[i] = p_sum;
+    }
+}
+
+
+/**************************************************************************************
+ S-Step CG
+ **************************************************************************************/
+void SStep_CG(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double>& res,
+        double tol, int max_iter, int s)
+{
+    int rank;
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+
+    // Basis : [p, Ap, ..., A^s p, r, Ar, ..., A^{s-1} r]
+    int m = 2*s + 1;
+    int r_first = s + 1;
+
+    ParVector r(b.global_n, b.local_n, b.comm);
+    ParVector p(b.global_n, b.local_n, b.comm);
+    std::vector<ParVector> Y(m, ParVector(b.global_n, b.local_n, b.comm));
+
+    aligned_vector<int> block_ptr(3);
+    aligned_vector<double> G;
+    aligned_vector<double> g;
+    aligned_vector<double> x_c(m);
+    aligned_vector<double> r_c(m);
+    aligned_vector<double> p_c(m);
+    aligned_vector<double> Bp_c(m);
+    ParMatrixPowers powers(A, s);
+
+    int iter;
+    data_t alpha, beta;
+    data_t rr_inner, next_inner, App_inner;
+    double norm_r;
+    double b_norm = b.norm(2);
+    if (b_norm < zero_tol) b_norm = 1.0;
+
+    if (max_iter <= 0)
+    {
+        max_iter = ((int)(1.3*b.global_n)) + 2;
+    }
+
+    block_ptr[0] = 0;
+    block_ptr[1] = r_first;
+    block_ptr[2] = m;
+
+    // r0 = b - A * x0, p0 = r0
+    A->residual(x, b, r);
+    p.copy(r);
+
+    rr_inner = r.inner_product(r);
+    norm_r = sqrt(rr_inner);
+    res.emplace_back(norm_r / b_norm);
+
+    if (norm_r != 0.0)
+    {
+        tol = tol * norm_r;
+    }
+
+    iter = 0;
+
+    // Main S-Step CG Loop
+    while (norm_r > tol && iter < max_iter)
+    {
+        // Matrix powers and Gram matrix (single reduction)
+        Y[0].copy(p);
+        Y[r_first].copy(r);
+        powers.mult(Y, block_ptr);
+        block_gram(Y, G, NULL, g);
+
+        std::fill(x_c.begin(), x_c.end(), 0.0);
+        std::fill(r_c.begin(), r_c.end(), 0.0);
+        std::fill(p_c.begin(), p_c.end(), 0.0);
+        r_c[r_first] = 1.0;
+        p_c[0] = 1.0;
+
+        // s iterations of CG on coordinates, with no communication
+        for (int j = 0; j < s && norm_r > tol && iter < max_iter; j++)
+        {
+            // alpha_i = (r_i, r_i) / (A*p_i, p_i)
+            basis_shift(block_ptr, p_c, Bp_c);
+            App_inner = gram_inner(G, p_c, Bp_c);
+            if (App_inner < 0.0)
+            {
+                if (rank == 0)
+                {
+                    printf("Indefinite matrix detected in CG! Aborting...\n");
+                }
+                exit(-1);
+            }
+            alpha = rr_inner / App_inner;
+
+            // x_{i+1} = x_i + alpha_i * p_i, r_{i+1} = r_i - alpha_i * A*p_i
+            for (int k = 0; k < m; k++)
+            {
+                x_c[k] += alpha * p_c[k];
+                r_c[k] -= alpha * Bp_c[k];
+            }
+
+            // beta_i = (r_{i+1}, r_{i+1}) / (r_i, r_i)
+            next_inner = gram_inner(G, r_c, r_c);
+            beta = next_inner / rr_inner;
+
+            // p_{i+1} = r_{i+1} + beta_i * p_i
+            for (int k = 0; k < m; k++)
+            {
+                p_c[k] = r_c[k] + beta * p_c[k];
+            }
+
+            rr_inner = next_inner;
+            norm_r = sqrt(fabs(rr_inner));
+            res.emplace_back(norm_r / b_norm);
+
+            iter++;
+        }
+
+        basis_recover(Y, x, r, p, x_c, r_c, p_c);
+    }
+
+    if (rank == 0)
+    {
+        if (iter == max_iter)
+        {
+            printf("Max Iterations Reached.\n");
+            printf("2 Norm of Residual: %lg\n\n", norm_r);
+        }
+        else
+        {
+            printf("%d Iteration required to converge\n", iter);
+            printf("2 Norm of Residual: %lg\n\n", norm_r);
+        }
+    }
+
+    return;
+}
+
+
+/**************************************************************************************
+ S-Step BiCGStab
+ **************************************************************************************/
+void SStep_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double>& res,
+        double tol, int max_iter, int s)
+{
+    /*           A : ParCSRMatrix for system to solve
+     *           x : ParVector solution to solve for
+     *           b : ParVector rhs of system to solve
+     *         res : vector containing residuals of each iteration
+     *         tol : tolerance for convergence
+     *    max_iter : maximum number of iterations
+     *           s : number of iterations per basis
+     */
+
+    int rank;
+    RAPtor_MPI_Comm_rank(b.comm, &rank);
+
+    // Basis : [p, Ap, ..., A^{2s} p, r, Ar, ..., A^{2s-1} r]
+    int m = 4*s + 1;
+    int r_first = 2*s + 1;
+
+    ParVector r(b.global_n, b.local_n, b.comm);
+    ParVector r_star(b.global_n, b.local_n, b.comm);
+    ParVector p(b.global_n, b.local_n, b.comm);
+    std::vector<ParVector> Y(m, ParVector(b.global_n, b.local_n, b.comm));
+
+    aligned_vector<int> block_ptr(3);
+    aligned_vector<double> G;
+    aligned_vector<double> g;
+    aligned_vector<double> x_c(m);
+    aligned_vector<double> r_c(m);
+    aligned_vector<double> p_c(m);
+    aligned_vector<double> q_c(m);
+    aligned_vector<double> Bp_c(m);
+    aligned_vector<double> Bq_c(m);
+    ParMatrixPowers powers(A, 2*s);
+
+    int iter;
+    data_t alpha, beta, omega;
+    data_t rr_inner, next_inner;
+    double norm_r;
+    double b_norm = b.norm(2);
+    if (b_norm < zero_tol) b_norm = 1.0;
+
+    // Same max iterations definition as pyAMG
+    if (max_iter <= 0)
+    {
+        max_iter = ((int)(1.3*b.global_n)) + 2;
+    }
+
+    block_ptr[0] = 0;
+    block_ptr[1] = r_first;
+    block_ptr[2] = m;
+
+    // r0 = b - A * x0, r* = r0, p0 = r0
+    A->residual(x, b, r);
+    r_star.copy(r);
+    p.copy(r);
+
+    rr_inner = r.inner_product(r_star);
+    norm_r = r.norm(2);
+    res.emplace_back(norm_r / b_norm);
+
+    if (norm_r != 0.0)
+    {
+        tol = tol * norm_r;
+    }
+
+    iter = 0;
+
+    // Main S-Step BiCGStab Loop
+    while (norm_r > tol && iter < max_iter)
+    {
+        // Matrix powers, Gram matrix, and Y^T r* (single reduction)
+        Y[0].copy(p);
+        Y[r_first].copy(r);
+        powers.mult(Y, block_ptr);
+        block_gram(Y, G, &r_star, g);
+
+        std::fill(x_c.begin(), x_c.end(), 0.0);
+        std::fill(r_c.begin(), r_c.end(), 0.0);
+        std::fill(p_c.begin(), p_c.end(), 0.0);
+        r_c[r_first] = 1.0;
+        p_c[0] = 1.0;
+
+        // s iterations of BiCGStab on coordinates, with no communication
+        for (int j = 0; j < s && norm_r > tol && iter < max_iter; j++)
+        {
+            // alpha_i = (r_i, r*) / (Ap_i, r*)
+            basis_shift(block_ptr, p_c, Bp_c);
+            alpha = rr_inner / coord_inner(g, Bp_c);
+
+            // s_i = r_i - alpha_i * Ap_i
+            for (int k = 0; k < m; k++)
+            {
+                q_c[k] = r_c[k] - alpha * Bp_c[k];
+            }
+
+            // omega_i = (As_i, s_i) / (As_i, As_i)
+            basis_shift(block_ptr, q_c, Bq_c);
+            omega = gram_inner(G, Bq_c, q_c) / gram_inner(G, Bq_c, Bq_c);
+
+            // x_{i+1} = x_i + alpha_i * p_i + omega_i * s_i
+            // r_{i+1} = s_i - omega_i * As_i
+            for (int k = 0; k < m; k++)
+            {
+                x_c[k] += alpha * p_c[k] + omega * q_c[k];
+                r_c[k] = q_c[k] - omega * Bq_c[k];
+            }
+
+            // beta_i = (r_{i+1}, r*) / (r_i, r*) * (alpha_i / omega_i)
+            next_inner = coord_inner(g, r_c);
+            beta = (next_inner / rr_inner) * (alpha / omega);
+
+            // p_{i+1} = r_{i+1} + beta_i * (p_i - omega_i * Ap_i)
+            for (int k = 0; k < m; k++)
+            {
+                p_c[k] = r_c[k] + beta * (p_c[k] - omega * Bp_c[k]);
+            }
+
+            rr_inner = next_inner;
+            norm_r = sqrt(fabs(gram_inner(G, r_c, r_c)));
+            res.emplace_back(norm_r / b_norm);
+
+            iter++;
+        }
+
+        basis_recover(Y, x, r, p, x_c, r_c, p_c);
+    }
+
+    if (rank == 0)
+    {
+        if (iter == max_iter)
+        {
+            printf("Max Iterations Reached.\n");
+            printf("2 Norm of Residual: %lg\n\n", norm_r);
+        }
+        else
+        {
+            printf("%d Iteration required to converge\n", iter);
+            printf("2 Norm of Residual: %lg\n\n", norm_r);
+        }
+    }
+
+    return;
+}
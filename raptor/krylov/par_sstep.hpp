@@ -0,0 +1,93 @@
+#ifndef RAPTOR_KRYLOV_PAR_SSTEP_HPP
+#define RAPTOR_KRYLOV_PAR_SSTEP_HPP
+
+#include "core/types.hpp"
+#include "core/par_matrix.hpp"
+#include "core/par_vector.hpp"
+#include <vector>
+
+using namespace raptor;
+
+/**************************************************************
+ *****   S-Step Krylov Methods
+ **************************************************************
+ ***** Communication-avoiding variants of CG and BiCGStab.  Each
+ ***** outer iteration builds a monomial Krylov basis
+ ***** Y = [p, Ap, ..., A^k p, r, Ar, ..., A^l r] and reduces the
+ ***** Gram matrix Y^T Y with a single allreduce.  The following
+ ***** s iterations are then performed on coordinate vectors of
+ ***** length num_cols(Y), without any global communication,
+ ***** replacing 2s (CG) or 4s (BiCGStab) allreduces with one.
+ *****
+ ***** The basis is formed with ParMatrixPowers, with a single
+ ***** halo exchange of depth s (CG) or 2s (BiCGStab) per outer
+ ***** iteration.  As in CG, res holds residual norms relative to
+ ***** the norm of b.
+ *****
+ ***** The monomial basis loses accuracy as s grows, so small
+ ***** values of s (2-5) are recommended.
+ **************************************************************/
+/**************************************************************
+ *****   ParMatrixPowers Class
+ **************************************************************
+ ***** Computes [y, Ay, ..., A^k y] (k <= depth) on the local
+ ***** rows with a single halo exchange of depth k, rather than
+ ***** one exchange per product.  On construction, the rows of A
+ ***** within depth-1 hops of the local rows (ghost rows) are
+ ***** fetched, and a ParComm is formed for the values of all
+ ***** ghosts within depth hops.  Each product A^j y is then
+ ***** formed locally on the local rows and on the ghost rows
+ ***** within k-j hops, for which A^{j-1} y is still complete.
+ *****
+ ***** Attributes
+ ***** -------------
+ ***** depth : int
+ *****    Maximum power formed from a single exchange
+ ***** ghost_map : aligned_vector<int>
+ *****    Sorted global indices of all ghosts
+ ***** ghost_level : aligned_vector<int>
+ *****    Hops from the local rows to each ghost
+ ***** off_to_ghost : aligned_vector<int>
+ *****    Ghost index of each off_proc column of A
+ ***** ghost_rows, row_ptr, row_cols, row_vals
+ *****    Ghost index, and the (local + ghost indexed) entries, of
+ *****    each fetched ghost row
+ *****
+ ***** Methods
+ ***** -------
+ ***** mult(Y, block_ptr)
+ *****    Fills each block Y[block_ptr[k]+1 : block_ptr[k+1]] with
+ *****    powers of A times Y[block_ptr[k]], exchanging the first
+ *****    vector of every block in one message
+ **************************************************************/
+class ParMatrixPowers
+{
+    public:
+        ParMatrixPowers(ParCSRMatrix* A, int depth);
+
+        ~ParMatrixPowers()
+        {
+            delete comm;
+        }
+
+        void mult(std::vector<ParVector>& Y, const aligned_vector<int>& block_ptr);
+
+        ParCSRMatrix* A;
+        int depth;
+        ParComm* comm;
+        aligned_vector<int> ghost_map;
+        aligned_vector<int> ghost_level;
+        aligned_vector<int> off_to_ghost;
+        aligned_vector<int> ghost_rows;
+        aligned_vector<int> row_ptr;
+        aligned_vector<int> row_cols;
+        aligned_vector<double> row_vals;
+};
+
+void SStep_CG(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double>& res,
+        double tol = 1e-05, int max_iter = -1, int s = 4);
+
+void SStep_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double>& res,
+        double tol = 1e-05, int max_iter = -1, int s = 4);
+
+#endif
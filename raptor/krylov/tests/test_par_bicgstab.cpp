@@ -57,3 +57,162 @@ TEST(ParBiCGStabTest, TestsInKrylov)
 
 
 
+
+TEST(ParSStepBiCGStabTest, TestsInKrylov)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    aligned_vector<double> residuals;
+    aligned_vector<double> sstep_residuals;
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    BiCGStab(A, x, b, residuals);
+
+    x.set_const_value(0.0);
+    SStep_BiCGStab(A, x, b, sstep_residuals, 1e-05, -1, 2);
+
+    // Same iterates as BiCGStab in exact arithmetic (S-Step residuals
+    // are relative to b, which is r0 here)
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_NEAR(sstep_residuals[i], residuals[i] / residuals[0], 1e-06);
+    }
+    ASSERT_LT(sstep_residuals.back(), 1e-05);
+
+    delete[] stencil;
+    delete A;
+
+} // end of TEST(ParSStepBiCGStabTest, TestsInKrylov) //
+
+TEST(ParBiCGStabLTest, TestsInKrylov)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    ParVector r(A->global_num_rows, A->local_num_rows);
+    aligned_vector<double> residuals;
+    aligned_vector<double> l_residuals;
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    BiCGStab(A, x, b, residuals);
+
+    // BiCGStab(1) has the same iterates as BiCGStab
+    x.set_const_value(0.0);
+    BiCGStab_l(A, NULL, x, b, l_residuals, 1);
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_NEAR(l_residuals[i] / residuals[0], 
+                residuals[i] / residuals[0], 1e-06);
+    }
+
+    // BiCGStab(2), with full and nonblocking reductions
+    l_residuals.clear();
+    x.set_const_value(0.0);
+    BiCGStab_l(A, NULL, x, b, l_residuals, 2);
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2), 1e-04 * l_residuals[0]);
+
+    aligned_vector<double> nb_residuals;
+    NonblockingReduction nonblocking;
+    x.set_const_value(0.0);
+    BiCGStab_l(A, NULL, x, b, nb_residuals, 2, 1e-05, -1, &nonblocking);
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_NEAR(nb_residuals[i] / l_residuals[0], 
+                l_residuals[i] / l_residuals[0], 1e-06);
+    }
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2), 1e-04 * nb_residuals[0]);
+
+    // Approximate inner products from half of the processes, with
+    // the convergence check still exact
+    aligned_vector<double> pi_residuals;
+    PartialReduction partial(b, 0.5);
+    x.set_const_value(0.0);
+    BiCGStab_l(A, NULL, x, b, pi_residuals, 2, 1e-05, -1, &partial);
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2), 1e-04 * pi_residuals[0]);
+
+    // AMG preconditioned BiCGStab(2)
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, 
+            Classical, SSOR);
+    ml->setup(A);
+    l_residuals.clear();
+    x.set_const_value(0.0);
+    BiCGStab_l(A, ml, x, b, l_residuals, 2, 1e-08);
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2), 1e-07 * l_residuals[0]);
+    ASSERT_LT((int) l_residuals.size(), 20);
+
+    delete ml;
+    delete[] stencil;
+    delete A;
+
+} // end of TEST(ParBiCGStabLTest, TestsInKrylov) //
+
+TEST(ParIDRTest, TestsInKrylov)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    ParVector r(A->global_num_rows, A->local_num_rows);
+    aligned_vector<double> residuals;
+    aligned_vector<double> nb_residuals;
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+
+    x.set_const_value(0.0);
+    IDR(A, NULL, x, b, residuals, 4);
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2), 1e-04 * residuals[0]);
+
+    // Overlapped residual norms give the same history
+    NonblockingReduction nonblocking;
+    x.set_const_value(0.0);
+    IDR(A, NULL, x, b, nb_residuals, 4, 1e-05, -1, &nonblocking);
+    for (int i = 0; i < 20; i++)
+    {
+        ASSERT_NEAR(nb_residuals[i] / residuals[0], 
+                residuals[i] / residuals[0], 1e-06);
+    }
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2), 1e-04 * nb_residuals[0]);
+
+    aligned_vector<double> pi_residuals;
+    PartialReduction partial(b, 0.5);
+    x.set_const_value(0.0);
+    IDR(A, NULL, x, b, pi_residuals, 4, 1e-05, -1, &partial);
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2), 1e-04 * pi_residuals[0]);
+
+    // AMG preconditioned IDR(2)
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, 
+            Classical, SSOR);
+    ml->setup(A);
+    residuals.clear();
+    x.set_const_value(0.0);
+    IDR(A, ml, x, b, residuals, 2, 1e-08);
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2), 1e-07 * residuals[0]);
+    ASSERT_LT((int) residuals.size(), 40);
+
+    delete ml;
+    delete[] stencil;
+    delete A;
+
+} // end of TEST(ParIDRTest, TestsInKrylov) //
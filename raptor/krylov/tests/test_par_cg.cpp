@@ -52,3 +52,196 @@ TEST(ParCGTest, TestsInKrylov)
 
 
 
+
+TEST(ParPCGTest, TestsInKrylov)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    ParVector r(A->global_num_rows, A->local_num_rows);
+
+    // Forward SOR smoothing, so the V-cycle is not a symmetric
+    // preconditioner
+    ParMultilevel* mls[2];
+    mls[0] = new ParRugeStubenSolver();
+    mls[1] = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+
+    for (int k = 0; k < 2; k++)
+    {
+        aligned_vector<double> residuals;
+        mls[k]->setup(A);
+
+        x.set_const_value(1.0);
+        A->mult(x, b);
+        x.set_const_value(0.0);
+        PCG(A, mls[k], x, b, residuals, 1e-10);
+        ASSERT_LT((int) residuals.size(), 30);
+
+        A->residual(x, b, r);
+        ASSERT_LT(r.norm(2) / b.norm(2), 1e-04);
+
+        delete mls[k];
+    }
+
+    delete[] stencil;
+    delete A;
+
+} // end of TEST(ParPCGTest, TestsInKrylov) //
+
+TEST(ParPipelinedPCGTest, TestsInKrylov)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    ParVector r(A->global_num_rows, A->local_num_rows);
+    aligned_vector<double> pipe_residuals;
+
+    // Symmetric smoother, so the V-cycle is an SPD preconditioner
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, 
+            Classical, SSOR);
+    ml->setup(A);
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    PipelinedPCG(A, ml, x, b, pipe_residuals);
+    ASSERT_LT((int) pipe_residuals.size(), 30);
+    ASSERT_LT(pipe_residuals.back(), 1e-05);
+
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2) / b.norm(2), 1e-04);
+
+    delete ml;
+    delete[] stencil;
+    delete A;
+
+} // end of TEST(ParPipelinedPCGTest, TestsInKrylov) //
+
+TEST(ParSStepCGTest, TestsInKrylov)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    aligned_vector<double> residuals;
+    aligned_vector<double> sstep_residuals;
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    CG(A, x, b, residuals);
+
+    x.set_const_value(0.0);
+    SStep_CG(A, x, b, sstep_residuals, 1e-05, -1, 4);
+
+    // Same iterates as CG in exact arithmetic
+    for (int i = 0; i < 20; i++)
+    {
+        ASSERT_NEAR(sstep_residuals[i], residuals[i], 1e-06);
+    }
+    ASSERT_LT(sstep_residuals.back(), 1e-05);
+    ASSERT_LE(sstep_residuals.size(), residuals.size() + 10);
+
+    delete[] stencil;
+    delete A;
+
+} // end of TEST(ParSStepCGTest, TestsInKrylov) //
+
+TEST(ParCGSubcommTest, TestsInKrylov)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    // Independent systems of different sizes on two halves of WORLD
+    int color = (num_procs > 1) ? rank % 2 : 0;
+    RAPtor_MPI_Comm sub_comm;
+    RAPtor_MPI_Comm_split(RAPtor_MPI_COMM_WORLD, color, rank, &sub_comm);
+
+    int n = 100 + 20*color;
+    Topology* topology = new Topology(16, 1, sub_comm);
+    Partition* part = new Partition(n, n, topology);
+    ParCSRMatrix* A = new ParCSRMatrix(part, 3*part->local_num_rows);
+    A->on_proc->idx1[0] = 0;
+    A->off_proc->idx1[0] = 0;
+    for (int i = 0; i < part->local_num_rows; i++)
+    {
+        int row = part->first_local_row + i;
+        if (row > 0) A->add_value(i, row - 1, -1.0);
+        A->add_value(i, row, 2.0);
+        if (row < n - 1) A->add_value(i, row + 1, -1.0);
+        A->on_proc->idx1[i+1] = A->on_proc->idx2.size();
+        A->off_proc->idx1[i+1] = A->off_proc->idx2.size();
+    }
+    A->on_proc->nnz = A->on_proc->idx2.size();
+    A->off_proc->nnz = A->off_proc->idx2.size();
+    A->finalize();
+
+    ParVector x(A->global_num_rows, A->local_num_rows, sub_comm);
+    ParVector b(A->global_num_rows, A->local_num_rows, sub_comm);
+    aligned_vector<double> residuals;
+
+    // A*1 is nonzero only in the first and last rows of each system
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    ASSERT_NEAR(b.norm(2), sqrt(2.0), 1e-12);
+
+    x.set_const_value(0.0);
+    CG(A, x, b, residuals, 1e-10, n);
+    ASSERT_LT(residuals.back(), 1e-10);
+    for (int i = 0; i < x.local_n; i++)
+    {
+        ASSERT_NEAR(x[i], 1.0, 1e-06);
+    }
+
+    delete A;
+    delete part;
+    delete topology;
+    RAPtor_MPI_Comm_free(&sub_comm);
+
+} // end of TEST(ParCGSubcommTest, TestsInKrylov) //
+
+TEST(ParMatrixPowersTest, TestsInKrylov)
+{
+    int grid[2] = {20, 20};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    // Blocks [y, Ay, ..., A^3 y] and [z, Az, A^2 z]
+    aligned_vector<int> block_ptr(3);
+    block_ptr[0] = 0;
+    block_ptr[1] = 4;
+    block_ptr[2] = 7;
+    std::vector<ParVector> Y(7, ParVector(A->global_num_rows, A->local_num_rows));
+    ParVector tmp(A->global_num_rows, A->local_num_rows);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        Y[0][i] = 1.0 + (A->local_row_map[i] % 7);
+        Y[4][i] = 1.0 / (1.0 + A->local_row_map[i]);
+    }
+
+    ParMatrixPowers powers(A, 3);
+    powers.mult(Y, block_ptr);
+
+    // Same as one SpMV (and exchange) per power
+    for (int k = 0; k < 2; k++)
+    {
+        for (int j = block_ptr[k] + 1; j < block_ptr[k+1]; j++)
+        {
+            A->mult(Y[j-1], tmp);
+            for (int i = 0; i < A->local_num_rows; i++)
+            {
+                ASSERT_NEAR(Y[j][i], tmp[i], 1e-10 * fabs(tmp[i]) + 1e-12);
+            }
+        }
+    }
+
+    delete A;
+
+} // end of TEST(ParMatrixPowersTest, TestsInKrylov) //
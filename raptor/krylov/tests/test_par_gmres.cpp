@@ -0,0 +1,75 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+TEST(ParGMRESTest, TestsInKrylov)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(1.0);
+
+    // Add upwinded convection in x, so A is non-symmetric
+    stencil[3] -= 1.0;
+    stencil[4] += 1.0;
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    ParVector r(A->global_num_rows, A->local_num_rows);
+    aligned_vector<double> residuals;
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    double b_norm = b.norm(2);
+
+    // Unpreconditioned GMRES(30)
+    x.set_const_value(0.0);
+    GMRES(A, NULL, x, b, residuals, 1e-06, 1000, 30);
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2) / b_norm, 1e-05);
+    for (int i = 1; i < (int) residuals.size(); i++)
+    {
+        ASSERT_LE(residuals[i], residuals[i-1] * (1.0 + 1e-10));
+    }
+
+    // AMG preconditioned GMRES and FGMRES
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended);
+    ml->setup(A);
+
+    residuals.clear();
+    x.set_const_value(0.0);
+    GMRES(A, ml, x, b, residuals, 1e-06, 100, 10);
+    A->residual(x, b, r);
+    ASSERT_LT((int) residuals.size(), 20);
+    ASSERT_LT(r.norm(2) / b_norm, 1e-05);
+
+    aligned_vector<double> f_residuals;
+    x.set_const_value(0.0);
+    FGMRES(A, ml, x, b, f_residuals, 1e-06, 100, 10);
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2) / b_norm, 1e-05);
+
+    // Fixed preconditioner, so FGMRES matches GMRES
+    ASSERT_EQ(f_residuals.size(), residuals.size());
+    for (int i = 0; i < (int) residuals.size(); i++)
+    {
+        ASSERT_NEAR(f_residuals[i], residuals[i], 1e-08);
+    }
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParGMRESTest, TestsInKrylov) //
@@ -0,0 +1,58 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+TEST(ParRefinementTest, TestsInKrylov)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    ParVector r(A->global_num_rows, A->local_num_rows);
+    aligned_vector<double> residuals;
+
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, 
+            Classical, SOR);
+    ml->mixed_precision = true;
+    ml->setup(A);
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+
+    // Single precision cycles, refined to double precision accuracy
+    IterativeRefinement(A, ml, x, b, residuals, 1e-12, 100, 2);
+    ASSERT_LT(residuals.back(), 1e-12);
+    ASSERT_TRUE(ml->mixed_precision);
+
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2) / b.norm(2), 1e-12);
+
+    // A stall factor no iteration can satisfy forces the fallback
+    // to double precision after the first iteration
+    residuals.clear();
+    x.set_const_value(0.0);
+    IterativeRefinement(A, ml, x, b, residuals, 1e-12, 100, 2, 0.0);
+    ASSERT_LT(residuals.back(), 1e-12);
+    ASSERT_FALSE(ml->mixed_precision);
+    ASSERT_TRUE(ml->levels[0]->A_sp == NULL);
+
+    delete ml;
+    delete[] stencil;
+    delete A;
+
+} // end of TEST(ParRefinementTest, TestsInKrylov) //
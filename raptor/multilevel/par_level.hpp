@@ -6,6 +6,8 @@
 #include "core/types.hpp"
 #include "core/par_matrix.hpp"
 #include "core/par_vector.hpp"
+#include "core/par_sp_matrix.hpp"
+#include "util/linalg/par_relax.hpp"
 
 // Coarse Matrices (A) are CSR
 // Prolongation Matrices (P) are CSR
@@ -21,6 +23,10 @@ namespace raptor
                 P = NULL;
                 AP = NULL;
                 I = NULL;
+                A_sp = NULL;
+                P_sp = NULL;
+                galerkin_nnz = 0;
+                sparsify_time = 0.0;
             }
 
             ~ParLevel()
@@ -30,6 +36,9 @@ namespace raptor
 
                 delete AP;
                 delete I;
+
+                delete A_sp;
+                delete P_sp;
             }
 
             ParCSRMatrix* A;
@@ -38,8 +47,25 @@ namespace raptor
             ParVector b;
             ParVector tmp;
 
+            // Relaxation data (inverse diagonal, eigenvalue
+            // estimate, colors) formed once during setup
+            ParSmootherData smoother_data;
+
+            // Single precision values of A and P, used by the cycle
+            // when the hierarchy is mixed precision (otherwise NULL)
+            ParSPMatrix* A_sp;
+            ParSPMatrix* P_sp;
+
             ParCSRMatrix* AP;
+
+            // Injection from the coarse points, used to sparsify the
+            // next coarse operator (otherwise NULL)
             ParCSRMatrix* I;
+
+            // Local nnz of the Galerkin operator and time spent
+            // sparsifying it, if A is non-Galerkin
+            long galerkin_nnz;
+            double sparsify_time;
     };
 }
 #endif
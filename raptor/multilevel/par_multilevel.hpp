@@ -6,10 +6,12 @@
 #include "core/types.hpp"
 #include "core/par_matrix.hpp"
 #include "core/par_vector.hpp"
+#include "core/repro_sum.hpp"
 #include "multilevel/par_level.hpp"
 #include "util/linalg/par_relax.hpp"
 #include "ruge_stuben/par_interpolation.hpp"
 #include "ruge_stuben/par_cf_splitting.hpp"
+#include "multilevel/par_sparsify.hpp"
 
 #ifdef USING_HYPRE
 #include "_hypre_utilities.h"
@@ -47,21 +49,86 @@
  *****      - Jacobi: weighted jacobi for both on and off proc
  *****      - SOR: weighted jacobi off_proc, SOR on_proc
  *****      - SSOR : weighted jacobi off_proc, SSOR on_proc
+ *****      - Chebyshev : chebyshev polynomial in D^{-1}A
+ *****      - L1Jacobi : jacobi scaled by l1 norm of each row
+ *****      - L1SOR : SOR scaled by diagonal plus l1 norm of off_proc
+ *****      - L1SSOR : SSOR scaled by diagonal plus l1 norm of off_proc
+ *****      - MulticolorSSOR : weighted jacobi off_proc, SSOR on_proc
+ *****        with rows visited by color, so each color is updated 
+ *****        in parallel
  ***** num_smooth_sweeps : int (defualt 1)
  *****    Number of relaxation sweeps (both pre and post smoothing)
  *****    to be performed during each cycle of the AMG solve.
  ***** relax_weight : double
- *****    Weight used in Jacobi, SOR, or SSOR
+ *****    Weight used in Jacobi, SOR, or SSOR (and l1 variants)
+ ***** cheby_degree : int (default 2)
+ *****    Degree of polynomial applied in each Chebyshev sweep
+ ***** cheby_fraction : double (default 0.3)
+ *****    Chebyshev smooths eigenvalues in [cheby_fraction*max_eig, max_eig]
  ***** max_coarse : int (default 50)
  *****    Maximum global num rows allowed in coarsest matrix
  ***** max_levels : int (default -1)
  *****    Maximum number of levels in hierarchy, or no maximum if -1
+ ***** reuse_interp : bool (default false)
+ *****    If true, calling setup on a matrix with the same dimensions
+ *****    and on_proc columns as the existing hierarchy keeps the strength, splitting, and
+ *****    interpolation of every level, and only refreshes the fine
+ *****    matrix and Galerkin coarse operators with the new values
+ ***** galerkin_interval : int (default 1)
+ *****    When reusing interpolation, coarse operators are recomputed
+ *****    on every galerkin_interval-th reused setup, and kept from
+ *****    the previous setup otherwise
+ ***** reuse_max_conv_factor : double (default 0.5)
+ *****    A full setup is performed instead of reusing interpolation
+ *****    if the average convergence factor of the last solve exceeds
+ *****    this threshold, or if no solve has run since the last setup
+ *****    (e.g. the hierarchy is only used through cycle, as a
+ *****    preconditioner)
+ ***** mixed_precision : bool (default false)
+ *****    If true, single precision copies of the values of A and P
+ *****    are formed on each level during setup, and are used for
+ *****    relaxation, residuals, restriction and interpolation in the
+ *****    cycle.  Vectors, the coarse solve, and any outer Krylov 
+ *****    method remain double precision.  Use set_mixed_precision
+ *****    to switch an existing hierarchy.
+ ***** residual_interval : int (default 1)
+ *****    Residual norm is computed (and convergence checked) every
+ *****    residual_interval cycles, and on the last iteration.  Must
+ *****    be at least 1 : smaller values are treated as 1.
+ ***** residual_from_cycle : bool (default false)
+ *****    If true, the norm of the fine level residual formed within
+ *****    each cycle (after pre-relaxation) is used in place of an
+ *****    extra residual after the cycle.  This norm lags the iterate
+ *****    by one cycle, so the returned solution is at least one
+ *****    cycle more accurate than the recorded norm.
+ ***** lagged_residual : bool (default false)
+ *****    If true, the residual norm is reduced with a nonblocking
+ *****    allreduce, which is overlapped with the next cycle and
+ *****    checked one cycle late.
+ *****    With any of the three options above, residuals[i] holds the
+ *****    most recent norm available after cycle i.
+ ***** sparsify_tol : double (default 0.0)
+ *****    If positive, coarse operators on levels sparsify_start and
+ *****    below are non-Galerkin : entries outside the minimal
+ *****    pattern P^T A I + I^T A P (I injection from the coarse
+ *****    points) and smaller than sparsify_tol times the largest
+ *****    off-diagonal of their row are lumped to the diagonal.  Only
+ *****    used by solvers forming I (Ruge-Stuben).
+ ***** sparsify_start : int (default 1)
+ *****    First coarse level sparsified with sparsify_tol
+ ***** level_sparsify_tols : aligned_vector<double> (default empty)
+ *****    Per level tolerances : level_sparsify_tols[l] (zero for a
+ *****    Galerkin operator) overrides the above for coarse level l
  ***** 
  ***** Methods
  ***** -------
  ***** solve(x, b, num_iters)
  *****    Solves system Ax = b, performing at most num_iters iterations
  *****    of AMG.
+ ***** clear_hierarchy()
+ *****    Deletes all levels, so the next setup forms a new hierarchy
+ ***** set_mixed_precision(bool)
+ *****    Switches the cycle between single and double precision A, P
  **************************************************************/
 
 namespace raptor
@@ -86,6 +153,8 @@ namespace raptor
                 relax_type = _relax_type;
                 num_smooth_sweeps = 1;
                 relax_weight = 1.0;
+                cheby_degree = 2;
+                cheby_fraction = 0.3;
                 max_coarse = 50;
                 max_levels = 25;
                 tap_amg = -1;
@@ -95,11 +164,29 @@ namespace raptor
                 setup_times = NULL;
                 solve_times = NULL;
                 sparsify_tol = 0.0;
+                sparsify_start = 1;
                 solve_tol = 1e-07;
                 max_iterations = 100;
+                reuse_interp = false;
+                galerkin_interval = 1;
+                reuse_max_conv_factor = 0.5;
+                reuse_count = 0;
+                conv_factor = -1.0;
+                mixed_precision = false;
+                residual_interval = 1;
+                residual_from_cycle = false;
+                lagged_residual = false;
+                cycle_resid_sq = 0.0;
             }
 
             virtual ~ParMultilevel()
+            {
+                clear_hierarchy();
+
+                delete[] weights;
+            }
+
+            void clear_hierarchy()
             {
                 if (num_levels > 0)
                 {
@@ -114,11 +201,16 @@ namespace raptor
                 {
                     delete *it;
                 }
-
-                delete[] weights;
+                levels.clear();
+                num_levels = 0;
 
                 delete[] setup_times;
                 delete[] solve_times;
+                setup_times = NULL;
+                solve_times = NULL;
+
+                reuse_count = 0;
+                conv_factor = -1.0;
             }
             
             virtual void setup(ParCSRMatrix* Af) = 0;
@@ -126,10 +218,26 @@ namespace raptor
             void setup_helper(ParCSRMatrix* Af)
             {
                 int rank, num_procs;
-                RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-                RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+                RAPtor_MPI_Comm_rank(Af->partition->topology->comm, &rank);
+                RAPtor_MPI_Comm_size(Af->partition->topology->comm, &num_procs);
                 int last_level = 0;
 
+                // Keep interpolation of existing hierarchy unless the
+                // last solve converged too slowly (conv_factor is negative
+                // until a solve has measured it)
+                if (reuse_interp && num_levels > 0 
+                        && conv_factor >= 0.0
+                        && conv_factor <= reuse_max_conv_factor
+                        && Af->global_num_rows == levels[0]->A->global_num_rows
+                        && Af->local_num_rows == levels[0]->A->local_num_rows
+                        && Af->on_proc_column_map == levels[0]->A->on_proc_column_map)
+                {
+                    reuse_setup(Af);
+                    conv_factor = -1.0;
+                    return;
+                }
+                clear_hierarchy();
+
                 if (track_times)
                 {
                     setup_times = new double[5 * max_levels]();
@@ -138,29 +246,13 @@ namespace raptor
 
                 // Add original, fine level to hierarchy
                 levels.emplace_back(new ParLevel());
-                levels[0]->A = Af->copy();
-                levels[0]->A->sort();
-                levels[0]->A->on_proc->move_diag();
-                levels[0]->x.resize(Af->global_num_rows, Af->local_num_rows);
-                levels[0]->b.resize(Af->global_num_rows, Af->local_num_rows);
-                levels[0]->tmp.resize(Af->global_num_rows, Af->local_num_rows);
-                if (tap_amg == 0)
-                {
-                    if (!Af->tap_comm && !Af->tap_mat_comm)
-                    {
-                        levels[0]->A->init_tap_communicators();
-                    }
-                    else if (!Af->tap_comm) // 3-step NAPComm
-                    {
-                        levels[0]->A->tap_comm = new TAPComm(Af->partition,
-                                Af->off_proc_column_map, Af->on_proc_column_map);
-                    }
-                    else if (!Af->tap_mat_comm) // 2-step NAPComm
-                    {
-                        levels[0]->A->tap_mat_comm = new TAPComm(Af->partition,
-                                Af->off_proc_column_map, Af->on_proc_column_map, false);
-                    }
-                }
+                form_fine_matrix(Af);
+                levels[0]->x.resize(Af->global_num_rows, Af->local_num_rows,
+                    Af->partition->topology->comm);
+                levels[0]->b.resize(Af->global_num_rows, Af->local_num_rows,
+                    Af->partition->topology->comm);
+                levels[0]->tmp.resize(Af->global_num_rows, Af->local_num_rows,
+                    Af->partition->topology->comm);
 
                 if (weights == NULL)
                 {
@@ -194,6 +286,17 @@ namespace raptor
                     weights = NULL;
                 }
 
+                // Form relaxation data (inverse diagonal, eigenvalue
+                // estimate, colors) once on each smoothed level, so each
+                // sweep during the solve is a single pass over A
+                for (int i = 0; i < num_levels - 1; i++)
+                {
+                    bool tap_level = tap_amg >= 0 && tap_amg <= i;
+                    levels[i]->smoother_data.setup(levels[i]->A, relax_type,
+                            tap_level);
+                    form_single_precision(i);
+                }
+
                 // Duplicate coarsest level across all processes that hold any
                 // rows of A_c
                 duplicate_coarse();
@@ -211,6 +314,210 @@ namespace raptor
                 }
             } 
 
+            /**************************************************************
+             *****   Sparsify Coarse Operator
+             **************************************************************
+             ***** Sparsifies the coarse operator Ac = P^T (AP) formed from
+             ***** level, if the tolerance of the coarse level is positive
+             ***** and the injection I has been formed on level.  Ac must
+             ***** not yet have communicators.
+             **************************************************************/
+            double get_sparsify_tol(int level)
+            {
+                if (level < (int) level_sparsify_tols.size())
+                    return level_sparsify_tols[level];
+                if (level < sparsify_start)
+                    return 0.0;
+                return sparsify_tol;
+            }
+
+            void sparsify_coarse(int level, ParCSRMatrix* AP, ParCSRMatrix* Ac)
+            {
+                double tol = get_sparsify_tol(level + 1);
+                if (tol <= 0 || levels[level]->I == NULL) return;
+
+                ParLevel* coarse = levels[level + 1];
+                double t0 = RAPtor_MPI_Wtime();
+                coarse->galerkin_nnz = Ac->local_nnz;
+                sparsify(levels[level]->A, levels[level]->P, levels[level]->I,
+                        AP, Ac, tol);
+                coarse->sparsify_time = RAPtor_MPI_Wtime() - t0;
+            }
+
+            void form_fine_matrix(ParCSRMatrix* Af)
+            {
+                levels[0]->A = Af->copy();
+                levels[0]->A->sort();
+                levels[0]->A->on_proc->move_diag();
+                if (tap_amg == 0)
+                {
+                    if (!Af->tap_comm && !Af->tap_mat_comm)
+                    {
+                        levels[0]->A->init_tap_communicators();
+                    }
+                    else if (!Af->tap_comm) // 3-step NAPComm
+                    {
+                        levels[0]->A->tap_comm = new TAPComm(Af->partition,
+                                Af->off_proc_column_map, Af->on_proc_column_map);
+                    }
+                    else if (!Af->tap_mat_comm) // 2-step NAPComm
+                    {
+                        levels[0]->A->tap_mat_comm = new TAPComm(Af->partition,
+                                Af->off_proc_column_map, Af->on_proc_column_map, false);
+                    }
+                }
+            }
+
+            /**************************************************************
+             *****   Reuse Setup
+             **************************************************************
+             ***** Replaces the fine matrix of the existing hierarchy with
+             ***** Af, keeping P on every level.  Coarse operators are
+             ***** recomputed as P^T A P on every galerkin_interval-th
+             ***** call, reusing the communication packages of the previous
+             ***** coarse matrices when the sparsity pattern is unchanged.
+             *****
+             ***** Parameters
+             ***** -------------
+             ***** Af : ParCSRMatrix*
+             *****    New fine-level matrix, of the same dimensions, partition
+             *****    and on_proc columns as the existing fine-level matrix
+             **************************************************************/
+            void reuse_setup(ParCSRMatrix* Af)
+            {
+                int last_level = num_levels - 1;
+                bool refresh_coarse;
+
+                reuse_count++;
+                refresh_coarse = galerkin_interval > 0 
+                    && reuse_count % galerkin_interval == 0;
+
+                if (setup_times)
+                {
+                    init_profile();
+                }
+
+                // The coarsest matrix is factored after this, so free
+                // the communicator holding it
+                if (refresh_coarse || num_levels == 1)
+                {
+                    if (levels[last_level]->A->local_num_rows)
+                    {
+                        RAPtor_MPI_Comm_free(&coarse_comm);
+                    }
+                }
+
+                delete levels[0]->A;
+                form_fine_matrix(Af);
+
+                if (refresh_coarse)
+                {
+                    for (int i = 0; i < last_level; i++)
+                    {
+                        bool tap_level = tap_amg >= 0 && tap_amg <= i;
+                        ParCSRMatrix* A = levels[i]->A;
+                        ParCSRMatrix* P = levels[i]->P;
+                        ParCSRMatrix* A_old = levels[i+1]->A;
+
+                        ParCSRMatrix* AP = A->mult(P, tap_level);
+                        ParCSRMatrix* Ac = AP->mult_T(P, tap_level);
+
+                        Ac->sort();
+                        Ac->on_proc->move_diag();
+                        sparsify_coarse(i, AP, Ac);
+                        delete AP;
+
+                        if (Ac->on_proc_column_map == A_old->on_proc_column_map
+                                && Ac->off_proc_column_map == A_old->off_proc_column_map)
+                        {
+                            Ac->comm = A_old->comm;
+                            Ac->tap_comm = A_old->tap_comm;
+                            Ac->tap_mat_comm = A_old->tap_mat_comm;
+                            A_old->comm = NULL;
+                            A_old->tap_comm = NULL;
+                            A_old->tap_mat_comm = NULL;
+                        }
+                        else
+                        {
+                            Ac->comm = new ParComm(Ac->partition, 
+                                    Ac->off_proc_column_map, Ac->on_proc_column_map, 
+                                    A->comm->key, A->comm->mpi_comm);
+                            if (tap_amg >= 0 && tap_amg <= i+1)
+                            {
+                                Ac->init_tap_communicators(Ac->partition->topology->comm);
+                            }
+                        }
+
+                        delete A_old;
+                        levels[i+1]->A = Ac;
+                    }
+                }
+
+                // Refresh relaxation data on levels with new matrices
+                for (int i = 0; i < last_level; i++)
+                {
+                    if (i > 0 && !refresh_coarse) break;
+                    bool tap_level = tap_amg >= 0 && tap_amg <= i;
+                    levels[i]->smoother_data.setup(levels[i]->A, relax_type,
+                            tap_level);
+                    form_single_precision(i);
+                }
+
+                if (refresh_coarse || num_levels == 1)
+                {
+                    duplicate_coarse();
+                }
+
+                if (setup_times)
+                {
+                    finalize_profile();
+                    setup_times[0] += total_t;
+                    setup_times[1] += collective_t;
+                    setup_times[2] += p2p_t;
+                    setup_times[3] += vec_t;
+                    setup_times[4] += mat_t;
+                }
+            }
+
+
+            /**************************************************************
+             *****   Form Single Precision Level
+             **************************************************************
+             ***** Copies the values of A and P on level to single
+             ***** precision if mixed_precision is set.  Must be called
+             ***** after the smoother data is formed, as this reorders
+             ***** the values of A.
+             **************************************************************/
+            void form_single_precision(int level)
+            {
+                ParLevel* l = levels[level];
+
+                delete l->A_sp;
+                delete l->P_sp;
+                l->A_sp = NULL;
+                l->P_sp = NULL;
+
+                if (!mixed_precision) return;
+
+                l->A_sp = new ParSPMatrix(l->A);
+                l->P_sp = new ParSPMatrix(l->P);
+            }
+
+            /**************************************************************
+             *****   Set Mixed Precision
+             **************************************************************
+             ***** Switches the cycle of an existing hierarchy between
+             ***** single and double precision values of A and P, 
+             ***** without repeating setup.
+             **************************************************************/
+            void set_mixed_precision(bool _mixed_precision)
+            {
+                mixed_precision = _mixed_precision;
+                for (int i = 0; i < num_levels - 1; i++)
+                {
+                    form_single_precision(i);
+                }
+            }
 
             void form_rand_weights(int local_n, int first_n)
             {
@@ -228,16 +535,18 @@ namespace raptor
 
             void duplicate_coarse()
             {
-                int rank, num_procs;
-                RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-                RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
-
                 int last_level = num_levels - 1;
                 ParCSRMatrix* Ac = levels[last_level]->A;
+                RAPtor_MPI_Comm comm = Ac->partition->topology->comm;
+
+                int rank, num_procs;
+                RAPtor_MPI_Comm_rank(comm, &rank);
+                RAPtor_MPI_Comm_size(comm, &num_procs);
+
                 aligned_vector<int> proc_sizes(num_procs);
                 aligned_vector<int> active_procs;
                 RAPtor_MPI_Allgather(&(Ac->local_num_rows), 1, RAPtor_MPI_INT, proc_sizes.data(),
-                        1, RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+                        1, RAPtor_MPI_INT, comm);
                 for (int i = 0; i < num_procs; i++)
                 {
                     if (proc_sizes[i])
@@ -245,13 +554,13 @@ namespace raptor
                         active_procs.emplace_back(i);
                     }
                 }
-                RAPtor_MPI_Group world_group;
-                RAPtor_MPI_Comm_group(RAPtor_MPI_COMM_WORLD, &world_group);                
+                RAPtor_MPI_Group comm_group;
+                RAPtor_MPI_Comm_group(comm, &comm_group);
                 RAPtor_MPI_Group active_group;
-                RAPtor_MPI_Group_incl(world_group, active_procs.size(), active_procs.data(),
+                RAPtor_MPI_Group_incl(comm_group, active_procs.size(), active_procs.data(),
                         &active_group);
-                RAPtor_MPI_Comm_create_group(RAPtor_MPI_COMM_WORLD, active_group, 0, &coarse_comm);
-                RAPtor_MPI_Group_free(&world_group);
+                RAPtor_MPI_Comm_create_group(comm, active_group, 0, &coarse_comm);
+                RAPtor_MPI_Group_free(&comm_group);
                 RAPtor_MPI_Group_free(&active_group);
 
                 if (Ac->local_num_rows)
@@ -283,13 +592,7 @@ namespace raptor
                             global_row_indices.data(), coarse_sizes.data(), 
                             coarse_displs.data(), RAPtor_MPI_INT, coarse_comm);
     
-                    std::map<int, int> global_to_local;
-                    int ctr = 0;
-                    for (aligned_vector<int>::iterator it = global_row_indices.begin();
-                            it != global_row_indices.end(); ++it)
-                    {
-                        global_to_local[*it] = ctr++;
-                    }
+                    IndexMap global_to_local(global_row_indices);
 
                     coarse_n = Ac->global_num_rows;
                     A_coarse_lcl.resize(coarse_n*Ac->local_num_rows, 0);
@@ -300,7 +603,7 @@ namespace raptor
                         for (int j = start; j < end; j++)
                         {
                             global_col = Ac->on_proc_column_map[Ac->on_proc->idx2[j]];
-                            local_col = global_to_local[global_col];
+                            local_col = global_to_local.find(global_col);
                             A_coarse_lcl[i*coarse_n + local_col] = Ac->on_proc->vals[j];
                         }
 
@@ -309,7 +612,7 @@ namespace raptor
                         for (int j = start; j < end; j++)
                         {
                             global_col = Ac->off_proc_column_map[Ac->off_proc->idx2[j]];
-                            local_col = global_to_local[global_col];
+                            local_col = global_to_local.find(global_col);
                             A_coarse_lcl[i*coarse_n + local_col] = Ac->off_proc->vals[j];
                         }
                     }
@@ -338,6 +641,54 @@ namespace raptor
                 }
             }
 
+            void relax(int level, ParVector& x, ParVector& b)
+            {
+                if (levels[level]->A_sp)
+                {
+                    relax_helper(levels[level]->A_sp, level, x, b);
+                }
+                else
+                {
+                    relax_helper(levels[level]->A, level, x, b);
+                }
+            }
+
+            // A is either the ParCSRMatrix or the ParSPMatrix of level
+            template <typename MatrixType>
+            void relax_helper(MatrixType* A, int level, ParVector& x, ParVector& b)
+            {
+                ParVector& tmp = levels[level]->tmp;
+                ParSmootherData& data = levels[level]->smoother_data;
+                bool tap_level = tap_amg >= 0 && tap_amg <= level;
+
+                switch (relax_type)
+                {
+                    case Jacobi:
+                    case L1Jacobi:
+                        jacobi(A, x, b, tmp, data, num_smooth_sweeps,
+                                relax_weight, tap_level);
+                        break;
+                    case SOR:
+                    case L1SOR:
+                        sor(A, x, b, tmp, data, num_smooth_sweeps,
+                                relax_weight, tap_level);
+                        break;
+                    case SSOR:
+                    case L1SSOR:
+                        ssor(A, x, b, tmp, data, num_smooth_sweeps,
+                                relax_weight, tap_level);
+                        break;
+                    case Chebyshev:
+                        chebyshev(A, x, b, tmp, data, num_smooth_sweeps,
+                                cheby_degree, cheby_fraction, tap_level);
+                        break;
+                    case MulticolorSSOR:
+                        multicolor_ssor(A, x, b, tmp, data, num_smooth_sweeps,
+                                relax_weight, tap_level);
+                        break;
+                }
+            }
+
             void cycle(ParVector& x, ParVector& b, int level = 0)
             {
                 if (solve_times)
@@ -389,27 +740,26 @@ namespace raptor
                     levels[level+1]->x.set_const_value(0.0);
                     
                     // Relax
-                    switch (relax_type)
-                    {
-                        case Jacobi:
-                            jacobi(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        case SOR:
-                            sor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        case SSOR:
-                            ssor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                    }
-
+                    relax(level, x, b);
 
-                    A->residual(x, b, tmp, tap_level);
 
-                    P->mult_T(tmp, levels[level+1]->b, tap_level);
+                    if (levels[level]->A_sp)
+                    {
+                        levels[level]->A_sp->residual(x, b, tmp, tap_level);
+                        levels[level]->P_sp->mult_T(tmp, levels[level+1]->b, tap_level);
+                    }
+                    else
+                    {
+                        A->residual(x, b, tmp, tap_level);
+                        P->mult_T(tmp, levels[level+1]->b, tap_level);
+                    }
 
+                    // Local part of the fine residual norm, reused as 
+                    // the convergence check of solve
+                    if (level == 0 && residual_from_cycle)
+                    {
+                        cycle_resid_sq = local_norm_sq(tmp, cycle_resid_repro);
+                    }
 
                     if (solve_times)
                     {
@@ -427,23 +777,16 @@ namespace raptor
                     }
 
 
-                    P->mult_append(levels[level+1]->x, x, tap_level);
-
-                    switch (relax_type)
+                    if (levels[level]->P_sp)
+                    {
+                        levels[level]->P_sp->mult_append(levels[level+1]->x, x, tap_level);
+                    }
+                    else
                     {
-                        case Jacobi:
-                            jacobi(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        case SOR:
-                            sor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        case SSOR:
-                            ssor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                     }
+                        P->mult_append(levels[level+1]->x, x, tap_level);
+                    }
+
+                    relax(level, x, b);
                     if (solve_times)
                     {
                         finalize_profile();
@@ -459,7 +802,7 @@ namespace raptor
             int solve(ParVector& sol, ParVector& rhs)
             {
                 double b_norm = rhs.norm(2);
-                double r_norm;
+                double r_norm, r0_norm;
                 int iter = 0;
 
                 if (store_residuals)
@@ -474,7 +817,7 @@ namespace raptor
                 }
 
                 // Iterate until convergence or max iterations
-                ParVector resid(rhs.global_n, rhs.local_n);
+                ParVector resid(rhs.global_n, rhs.local_n, rhs.comm);
                 levels[0]->A->residual(sol, rhs, resid);
                 if (fabs(b_norm) > zero_tol)
                 {
@@ -484,6 +827,7 @@ namespace raptor
                 {
                     r_norm = resid.norm(2);
                 }
+                r0_norm = r_norm;
                 if (store_residuals)
                 {
                     residuals[iter] = r_norm;
@@ -499,6 +843,15 @@ namespace raptor
                     solve_times[4] += mat_t;
                 }
 
+                // Iteration at which r_norm was computed, and the
+                // pending nonblocking reduction when lagged_residual
+                int r_iter = 0;
+                int pending_iter = -1;
+                int interval = std::max(residual_interval, 1);
+                double resid_sq = 0.0;
+                ReproSum resid_repro;
+                RAPtor_MPI_Request resid_request;
+
                 while (r_norm > solve_tol && iter < max_iterations)
                 {
                     cycle(sol, rhs, 0);
@@ -509,15 +862,71 @@ namespace raptor
                     }
 
                     iter++;
-                    levels[0]->A->residual(sol, rhs, resid);
-                    if (fabs(b_norm) > zero_tol)
+
+                    // Complete the reduction started after the previous
+                    // cycle
+                    if (pending_iter >= 0)
                     {
-                        r_norm = resid.norm(2) / b_norm;
+                        RAPtor_MPI_Wait(&resid_request, RAPtor_MPI_STATUS_IGNORE);
+                        if (reproducible_reductions) resid_sq = resid_repro.value();
+                        r_norm = resid_norm(sqrt(resid_sq), b_norm);
+                        r_iter = pending_iter;
+                        pending_iter = -1;
                     }
-                    else
+
+                    if (iter % interval == 0 || iter == max_iterations)
                     {
-                        r_norm = resid.norm(2);
+                        // The in-cycle residual belongs to the previous
+                        // iterate (after pre-relaxation)
+                        int resid_iter = iter;
+                        bool lagged = lagged_residual && iter < max_iterations;
+                        if (residual_from_cycle)
+                        {
+                            resid_sq = cycle_resid_sq;
+                            resid_repro = cycle_resid_repro;
+                            resid_iter = iter - 1;
+                        }
+                        else
+                        {
+                            levels[0]->A->residual(sol, rhs, resid);
+                            if (lagged) resid_sq = local_norm_sq(resid, resid_repro);
+                        }
+
+                        if (lagged)
+                        {
+                            if (reproducible_reductions)
+                            {
+                                repro_iallreduce(&resid_repro, 1, rhs.comm, &resid_request);
+                            }
+                            else
+                            {
+                                RAPtor_MPI_Iallreduce(RAPtor_MPI_IN_PLACE, &resid_sq, 1,
+                                        RAPtor_MPI_DOUBLE, RAPtor_MPI_SUM, rhs.comm, 
+                                        &resid_request);
+                            }
+                            pending_iter = resid_iter;
+                        }
+                        else if (residual_from_cycle)
+                        {
+                            if (reproducible_reductions)
+                            {
+                                repro_allreduce(&resid_repro, &resid_sq, 1, rhs.comm);
+                            }
+                            else
+                            {
+                                RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &resid_sq, 1,
+                                        RAPtor_MPI_DOUBLE, RAPtor_MPI_SUM, rhs.comm);
+                            }
+                            r_norm = resid_norm(sqrt(resid_sq), b_norm);
+                            r_iter = resid_iter;
+                        }
+                        else
+                        {
+                            r_norm = resid_norm(resid.norm(2), b_norm);
+                            r_iter = resid_iter;
+                        }
                     }
+
                     if (store_residuals)
                     {
                         residuals[iter] = r_norm;
@@ -533,14 +942,65 @@ namespace raptor
                     }
                 }
 
+                if (pending_iter >= 0)
+                {
+                    RAPtor_MPI_Wait(&resid_request, RAPtor_MPI_STATUS_IGNORE);
+                    if (reproducible_reductions) resid_sq = resid_repro.value();
+                    r_norm = resid_norm(sqrt(resid_sq), b_norm);
+                    r_iter = pending_iter;
+                    if (store_residuals)
+                    {
+                        residuals[iter] = r_norm;
+                    }
+                }
+
+                // Average convergence factor, checked before reusing
+                // interpolation in the next setup
+                if (r_iter > 0 && r0_norm > zero_tol)
+                {
+                    conv_factor = pow(r_norm / r0_norm, 1.0 / r_iter);
+                }
 
                 return iter;
             }
 
+            double resid_norm(double r_norm, double b_norm)
+            {
+                if (fabs(b_norm) > zero_tol)
+                {
+                    return r_norm / b_norm;
+                }
+                return r_norm;
+            }
+
+            // Local part of ||r||^2, accumulated in sum (with the
+            // filtering of ParVector::norm) if reproducible_reductions
+            double local_norm_sq(ParVector& r, ReproSum& sum)
+            {
+                double sq = 0.0;
+                if (reproducible_reductions)
+                {
+                    sum.clear();
+                    for (int i = 0; i < r.local_n; i++)
+                    {
+                        if (fabs(r[i]) > zero_tol) sum.add(r[i] * r[i]);
+                    }
+                }
+                else
+                {
+                    for (int i = 0; i < r.local_n; i++)
+                    {
+                        sq += r[i] * r[i];
+                    }
+                }
+                return sq;
+            }
+
             void print_hierarchy()
             {
                 int rank;
-                RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+                RAPtor_MPI_Comm comm = levels[0]->A->partition->topology->comm;
+                RAPtor_MPI_Comm_rank(comm, &rank);
 
                 if (rank == 0)
                 {
@@ -553,19 +1013,45 @@ namespace raptor
                     ParCSRMatrix* Al = levels[i]->A;
                     long lcl_nnz = Al->local_nnz;
                     long nnz;
-                    RAPtor_MPI_Reduce(&lcl_nnz, &nnz, 1, RAPtor_MPI_LONG, RAPtor_MPI_SUM, 0, RAPtor_MPI_COMM_WORLD);
+                    RAPtor_MPI_Reduce(&lcl_nnz, &nnz, 1, RAPtor_MPI_LONG, RAPtor_MPI_SUM, 0, comm);
                     if (rank == 0)
                     {
                         printf("%d\t%d\t%d\t%lu\n", i, 
                                 Al->global_num_rows, Al->global_num_cols, nnz);
                     }
                 }
+
+                // Reduction in nnz and time spent on non-Galerkin levels
+                bool header = false;
+                for (int i = 1; i < num_levels; i++)
+                {
+                    if (get_sparsify_tol(i) <= 0 || levels[i-1]->I == NULL) 
+                        continue;
+
+                    long lcl_nnz[2] = {levels[i]->galerkin_nnz, levels[i]->A->local_nnz};
+                    long nnz[2];
+                    double max_t;
+                    RAPtor_MPI_Reduce(lcl_nnz, nnz, 2, RAPtor_MPI_LONG, RAPtor_MPI_SUM, 0, comm);
+                    RAPtor_MPI_Reduce(&levels[i]->sparsify_time, &max_t, 1, 
+                            RAPtor_MPI_DOUBLE, RAPtor_MPI_MAX, 0, comm);
+                    if (rank == 0)
+                    {
+                        if (!header)
+                        {
+                            printf("A\tGalerkin NNZ\tNNZ\tReduction\tTime\n");
+                            header = true;
+                        }
+                        printf("%d\t%lu\t%lu\t%2.1f%%\t%e\n", i, nnz[0], nnz[1],
+                                nnz[0] ? 100.0 * (nnz[0] - nnz[1]) / nnz[0] : 0.0, max_t);
+                    }
+                }
             }
 
             void print_residuals(int iter)
             {
                 int rank;
-                RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+                RAPtor_MPI_Comm comm = levels[0]->A->partition->topology->comm;
+                RAPtor_MPI_Comm_rank(comm, &rank);
                 if (rank == 0) 
                 {
                     for (int i = 0; i < iter + 1; i++)
@@ -580,7 +1066,8 @@ namespace raptor
                 if (times == NULL) return;
 
                 int rank;
-                RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+                RAPtor_MPI_Comm comm = levels[0]->A->partition->topology->comm;
+                RAPtor_MPI_Comm_rank(comm, &rank);
 
                 double max_t;
                 for (int i = 0; i < num_levels; i++)
@@ -588,23 +1075,23 @@ namespace raptor
                     if (rank == 0) printf("Level %d\n", i);
 
                     RAPtor_MPI_Reduce(&times[5*i], &max_t, 1, RAPtor_MPI_DOUBLE, 
-                            RAPtor_MPI_MAX, 0, RAPtor_MPI_COMM_WORLD);
+                            RAPtor_MPI_MAX, 0, comm);
                     if (rank == 0 && max_t > 0) printf("%s Total Time: %e\n", phase, max_t);
 
                     RAPtor_MPI_Reduce(&times[5*i+1], &max_t, 1, RAPtor_MPI_DOUBLE, 
-                            RAPtor_MPI_MAX, 0, RAPtor_MPI_COMM_WORLD);
+                            RAPtor_MPI_MAX, 0, comm);
                     if (rank == 0 && max_t > 0) printf("%s Collective Time: %e\n", phase, max_t);
 
                     RAPtor_MPI_Reduce(&times[5*i+2], &max_t, 1, RAPtor_MPI_DOUBLE, 
-                            RAPtor_MPI_MAX, 0, RAPtor_MPI_COMM_WORLD);
+                            RAPtor_MPI_MAX, 0, comm);
                     if (rank == 0 && max_t > 0) printf("%s P2P Time: %e\n", phase, max_t);
 
                     RAPtor_MPI_Reduce(&times[5*i+3], &max_t, 1, RAPtor_MPI_DOUBLE, 
-                            RAPtor_MPI_MAX, 0, RAPtor_MPI_COMM_WORLD);
+                            RAPtor_MPI_MAX, 0, comm);
                     if (rank == 0 && max_t > 0) printf("%s Vec Comm Time: %e\n", phase, max_t);
 
                     RAPtor_MPI_Reduce(&times[5*i+4], &max_t, 1, RAPtor_MPI_DOUBLE, 
-                            RAPtor_MPI_MAX, 0, RAPtor_MPI_COMM_WORLD);
+                            RAPtor_MPI_MAX, 0, comm);
                     if (rank == 0 && max_t > 0) printf("%s Mat Comm Time: %e\n", phase, max_t);
                 }
             }
@@ -627,17 +1114,32 @@ namespace raptor
             relax_t relax_type;
 
             int num_smooth_sweeps;
+            int cheby_degree;
             int max_coarse;
             int max_levels;
             int tap_amg;
             int max_iterations;
+            int galerkin_interval;
+            int reuse_count;
+            int residual_interval;
 
             double strong_threshold;
             double relax_weight;
+            double cheby_fraction;
             double sparsify_tol;
+            int sparsify_start;
+            aligned_vector<double> level_sparsify_tols;
             double solve_tol;
+            double reuse_max_conv_factor;
+            double conv_factor;
+            double cycle_resid_sq;
+            ReproSum cycle_resid_repro;
 
             bool store_residuals;
+            bool reuse_interp;
+            bool mixed_precision;
+            bool residual_from_cycle;
+            bool lagged_residual;
 
             double* weights;
             aligned_vector<double> residuals;
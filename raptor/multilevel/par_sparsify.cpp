@@ -4,10 +4,10 @@
 
 using namespace raptor;
 
-void sparsify(ParCSRMatrix* A, ParCSRMatrix* P, ParCSRMatrix* I, 
+void sparsify(ParCSRMatrix* A, ParCSRMatrix* P, ParCSRMatrix* I,
         ParCSRMatrix* AP, ParCSRMatrix* Ac, const double theta)
 {
-    // Form Minimal Sparsity Pattern
+    // Form Minimal Sparsity Pattern (M = I^T A P + P^T A I)
     ParCSRMatrix* M1 = AP->mult_T(I);
     ParCSRMatrix* AI = A->mult(I);
     ParCSRMatrix* M2 = AI->mult_T(P);
@@ -16,48 +16,85 @@ void sparsify(ParCSRMatrix* A, ParCSRMatrix* P, ParCSRMatrix* I,
     delete M1;
     delete M2;
 
-    int nnz;
-    int rank;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-    RAPtor_MPI_Reduce(&M->local_nnz, &nnz, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, 0, RAPtor_MPI_COMM_WORLD);
-    if (rank == 0) printf("NNZ %d\n", nnz);
-
     int diag_pos, ctr_on, ctr_off;
     int start_on, start_off;
     int end_on, end_off;
-    int ctr_M, end_M;
-    int col_A, global_col_A;
-    int col_M, global_col_M;
+    int col;
     double max_val, val;
-    double val_A;
-    double diag;
-
-    aligned_vector<int> off_proc_col_exists;
 
     Ac->sort();
-    M->sort();
     Ac->on_proc->move_diag();
-    M->on_proc->move_diag();
+
+    // Columns of M are marked with the row in which they were last seen
+    aligned_vector<int> on_in_M;
+    aligned_vector<int> off_in_M;
+    aligned_vector<int> M_to_Ac;
+    aligned_vector<int> off_proc_col_to_new;
+    if (Ac->on_proc_num_cols)
+    {
+        on_in_M.resize(Ac->on_proc_num_cols, -1);
+    }
     if (Ac->off_proc_num_cols)
-        off_proc_col_exists.resize(Ac->off_proc_num_cols, 0);
+    {
+        off_in_M.resize(Ac->off_proc_num_cols, -1);
+        off_proc_col_to_new.resize(Ac->off_proc_num_cols, -1);
+    }
+    if (M->off_proc_num_cols)
+    {
+        IndexMap global_to_Ac(Ac->off_proc_column_map);
+        M_to_Ac.resize(M->off_proc_num_cols);
+        for (int i = 0; i < M->off_proc_num_cols; i++)
+        {
+            M_to_Ac[i] = global_to_Ac[M->off_proc_column_map[i]];
+        }
+    }
 
-    // Go through each row of Ac... If not in M and smaller than rel tol, remove
-    diag_pos = 0;
+    // Go through each row of Ac... If not in M and smaller than
+    // theta * row_max, remove and add to the diagonal
     ctr_on = 0;
     ctr_off = 0;
     start_on = Ac->on_proc->idx1[0];
     start_off = Ac->off_proc->idx1[0];
     for (int i = 0; i < Ac->local_num_rows; i++)
     {
-        // Find abs max val in row (off diag)
-        max_val = 0.0;
-        diag = Ac->on_proc->vals[start_on++];
-
         end_on = Ac->on_proc->idx1[i+1];
         end_off = Ac->off_proc->idx1[i+1];
 
-        // Max val in row
-        for (int j = start_on; j < end_on; j++)
+        for (int j = M->on_proc->idx1[i]; j < M->on_proc->idx1[i+1]; j++)
+        {
+            on_in_M[M->on_proc->idx2[j]] = i;
+        }
+        for (int j = M->off_proc->idx1[i]; j < M->off_proc->idx1[i+1]; j++)
+        {
+            col = M_to_Ac[M->off_proc->idx2[j]];
+            if (col >= 0) off_in_M[col] = i;
+        }
+
+        // Rows without a diagonal are left unchanged
+        if (start_on == end_on || Ac->on_proc->idx2[start_on] != i)
+        {
+            for (int j = start_on; j < end_on; j++)
+            {
+                Ac->on_proc->idx2[ctr_on] = Ac->on_proc->idx2[j];
+                Ac->on_proc->vals[ctr_on++] = Ac->on_proc->vals[j];
+            }
+            for (int j = start_off; j < end_off; j++)
+            {
+                col = Ac->off_proc->idx2[j];
+                off_proc_col_to_new[col] = 1;
+                Ac->off_proc->idx2[ctr_off] = col;
+                Ac->off_proc->vals[ctr_off++] = Ac->off_proc->vals[j];
+            }
+            Ac->on_proc->idx1[i+1] = ctr_on;
+            Ac->off_proc->idx1[i+1] = ctr_off;
+            start_on = end_on;
+            start_off = end_off;
+            continue;
+        }
+
+        // Find abs max val in row (off diag)
+        max_val = 0.0;
+        for (int j = start_on + 1; j < end_on; j++)
         {
             val = fabs(Ac->on_proc->vals[j]);
             if (val > max_val)
@@ -65,7 +102,6 @@ void sparsify(ParCSRMatrix* A, ParCSRMatrix* P, ParCSRMatrix* I,
                 max_val = val;
             }
         }
-
         for (int j = start_off; j < end_off; j++)
         {
             val = fabs(Ac->off_proc->vals[j]);
@@ -74,93 +110,63 @@ void sparsify(ParCSRMatrix* A, ParCSRMatrix* P, ParCSRMatrix* I,
                 max_val = val;
             }
         }
+        max_val *= theta;
 
         // Add diagonal
         diag_pos = ctr_on;
         Ac->on_proc->idx2[ctr_on] = i;
-        Ac->on_proc->vals[ctr_on++] = diag;
+        Ac->on_proc->vals[ctr_on++] = Ac->on_proc->vals[start_on];
 
-        // For each val in row, check if in M, or if greater than theta*row_max
-        ctr_M = M->on_proc->idx1[i];
-        end_M = M->on_proc->idx1[i+1];
-        if (M->on_proc->idx2[ctr_M] == i)
-        {
-            ctr_M++;
-        }
-        for (int j = start_on; j < end_on; j++)
+        // For each val in row, keep if in M, or if at least theta*row_max
+        for (int j = start_on + 1; j < end_on; j++)
         {
-            col_A = Ac->on_proc->idx2[j];
-            val_A = Ac->on_proc->vals[j];
-            if (ctr_M < end_M)
+            col = Ac->on_proc->idx2[j];
+            val = Ac->on_proc->vals[j];
+            if (on_in_M[col] == i || fabs(val) >= max_val)
             {
-                col_M = M->on_proc->idx2[ctr_M];
-                while (ctr_M + 1 < end_M && col_M < col_A)
-                {
-                    col_M = M->on_proc->idx2[++ctr_M];
-                }
-            }
-
-            // Keep in A
-            if ((ctr_M < end_M && col_A == col_M) || fabs(val_A) >= theta * max_val)          
-            {   
-                Ac->on_proc->idx2[ctr_on] = col_A;
-                Ac->on_proc->vals[ctr_on++] = val_A;
+                Ac->on_proc->idx2[ctr_on] = col;
+                Ac->on_proc->vals[ctr_on++] = val;
             }
             else // Add to diagonal (remove)
             {
-                Ac->on_proc->vals[diag_pos] += val_A;
+                Ac->on_proc->vals[diag_pos] += val;
             }
         }
         start_on = end_on;
         Ac->on_proc->idx1[i+1] = ctr_on;
 
-        ctr_M = M->off_proc->idx1[i];
-        end_M = M->off_proc->idx1[i+1];
         for (int j = start_off; j < end_off; j++)
         {
-            col_A = Ac->off_proc->idx2[j];
-            global_col_A = Ac->off_proc_column_map[col_A];
-            val_A = Ac->off_proc->vals[j];
-            if (ctr_M < end_M)
-            {
-                col_M = M->off_proc->idx2[ctr_M];
-                global_col_M = M->off_proc_column_map[col_M];
-                while (ctr_M + 1 < end_M && global_col_M < global_col_A)
-                {
-                    col_M = M->off_proc->idx2[++ctr_M];
-                    global_col_M = M->off_proc_column_map[col_M];
-                }
-            }
-
-            // Keep in A
-            if ((ctr_M < end_M && global_col_A == global_col_M) || fabs(val_A) >= theta * max_val)
+            col = Ac->off_proc->idx2[j];
+            val = Ac->off_proc->vals[j];
+            if (off_in_M[col] == i || fabs(val) >= max_val)
             {
-                Ac->off_proc->idx2[ctr_off] = col_A;
-                Ac->off_proc->vals[ctr_off++] = val_A;
-                off_proc_col_exists[col_A] = 1;
+                Ac->off_proc->idx2[ctr_off] = col;
+                Ac->off_proc->vals[ctr_off++] = val;
+                off_proc_col_to_new[col] = 1;
             }
             else // Add to diagonal (remove)
             {
-                Ac->on_proc->vals[diag_pos] += val_A;
+                Ac->on_proc->vals[diag_pos] += val;
             }
         }
         start_off = end_off;
-        Ac->off_proc->idx1[i+1] = ctr_off; 
+        Ac->off_proc->idx1[i+1] = ctr_off;
     }
 
     Ac->on_proc->nnz = ctr_on;
     Ac->off_proc->nnz = ctr_off;
     Ac->local_nnz = ctr_on + ctr_off;
+    Ac->on_proc->idx2.resize(ctr_on);
+    Ac->on_proc->vals.resize(ctr_on);
+    Ac->off_proc->idx2.resize(ctr_off);
+    Ac->off_proc->vals.resize(ctr_off);
 
-    aligned_vector<int> off_proc_col_to_new;
-    if (Ac->off_proc_num_cols)
-    {
-        off_proc_col_to_new.resize(Ac->off_proc_num_cols);
-    }
+    // Remove off_proc columns no longer in Ac
     int ctr = 0;
     for (int i = 0; i < Ac->off_proc_num_cols; i++)
     {
-        if (off_proc_col_exists[i])
+        if (off_proc_col_to_new[i] != -1)
         {
             off_proc_col_to_new[i] = ctr;
             Ac->off_proc_column_map[ctr++] = Ac->off_proc_column_map[i];
@@ -168,6 +174,7 @@ void sparsify(ParCSRMatrix* A, ParCSRMatrix* P, ParCSRMatrix* I,
     }
     Ac->off_proc_column_map.resize(ctr);
     Ac->off_proc_num_cols = ctr;
+    Ac->off_proc->n_cols = ctr;
 
     for (aligned_vector<int>::iterator it = Ac->off_proc->idx2.begin();
             it != Ac->off_proc->idx2.end(); ++it)
@@ -175,10 +182,12 @@ void sparsify(ParCSRMatrix* A, ParCSRMatrix* P, ParCSRMatrix* I,
         *it = off_proc_col_to_new[*it];
     }
 
-    // Update communicate package (only recv if off proc col exists)
+    // Update communicator (only recv if off proc col exists)
     if (Ac->comm)
     {
-        Ac->comm->update(off_proc_col_exists);
+        ParComm* old_comm = Ac->comm;
+        Ac->comm = new ParComm(old_comm, off_proc_col_to_new);
+        old_comm->delete_comm();
     }
 
     delete M;
@@ -117,3 +117,740 @@ TEST(ParAMGTest, TestsInMultilevel)
     delete A;
 
 } // end of TEST(ParAMGTest, TestsInMultilevel) //
+
+TEST(ParAMGChebyshevTest, TestsInMultilevel)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, 
+            Classical, Chebyshev);
+    ml->setup(A);
+
+    for (int i = 0; i < ml->num_levels - 1; i++)
+    {
+        ParCSRMatrix* Al = ml->levels[i]->A;
+        ParSmootherData& data = ml->levels[i]->smoother_data;
+        ASSERT_GT(data.max_eig, 0.0);
+
+        // Bounded by the Gershgorin bound of D^{-1}A
+        double local_bound = 0.0;
+        double bound;
+        for (int row = 0; row < Al->local_num_rows; row++)
+        {
+            double row_sum = 0.0;
+            for (int j = Al->on_proc->idx1[row]; j < Al->on_proc->idx1[row+1]; j++)
+                row_sum += fabs(Al->on_proc->vals[j]);
+            for (int j = Al->off_proc->idx1[row]; j < Al->off_proc->idx1[row+1]; j++)
+                row_sum += fabs(Al->off_proc->vals[j]);
+            local_bound = std::max(local_bound, fabs(data.diag_inv[row]) * row_sum);
+        }
+        MPI_Allreduce(&local_bound, &bound, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        ASSERT_LE(data.max_eig, bound * (1.0 + 1e-10));
+
+        // Close to a longer power iteration on D^{-1}A from a random
+        // vector (the 10 iteration estimate approaches from below)
+        ParVector v(Al->global_num_rows, Al->local_num_rows);
+        ParVector w(Al->global_num_rows, Al->local_num_rows);
+        double rho = 0.0;
+        v.set_rand_values();
+        v.scale(1.0 / v.norm(2));
+        for (int iter = 0; iter < 50; iter++)
+        {
+            Al->mult(v, w);
+            for (int row = 0; row < Al->local_num_rows; row++)
+            {
+                w[row] *= data.diag_inv[row];
+            }
+            rho = w.norm(2);
+            v.copy(w);
+            v.scale(1.0 / rho);
+        }
+        ASSERT_NEAR(data.max_eig, rho, 0.15 * rho);
+    }
+
+    // A single Chebyshev sweep reduces the (A-norm of the) error of a
+    // random vector
+    ParCSRMatrix* A0 = ml->levels[0]->A;
+    ParVector e(A0->global_num_rows, A0->local_num_rows);
+    ParVector Ae(A0->global_num_rows, A0->local_num_rows);
+    ParVector tmp(A0->global_num_rows, A0->local_num_rows);
+    ParVector zero(A0->global_num_rows, A0->local_num_rows);
+    zero.set_const_value(0.0);
+    e.set_rand_values();
+    A0->mult(e, Ae);
+    double e_norm = Ae.inner_product(e);
+    chebyshev(A0, e, zero, tmp, ml->levels[0]->smoother_data, 1,
+            ml->cheby_degree, ml->cheby_fraction);
+    A0->mult(e, Ae);
+    ASSERT_LT(Ae.inner_product(e), e_norm);
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    aligned_vector<double>& res = ml->get_residuals();
+    ASSERT_LT(iter, ml->max_iterations);
+    ASSERT_LT(res[iter], ml->solve_tol);
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParAMGChebyshevTest, TestsInMultilevel) //
+
+TEST(ParAMGL1Test, TestsInMultilevel)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+
+    relax_t relax_types[3] = {L1Jacobi, L1SOR, L1SSOR};
+    for (int i = 0; i < 3; i++)
+    {
+        ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, 
+                Classical, relax_types[i]);
+        ml->setup(A);
+
+        // diag_inv is 1 / (a_ii + sum |a_ij|), summed over off_proc (and
+        // over off-diagonal on_proc for l1-Jacobi), with the sign of a_ii
+        for (int k = 0; k < ml->num_levels - 1; k++)
+        {
+            ParCSRMatrix* Al = ml->levels[k]->A;
+            aligned_vector<double>& diag_inv = ml->levels[k]->smoother_data.diag_inv;
+            for (int row = 0; row < Al->local_num_rows; row++)
+            {
+                double diag = 0.0;
+                double row_sum = 0.0;
+                for (int j = Al->on_proc->idx1[row]; j < Al->on_proc->idx1[row+1]; j++)
+                {
+                    if (Al->on_proc->idx2[j] == row)
+                        diag = Al->on_proc->vals[j];
+                    else if (relax_types[i] == L1Jacobi)
+                        row_sum += fabs(Al->on_proc->vals[j]);
+                }
+                for (int j = Al->off_proc->idx1[row]; j < Al->off_proc->idx1[row+1]; j++)
+                {
+                    row_sum += fabs(Al->off_proc->vals[j]);
+                }
+                double l1_diag = diag < 0 ? diag - row_sum : diag + row_sum;
+                ASSERT_NEAR(diag_inv[row], 1.0 / l1_diag, 1e-12 * fabs(1.0 / l1_diag));
+            }
+        }
+
+        x.set_const_value(1.0);
+        A->mult(x, b);
+        x.set_const_value(0.0);
+        int iter = ml->solve(x, b);
+        aligned_vector<double>& res = ml->get_residuals();
+        ASSERT_LT(iter, ml->max_iterations);
+        ASSERT_LT(res[iter], ml->solve_tol);
+
+        delete ml;
+    }
+
+    delete A;
+
+} // end of TEST(ParAMGL1Test, TestsInMultilevel) //
+
+TEST(ParAMGMulticolorTest, TestsInMultilevel)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, 
+            Classical, MulticolorSSOR);
+    ml->setup(A);
+
+    // No two rows of the same color can be coupled in on_proc
+    for (int i = 0; i < ml->num_levels - 1; i++)
+    {
+        ParCSRMatrix* Al = ml->levels[i]->A;
+        aligned_vector<int>& color_ptr = ml->levels[i]->smoother_data.color_ptr;
+        aligned_vector<int>& color_rows = ml->levels[i]->smoother_data.color_rows;
+        ASSERT_EQ((int) color_rows.size(), Al->local_num_rows);
+
+        aligned_vector<int> colors(Al->local_num_rows);
+        for (int c = 0; c < (int) color_ptr.size() - 1; c++)
+        {
+            for (int j = color_ptr[c]; j < color_ptr[c+1]; j++)
+            {
+                colors[color_rows[j]] = c;
+            }
+        }
+        for (int row = 0; row < Al->local_num_rows; row++)
+        {
+            for (int j = Al->on_proc->idx1[row]; j < Al->on_proc->idx1[row+1]; j++)
+            {
+                int col = Al->on_proc->idx2[j];
+                if (col == row) continue;
+                ASSERT_NE(colors[row], colors[col]);
+            }
+        }
+    }
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    aligned_vector<double>& res = ml->get_residuals();
+    ASSERT_LT(iter, ml->max_iterations);
+    ASSERT_LT(res[iter], ml->solve_tol);
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParAMGMulticolorTest, TestsInMultilevel) //
+
+TEST(ParAMGReuseTest, TestsInMultilevel)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended);
+    ml->reuse_interp = true;
+    ml->setup(A);
+    int num_levels = ml->num_levels;
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    ASSERT_LT(iter, ml->max_iterations);
+    ASSERT_LE(ml->conv_factor, ml->reuse_max_conv_factor);
+
+    // Slowly varying system : shift diagonal and refresh coarse operators
+    A->sort();
+    A->on_proc->move_diag();
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        A->on_proc->vals[A->on_proc->idx1[i]] *= 1.01;
+    }
+    ml->setup(A);
+    ASSERT_EQ(ml->reuse_count, 1);
+    ASSERT_EQ(ml->num_levels, num_levels);
+
+    // Coarse operators must match P^T A P with the new values
+    for (int i = 0; i < ml->num_levels - 1; i++)
+    {
+        ParCSRMatrix* Al = ml->levels[i]->A;
+        ParCSRMatrix* P = ml->levels[i]->P;
+        ParCSRMatrix* AP = Al->mult(P);
+        ParCSRMatrix* Ac = AP->mult_T(P);
+        ParVector xc(Ac->global_num_rows, Ac->local_num_rows);
+        ParVector bc(Ac->global_num_rows, Ac->local_num_rows);
+        ParVector bl(Ac->global_num_rows, Ac->local_num_rows);
+        xc.set_rand_values();
+        Ac->mult(xc, bc);
+        ml->levels[i+1]->A->mult(xc, bl);
+        for (int j = 0; j < Ac->local_num_rows; j++)
+        {
+            ASSERT_NEAR(bc[j], bl[j], 1e-10);
+        }
+        delete Ac;
+        delete AP;
+    }
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    iter = ml->solve(x, b);
+    ASSERT_LT(iter, ml->max_iterations);
+
+    // Quality guard : slow convergence triggers a full setup
+    ml->reuse_max_conv_factor = 0.0;
+    ml->setup(A);
+    ASSERT_EQ(ml->reuse_count, 0);
+
+    x.set_const_value(0.0);
+    iter = ml->solve(x, b);
+    ASSERT_LT(iter, ml->max_iterations);
+
+    // Cycles alone (as a preconditioner) do not measure convergence,
+    // so only the setup following a solve may reuse interpolation
+    ml->reuse_max_conv_factor = 0.5;
+    ml->setup(A);
+    ASSERT_EQ(ml->reuse_count, 1);
+    x.set_const_value(0.0);
+    for (int i = 0; i < 5; i++)
+    {
+        ml->cycle(x, b);
+    }
+    ml->setup(A);
+    ASSERT_EQ(ml->reuse_count, 0);
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParAMGReuseTest, TestsInMultilevel) //
+
+TEST(ParAMGMixedPrecisionTest, TestsInMultilevel)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    ParVector r(A->global_num_rows, A->local_num_rows);
+    aligned_vector<double> dp_res;
+    aligned_vector<double> sp_res;
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, 
+            Classical, SSOR);
+    ml->setup(A);
+    x.set_const_value(0.0);
+    PCG(A, ml, x, b, dp_res, 1e-10);
+    A->residual(x, b, r);
+    double dp_rnorm = r.norm(2);
+    delete ml;
+
+    ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SSOR);
+    ml->mixed_precision = true;
+    ml->setup(A);
+    for (int i = 0; i < ml->num_levels - 1; i++)
+    {
+        ASSERT_EQ(ml->levels[i]->A_sp->on_vals.size(), 
+                ml->levels[i]->A->on_proc->vals.size());
+        ASSERT_EQ(ml->levels[i]->P_sp->off_vals.size(), 
+                ml->levels[i]->P->off_proc->vals.size());
+    }
+
+    // Single precision preconditioner, double precision PCG
+    // reaches the same accuracy in about as many iterations
+    x.set_const_value(0.0);
+    PCG(A, ml, x, b, sp_res, 1e-10);
+    ASSERT_LE(sp_res.size(), dp_res.size() + 2);
+
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2), 2.0 * dp_rnorm);
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParAMGMixedPrecisionTest, TestsInMultilevel) //
+
+TEST(ParAMGLaggedResidualTest, TestsInMultilevel)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    ParVector r(A->global_num_rows, A->local_num_rows);
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    double b_norm = b.norm(2);
+
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, 
+            Classical, SSOR);
+    ml->solve_tol = 1e-8;
+    ml->setup(A);
+
+    x.set_const_value(0.0);
+    int base_iter = ml->solve(x, b);
+    aligned_vector<double> base_res = ml->get_residuals();
+
+    // Check every 3 cycles : stops at the next multiple of 3
+    ml->residual_interval = 3;
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    ASSERT_EQ(iter, 3 * ((base_iter + 2) / 3));
+    ASSERT_DOUBLE_EQ(ml->get_residuals()[iter-1], base_res[iter - 3]);
+    A->residual(x, b, r);
+    ASSERT_NEAR(ml->get_residuals()[iter], r.norm(2) / b_norm, 1e-14);
+
+    // Non-positive intervals check every cycle
+    ml->residual_interval = 0;
+    x.set_const_value(0.0);
+    ASSERT_EQ(ml->solve(x, b), base_iter);
+    ml->residual_interval = -2;
+    x.set_const_value(0.0);
+    ASSERT_EQ(ml->solve(x, b), base_iter);
+    ml->residual_interval = 1;
+
+    // Nonblocking reduction, checked one cycle late
+    ml->lagged_residual = true;
+    x.set_const_value(0.0);
+    iter = ml->solve(x, b);
+    ASSERT_EQ(iter, base_iter + 1);
+    for (int i = 1; i <= base_iter; i++)
+    {
+        ASSERT_DOUBLE_EQ(ml->get_residuals()[i], base_res[i-1]);
+    }
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2) / b_norm, 1e-8);
+
+    // Norm from the residual formed within the cycle
+    ml->residual_from_cycle = true;
+    x.set_const_value(0.0);
+    iter = ml->solve(x, b);
+    ASSERT_LE(iter, base_iter + 2);
+    A->residual(x, b, r);
+    ASSERT_LT(r.norm(2) / b_norm, 1e-8);
+
+    // Reproducible reductions : lagged and in-cycle norms match the
+    // blocking ones bit for bit
+    reproducible_reductions = true;
+    b_norm = b.norm(2);
+    ml->residual_from_cycle = false;
+    ml->lagged_residual = false;
+    x.set_const_value(0.0);
+    base_iter = ml->solve(x, b);
+    base_res = ml->get_residuals();
+    ml->levels[0]->A->residual(x, b, r);
+    ASSERT_EQ(base_res[base_iter], r.norm(2) / b_norm);
+
+    ml->lagged_residual = true;
+    x.set_const_value(0.0);
+    iter = ml->solve(x, b);
+    ASSERT_EQ(iter, base_iter + 1);
+    for (int i = 1; i <= base_iter; i++)
+    {
+        ASSERT_EQ(ml->get_residuals()[i], base_res[i-1]);
+    }
+
+    ml->residual_from_cycle = true;
+    ml->lagged_residual = false;
+    x.set_const_value(0.0);
+    base_iter = ml->solve(x, b);
+    base_res = ml->get_residuals();
+    ml->lagged_residual = true;
+    x.set_const_value(0.0);
+    iter = ml->solve(x, b);
+    ASSERT_EQ(iter, base_iter + 1);
+    for (int i = 1; i <= base_iter; i++)
+    {
+        ASSERT_EQ(ml->get_residuals()[i], base_res[i-1]);
+    }
+    reproducible_reductions = false;
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParAMGLaggedResidualTest, TestsInMultilevel) //
+
+TEST(ParAMGAggressiveTest, TestsInMultilevel)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+
+    ParRugeStubenSolver* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, 
+            Classical, SSOR);
+    ml->setup(A);
+    int coarse_n = ml->levels[1]->A->global_num_rows;
+    delete ml;
+
+    // Two-stage coarsening on the finest level
+    ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SSOR);
+    ml->agg_num_levels = 1;
+    ml->setup(A);
+    ASSERT_LT(ml->levels[1]->A->global_num_rows, coarse_n);
+    ASSERT_EQ(ml->levels[0]->P->global_num_cols, ml->levels[1]->A->global_num_rows);
+
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    aligned_vector<double>& res = ml->get_residuals();
+    ASSERT_LT(iter, ml->max_iterations);
+    ASSERT_LT(res[iter], ml->solve_tol);
+    delete ml;
+
+    // First stage with direct and modified classical interpolation :
+    // every row of the two-stage interpolation is nonempty
+    interp_t interp_types[2] = {Direct, ModClassical};
+    for (int k = 0; k < 2; k++)
+    {
+        ml = new ParRugeStubenSolver(0.25, HMIS, interp_types[k], Classical, SOR);
+        ml->agg_num_levels = 1;
+        ml->setup(A);
+
+        ParCSRMatrix* P = ml->levels[0]->P;
+        for (int i = 0; i < P->local_num_rows; i++)
+        {
+            int row_size = (P->on_proc->idx1[i+1] - P->on_proc->idx1[i])
+                + (P->off_proc->idx1[i+1] - P->off_proc->idx1[i]);
+            ASSERT_GT(row_size, 0);
+        }
+
+        x.set_const_value(0.0);
+        iter = ml->solve(x, b);
+        aligned_vector<double>& res_k = ml->get_residuals();
+        ASSERT_LT(iter, ml->max_iterations);
+        ASSERT_LT(res_k[iter], ml->solve_tol);
+
+        delete ml;
+    }
+
+    delete A;
+
+} // end of TEST(ParAMGAggressiveTest, TestsInMultilevel) //
+
+TEST(ParAMGTruncationTest, TestsInMultilevel)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+
+    ParRugeStubenSolver* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, 
+            Classical, SSOR);
+    ml->interp_filter = 0.0;
+    ml->setup(A);
+    ParMatrix* P = ml->levels[0]->P;
+    ParVector ones(P->global_num_cols, P->on_proc_num_cols);
+    ParVector row_sums(A->global_num_rows, A->local_num_rows);
+    ones.set_const_value(1.0);
+    P->mult(ones, row_sums);
+    int full_nnz = P->local_nnz;
+    delete ml;
+
+    // At most two entries per row, with row sums preserved
+    ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SSOR);
+    ml->interp_filter = 0.0;
+    ml->p_max_elmts = 2;
+    ml->setup(A);
+    P = ml->levels[0]->P;
+    ASSERT_LE(P->local_nnz, full_nnz);
+    for (int i = 0; i < P->local_num_rows; i++)
+    {
+        int row_size = (P->on_proc->idx1[i+1] - P->on_proc->idx1[i])
+            + (P->off_proc->idx1[i+1] - P->off_proc->idx1[i]);
+        ASSERT_LE(row_size, 2);
+    }
+    P->mult(ones, b);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        ASSERT_NEAR(b[i], row_sums[i], 1e-10);
+    }
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    aligned_vector<double>& res = ml->get_residuals();
+    ASSERT_LT(iter, ml->max_iterations);
+    ASSERT_LT(res[iter], ml->solve_tol);
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParAMGTruncationTest, TestsInMultilevel) //
+
+TEST(ParAMGSparsifyTest, TestsInMultilevel)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+
+    // Non-Galerkin coarse operators below the first coarse level
+    ParRugeStubenSolver* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, 
+            Classical, SSOR);
+    ml->sparsify_tol = 0.1;
+    ml->sparsify_start = 2;
+    ml->setup(A);
+    ASSERT_GT(ml->num_levels, 3);
+    ASSERT_EQ(ml->levels[0]->I, nullptr);
+    ASSERT_EQ(ml->levels[1]->galerkin_nnz, 0);
+    for (int i = 2; i < ml->num_levels; i++)
+    {
+        ASSERT_LE(ml->levels[i]->A->local_nnz, ml->levels[i]->galerkin_nnz);
+    }
+
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    aligned_vector<double>& res = ml->get_residuals();
+    ASSERT_LT(iter, ml->max_iterations);
+    ASSERT_LT(res[iter], ml->solve_tol);
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParAMGSparsifyTest, TestsInMultilevel) //
+
+TEST(ParAMGCandidatesTest, TestsInMultilevel)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+
+    // Constant and linear (in x and y) candidates
+    int num_candidates = 3;
+    int n = A->local_num_rows;
+    aligned_vector<double> B(n * num_candidates);
+    for (int i = 0; i < n; i++)
+    {
+        int global_row = A->local_row_map[i];
+        B[i] = 1.0;
+        B[n + i] = (double) (global_row % grid[0]) / grid[0];
+        B[2*n + i] = (double) (global_row / grid[0]) / grid[1];
+    }
+
+    ParSmoothedAggregationSolver* ml = new ParSmoothedAggregationSolver(0.0);
+    ml->setup(A, B, num_candidates);
+    ASSERT_GT(ml->num_levels, 1);
+    ASSERT_EQ(ml->levels[0]->P->global_num_cols % num_candidates, 0);
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    aligned_vector<double>& res = ml->get_residuals();
+    ASSERT_LT(iter, ml->max_iterations);
+    ASSERT_LT(res[iter], ml->solve_tol);
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParAMGCandidatesTest, TestsInMultilevel) //
+
+TEST(ParAMGEnergyProlongationTest, TestsInMultilevel)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+
+    // Filtered Jacobi, and energy minimizing prolongation (with and
+    // without filtering)
+    for (int k = 0; k < 3; k++)
+    {
+        ParSmoothedAggregationSolver* ml = new ParSmoothedAggregationSolver(0.1);
+        if (k > 0) ml->prolong_type = EnergyMinProlongation;
+        ml->filter_prolongation = (k != 1);
+        ml->setup(A);
+        ASSERT_GT(ml->num_levels, 1);
+
+        x.set_const_value(1.0);
+        A->mult(x, b);
+        x.set_const_value(0.0);
+        int iter = ml->solve(x, b);
+        aligned_vector<double>& res = ml->get_residuals();
+        ASSERT_LT(iter, ml->max_iterations);
+        ASSERT_LT(res[iter], ml->solve_tol);
+
+        delete ml;
+    }
+
+    delete A;
+
+} // end of TEST(ParAMGEnergyProlongationTest, TestsInMultilevel) //
+
+TEST(ParAMGSubcommTest, TestsInMultilevel)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    // Ensemble of independent AMG-preconditioned solves, of different
+    // sizes, on two halves of WORLD
+    int color = (num_procs > 1) ? rank % 2 : 0;
+    RAPtor_MPI_Comm sub_comm;
+    RAPtor_MPI_Comm_split(RAPtor_MPI_COMM_WORLD, color, rank, &sub_comm);
+
+    int nx = 30 + 8*color;
+    int n = nx * nx;
+    Topology* topology = new Topology(1, 1, sub_comm);
+    Partition* part = new Partition(n, n, topology);
+    ParCSRMatrix* A = new ParCSRMatrix(part, 5*part->local_num_rows);
+    A->on_proc->idx1[0] = 0;
+    A->off_proc->idx1[0] = 0;
+    for (int i = 0; i < part->local_num_rows; i++)
+    {
+        int row = part->first_local_row + i;
+        int gx = row % nx;
+        int gy = row / nx;
+        if (gy > 0) A->add_value(i, row - nx, -1.0);
+        if (gx > 0) A->add_value(i, row - 1, -1.0);
+        A->add_value(i, row, 4.0);
+        if (gx < nx - 1) A->add_value(i, row + 1, -1.0);
+        if (gy < nx - 1) A->add_value(i, row + nx, -1.0);
+        A->on_proc->idx1[i+1] = A->on_proc->idx2.size();
+        A->off_proc->idx1[i+1] = A->off_proc->idx2.size();
+    }
+    A->on_proc->nnz = A->on_proc->idx2.size();
+    A->off_proc->nnz = A->off_proc->idx2.size();
+    A->finalize();
+
+    ParVector x(A->global_num_rows, A->local_num_rows, sub_comm);
+    ParVector b(A->global_num_rows, A->local_num_rows, sub_comm);
+
+    // Classical, and node-aware (TAP) hierarchies
+    for (int k = 0; k < 2; k++)
+    {
+        aligned_vector<double> residuals;
+        ParMultilevel* ml = new ParRugeStubenSolver(0.25, PMIS, Extended,
+                Classical, SOR);
+        ml->max_coarse = 10;
+        if (k == 1) ml->tap_amg = 0;
+        ml->setup(A);
+        ASSERT_GT(ml->num_levels, 2);
+
+        x.set_const_value(1.0);
+        A->mult(x, b);
+        x.set_const_value(0.0);
+        PCG(A, ml, x, b, residuals, 1e-10);
+        ASSERT_LT(residuals.back(), 1e-10);
+        for (int i = 0; i < x.local_n; i++)
+        {
+            ASSERT_NEAR(x[i], 1.0, 1e-05);
+        }
+
+        delete ml;
+    }
+
+    delete A;
+    delete part;
+    delete topology;
+    RAPtor_MPI_Comm_free(&sub_comm);
+
+} // end of TEST(ParAMGSubcommTest, TestsInMultilevel) //
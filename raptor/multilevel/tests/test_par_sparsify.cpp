@@ -40,13 +40,11 @@ TEST(ParSparsifyTest, TestsInMultilevel)
     ParCSRMatrix* P;
     ParCSRMatrix* I;
     ParCSRMatrix* Ac;
-    ParCSRMatrix* Ac_rap;
+    ParCSRMatrix* Ac_gal;
 
     const char* A0_fn = "../../../../test_data/rss_A0.pm";
     const char* weight_fn = "../../../../test_data/weights.txt";
     const char* cf0_fn = "../../../../test_data/rss_cf0.txt";
-    const char* A1_fn = "../../../../test_data/rss_A1.pm";
-    const char* A1_hgal_fn = "../../../../test_data/rss_A1_hgal.pm";
 
     A = readParMatrix(A0_fn);
     S = A->strength(Classical, 0.25);
@@ -78,52 +76,56 @@ TEST(ParSparsifyTest, TestsInMultilevel)
 
     P = mod_classical_interpolation(A, S, states, S->comm->recv_data->int_buffer);
 
-    aligned_vector<int> first_rows(num_procs+1);
-    first_rows[0] = 0;
-    MPI_Allgather(&P->on_proc_num_cols, 1, MPI_INT, &first_rows[1], 1, MPI_INT, MPI_COMM_WORLD);
-    for (int i = 0; i < num_procs; i++)
-    {
-        first_rows[i+1] += first_rows[i];
-    }
-
     ParCSRMatrix* AP = A->mult(P);
     Ac = AP->mult_T(P);
+    Ac->sort();
+    Ac->on_proc->move_diag();
     Ac->comm = new ParComm(Ac->partition, Ac->off_proc_column_map, Ac->on_proc_column_map);
-    Ac_rap = readParMatrix(A1_hgal_fn, Ac->local_num_rows, Ac->on_proc_num_cols, 
-            first_rows[rank], first_rows[rank]);
+    Ac_gal = Ac->copy();
+    Ac_gal->comm = new ParComm(Ac_gal->partition, Ac_gal->off_proc_column_map, 
+            Ac_gal->on_proc_column_map);
+
+    I = injection(A, states);
+    sparsify(A, P, I, AP, Ac, 0.1);
 
+    long nnz, nnz_gal;
+    long lcl_nnz = Ac->local_nnz;
+    MPI_Allreduce(&lcl_nnz, &nnz, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+    lcl_nnz = Ac_gal->local_nnz;
+    MPI_Allreduce(&lcl_nnz, &nnz_gal, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+    ASSERT_LT(nnz, nnz_gal);
 
-    I = new ParCSRMatrix(P->partition, P->global_num_rows, P->global_num_cols,
-            P->local_num_rows, P->on_proc_num_cols, 0);
-    I->on_proc->idx1[0] = 0;
-    I->off_proc->idx1[0] = 0;
-    int ctr = 0;
-    for (int i = 0; i < P->local_num_rows; i++)
+    // Remaining off-diagonals are unchanged
+    for (int i = 0; i < Ac->local_num_rows; i++)
     {
-        if (states[i])
+        ASSERT_EQ(Ac->on_proc->idx2[Ac->on_proc->idx1[i]], i);
+        int ctr = Ac_gal->on_proc->idx1[i] + 1;
+        for (int j = Ac->on_proc->idx1[i] + 1; j < Ac->on_proc->idx1[i+1]; j++)
         {
-            I->on_proc->idx2.push_back(ctr++);
-            I->on_proc->vals.push_back(1.0);
+            while (Ac_gal->on_proc->idx2[ctr] != Ac->on_proc->idx2[j]) ctr++;
+            ASSERT_EQ(Ac->on_proc->vals[j], Ac_gal->on_proc->vals[ctr]);
         }
-        I->on_proc->idx1[i+1] = I->on_proc->idx2.size();
-        I->off_proc->idx1[i+1] = 0;
     }
-    I->on_proc->nnz = I->on_proc->idx2.size();
-    I->off_proc->nnz = 0;
-    I->finalize();
 
-    printf("%d, %d\n", Ac->off_proc_num_cols, Ac_rap->off_proc_num_cols);
-    sparsify(A, P, I, AP, Ac, 0.1);
-    printf("%d, %d\n", Ac->off_proc_num_cols, Ac_rap->off_proc_num_cols);
-    //compare(Ac, Ac_rap);
+    // Removed entries are lumped to the diagonal (row sums are preserved)
+    ParVector x(Ac->global_num_cols, Ac->on_proc_num_cols);
+    ParVector b(Ac->global_num_rows, Ac->local_num_rows);
+    ParVector b_gal(Ac->global_num_rows, Ac->local_num_rows);
+    x.set_const_value(1.0);
+    Ac->mult(x, b);
+    Ac_gal->mult(x, b_gal);
+    for (int i = 0; i < Ac->local_num_rows; i++)
+    {
+        ASSERT_NEAR(b[i], b_gal[i], 1e-10);
+    }
 
     delete AP;
     delete P;
     delete I;
     delete Ac;
-    delete Ac_rap;
+    delete Ac_gal;
     delete S;
     delete A;
 
-} // end of TEST(ParAMGTest, TestsInMultilevel) //
+} // end of TEST(ParSparsifyTest, TestsInMultilevel) //
 
@@ -5,26 +5,125 @@
 
 using namespace raptor;
 
-ParCSRMatrix* classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, int num_variables,
-        int* variables)
+/**************************************************************
+ *****   Compact Strength
+ **************************************************************
+ ***** Forms the pattern-only strength matrix S (no values) from
+ ***** A and the strong flags of its off-diagonal nonzeros.  The
+ ***** diagonal is always added to nonempty rows.  Rows are
+ ***** counted independently, row pointers are formed with a
+ ***** prefix sum, and rows are then filled independently.
+ **************************************************************/
+static ParCSRMatrix* compact_strength(ParCSRMatrix* A, 
+        const aligned_vector<char>& on_strong, const aligned_vector<char>& off_strong)
 {
-    int row_start_on, row_end_on;
-    int row_start_off, row_end_off;
-    int col;
-    double val;
-    double row_scale;
-    double threshold;
-    double diag;
+    ParCSRMatrix* S = new ParCSRMatrix(A->partition, A->global_num_rows, A->global_num_cols,
+            A->local_num_rows, A->on_proc_num_cols, A->off_proc_num_cols);
+
+#pragma omp parallel for
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        int row_start_on = A->on_proc->idx1[i];
+        int row_end_on = A->on_proc->idx1[i+1];
+        int row_start_off = A->off_proc->idx1[i];
+        int row_end_off = A->off_proc->idx1[i+1];
+        int num_on = row_end_on - row_start_on || row_end_off - row_start_off;
+        int num_off = 0;
+        for (int j = row_start_on; j < row_end_on; j++)
+        {
+            num_on += on_strong[j];
+        }
+        for (int j = row_start_off; j < row_end_off; j++)
+        {
+            num_off += off_strong[j];
+        }
+        S->on_proc->idx1[i+1] = num_on;
+        S->off_proc->idx1[i+1] = num_off;
+    }
+
+    S->on_proc->idx1[0] = 0;
+    S->off_proc->idx1[0] = 0;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        S->on_proc->idx1[i+1] += S->on_proc->idx1[i];
+        S->off_proc->idx1[i+1] += S->off_proc->idx1[i];
+    }
+    S->on_proc->nnz = S->on_proc->idx1[A->local_num_rows];
+    S->off_proc->nnz = S->off_proc->idx1[A->local_num_rows];
+    S->on_proc->idx2.resize(S->on_proc->nnz);
+    S->off_proc->idx2.resize(S->off_proc->nnz);
+
+#pragma omp parallel for
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        int row_start_on = A->on_proc->idx1[i];
+        int row_end_on = A->on_proc->idx1[i+1];
+        int row_start_off = A->off_proc->idx1[i];
+        int row_end_off = A->off_proc->idx1[i+1];
+        if (row_end_on - row_start_on || row_end_off - row_start_off)
+        {
+            int ctr = S->on_proc->idx1[i];
+            S->on_proc->idx2[ctr++] = i;
+            for (int j = row_start_on; j < row_end_on; j++)
+            {
+                if (on_strong[j])
+                {
+                    S->on_proc->idx2[ctr++] = A->on_proc->idx2[j];
+                }
+            }
 
+            ctr = S->off_proc->idx1[i];
+            for (int j = row_start_off; j < row_end_off; j++)
+            {
+                if (off_strong[j])
+                {
+                    S->off_proc->idx2[ctr++] = A->off_proc->idx2[j];
+                }
+            }
+        }
+    }
+
+    // S inherits the (sorted, diagonal first) ordering of A
+    S->on_proc->sorted = true;
+    S->on_proc->diag_first = true;
+    S->off_proc->sorted = true;
+
+    S->local_nnz = S->on_proc->nnz + S->off_proc->nnz;
+
+    S->on_proc_column_map = A->get_on_proc_column_map();
+    S->local_row_map = A->get_local_row_map();
+    S->off_proc_column_map = A->get_off_proc_column_map();
+
+    S->comm = A->comm;
+    S->tap_comm = A->tap_comm;
+    S->tap_mat_comm = A->tap_mat_comm;
+
+    if (S->comm) S->comm->num_shared++;
+    if (S->tap_comm) S->tap_comm->num_shared++;
+    if (S->tap_mat_comm) S->tap_mat_comm->num_shared++;
+
+    return S;
+}
+
+/**************************************************************
+ *****   Classical Strength of Connection
+ **************************************************************
+ ***** Entry a_ij is strong if -sign(a_ii)*a_ij exceeds theta
+ ***** times the largest such value in row i.  Each row is
+ ***** scanned independently : the scale and the strong entries
+ ***** are found with branch-free loops, flagging each strong
+ ***** off-diagonal nonzero of A.
+ **************************************************************/
+static void classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, 
+        int num_variables, int* variables, aligned_vector<char>& on_strong,
+        aligned_vector<char>& off_strong)
+{
     CommPkg* comm = A->comm;
     if (tap_amg)
     {
         comm = A->tap_comm;
     }
 
-    ParCSRMatrix* S = new ParCSRMatrix(A->partition, A->global_num_rows, A->global_num_cols,
-            A->local_num_rows, A->on_proc_num_cols, A->off_proc_num_cols);
-    
     int* off_variables;
     if (num_variables > 1)
     {
@@ -36,319 +135,102 @@ ParCSRMatrix* classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, in
     // A and S will be sorted 
     A->sort();
     A->on_proc->move_diag();
-    
-    if (A->on_proc->nnz)
-    {
-        S->on_proc->idx2.resize(A->on_proc->nnz);
-        S->on_proc->vals.resize(A->on_proc->nnz);
-    }
-    if (A->off_proc->nnz)
-    {
-        S->off_proc->idx2.resize(A->off_proc->nnz);
-        S->off_proc->vals.resize(A->off_proc->nnz);
-    }
 
-    S->on_proc->idx1[0] = 0;
-    S->off_proc->idx1[0] = 0;
-    S->on_proc->nnz = 0;
-    S->off_proc->nnz = 0;
+    on_strong.assign(A->on_proc->nnz, 0);
+    off_strong.assign(A->off_proc->nnz, 0);
+
+#pragma omp parallel for
     for (int i = 0; i < A->local_num_rows; i++)
     {
-        row_start_on = A->on_proc->idx1[i];
-        row_end_on = A->on_proc->idx1[i+1];
-        row_start_off = A->off_proc->idx1[i];
-        row_end_off = A->off_proc->idx1[i+1];
+        int row_start_on = A->on_proc->idx1[i];
+        int row_end_on = A->on_proc->idx1[i+1];
+        int row_start_off = A->off_proc->idx1[i];
+        int row_end_off = A->off_proc->idx1[i+1];
         if (row_end_on - row_start_on || row_end_off - row_start_off)
         {
-            if (A->on_proc->idx2[row_start_on] == i)
+            double diag = 0.0;
+            if (row_end_on > row_start_on && A->on_proc->idx2[row_start_on] == i)
             {
                 diag = A->on_proc->vals[row_start_on];
                 row_start_on++;
             }
-            else
-            {
-                diag = 0.0;
-            }
 
-            // Find value with max magnitude in row
+            // Compare sign*val, so the strongest connections (those 
+            // of opposite sign to the diagonal) are the largest
+            double sign = diag < 0.0 ? 1.0 : -1.0;
+            double row_scale = -RAND_MAX;
             if (num_variables == 1)
             {
-                if (diag < 0.0)
+                for (int j = row_start_on; j < row_end_on; j++)
                 {
-                    row_scale = -RAND_MAX; 
-                    for (int j = row_start_on; j < row_end_on; j++)
-                    {
-                        val = A->on_proc->vals[j];
-                        if (val > row_scale)
-                        {
-                            row_scale = val;
-                        }
-                    }    
-                    for (int j = row_start_off; j < row_end_off; j++)
-                    {
-                        val = A->off_proc->vals[j];
-                        if (val > row_scale)
-                        {
-                            row_scale = val;
-                        }
-                    } 
+                    row_scale = std::max(row_scale, sign * A->on_proc->vals[j]);
                 }
-                else
+                for (int j = row_start_off; j < row_end_off; j++)
                 {
-                    row_scale = RAND_MAX;
-                    for (int j = row_start_on; j < row_end_on; j++)
-                    {
-                        val = A->on_proc->vals[j];
-                        if (val < row_scale)
-                        {
-                            row_scale = val;
-                        }
-                    }    
-                    for (int j = row_start_off; j < row_end_off; j++)
-                    {
-                        val = A->off_proc->vals[j];
-                        if (val < row_scale)
-                        {
-                            row_scale = val;
-                        }
-                    } 
+                    row_scale = std::max(row_scale, sign * A->off_proc->vals[j]);
                 }
             }
             else
             {
-                if (diag < 0.0)
+                for (int j = row_start_on; j < row_end_on; j++)
                 {
-                    row_scale = -RAND_MAX; 
-                    for (int j = row_start_on; j < row_end_on; j++)
-                    {
-                        col = A->on_proc->idx2[j];
-                        if (variables[i] == variables[col])
-                        {
-                            val = A->on_proc->vals[j];
-                            if (val > row_scale)
-                            {
-                                row_scale = val;
-                            }
-                        }
-                    }    
-                    for (int j = row_start_off; j < row_end_off; j++)
+                    if (variables[i] == variables[A->on_proc->idx2[j]])
                     {
-                        col = A->off_proc->idx2[j];
-                        if (variables[i] == off_variables[col])
-                        {
-                            val = A->off_proc->vals[j];
-                            if (val > row_scale)
-                            {
-                                row_scale = val;
-                            }
-                        }
-                    } 
+                        row_scale = std::max(row_scale, sign * A->on_proc->vals[j]);
+                    }
                 }
-                else
+                for (int j = row_start_off; j < row_end_off; j++)
                 {
-                    row_scale = RAND_MAX;
-                    for (int j = row_start_on; j < row_end_on; j++)
-                    {
-                        col = A->on_proc->idx2[j];
-                        if (variables[i] == variables[col])
-                        {
-                            val = A->on_proc->vals[j];
-                            if (val < row_scale)
-                            {
-                                row_scale = val;
-                            }
-                        }
-                    }    
-                    for (int j = row_start_off; j < row_end_off; j++)
+                    if (variables[i] == off_variables[A->off_proc->idx2[j]])
                     {
-                        col = A->off_proc->idx2[j];
-                        if (variables[i] == off_variables[col])
-                        {
-                            val = A->off_proc->vals[j];
-                            if (val < row_scale)
-                            {
-                                row_scale = val;
-                            }
-                        }
-                    } 
+                        row_scale = std::max(row_scale, sign * A->off_proc->vals[j]);
+                    }
                 }
             }
 
-
-
             // Multiply row max magnitude by theta
-            threshold = row_scale * theta;
-
-            // Always add diagonal
-            S->on_proc->idx2[S->on_proc->nnz] = i;
-            S->on_proc->vals[S->on_proc->nnz] = diag;
-            S->on_proc->nnz++;
+            double threshold = row_scale * theta;
 
-            // Add all off-diagonal entries to strength
-            // if magnitude greater than equal to 
+            // Flag all off-diagonal entries greater than 
             // row_max * theta
             if (num_variables == 1)
             {
-                if (diag < 0)
+                for (int j = row_start_on; j < row_end_on; j++)
                 {
-                    for (int j = row_start_on; j < row_end_on; j++)
-                    {
-                        val = A->on_proc->vals[j];
-                        if (val > threshold)
-                        {
-                            col = A->on_proc->idx2[j];
-                            S->on_proc->idx2[S->on_proc->nnz] = col;
-                            S->on_proc->vals[S->on_proc->nnz] = val;
-                            S->on_proc->nnz++;
-                        }
-                    }
-                    for (int j = row_start_off; j < row_end_off; j++)
-                    {
-                        val = A->off_proc->vals[j];
-                        if (val > threshold)
-                        {
-                            col = A->off_proc->idx2[j];
-                            S->off_proc->idx2[S->off_proc->nnz] = col;
-                            S->off_proc->vals[S->off_proc->nnz] = val;
-                            S->off_proc->nnz++;
-                        }
-                    }
+                    on_strong[j] = sign * A->on_proc->vals[j] > threshold;
                 }
-                else
+                for (int j = row_start_off; j < row_end_off; j++)
                 {
-                    for (int j = row_start_on; j < row_end_on; j++)
-                    {
-                        val = A->on_proc->vals[j];
-                        if (val < threshold)
-                        {
-                            col = A->on_proc->idx2[j];
-                            S->on_proc->idx2[S->on_proc->nnz] = col;
-                            S->on_proc->vals[S->on_proc->nnz] = val;
-                            S->on_proc->nnz++;
-                        }
-                    }
-                    for (int j = row_start_off; j < row_end_off; j++)
-                    {
-                        val = A->off_proc->vals[j];
-                        if (val < threshold)
-                        {
-                            col = A->off_proc->idx2[j];
-                            S->off_proc->idx2[S->off_proc->nnz] = col;
-                            S->off_proc->vals[S->off_proc->nnz] = val;
-                            S->off_proc->nnz++;
-                        }
-                    }
+                    off_strong[j] = sign * A->off_proc->vals[j] > threshold;
                 }
             }
             else
             {
-                if (diag < 0)
+                for (int j = row_start_on; j < row_end_on; j++)
                 {
-                    for (int j = row_start_on; j < row_end_on; j++)
-                    {
-                        col = A->on_proc->idx2[j];
-                        if (variables[i] == variables[col])
-                        {
-                            val = A->on_proc->vals[j];
-                            if (val > threshold)
-                            {
-                                S->on_proc->idx2[S->on_proc->nnz] = col;
-                                S->on_proc->vals[S->on_proc->nnz] = val;
-                                S->on_proc->nnz++;
-                            }
-                        }
-                    }
-                    for (int j = row_start_off; j < row_end_off; j++)
-                    {
-                        col = A->off_proc->idx2[j];
-                        if (variables[i] == off_variables[col])
-                        {
-                            val = A->off_proc->vals[j];
-                            if (val > threshold)
-                            {
-                                S->off_proc->idx2[S->off_proc->nnz] = col;
-                                S->off_proc->vals[S->off_proc->nnz] = val;
-                                S->off_proc->nnz++;
-                            }
-                        }
-                    }
+                    on_strong[j] = variables[i] == variables[A->on_proc->idx2[j]]
+                        && sign * A->on_proc->vals[j] > threshold;
                 }
-                else
+                for (int j = row_start_off; j < row_end_off; j++)
                 {
-                    for (int j = row_start_on; j < row_end_on; j++)
-                    {
-                        col = A->on_proc->idx2[j];
-                        if (variables[i] == variables[col])
-                        {
-                            val = A->on_proc->vals[j];
-                            if (val < threshold)
-                            {
-                                S->on_proc->idx2[S->on_proc->nnz] = col;
-                                S->on_proc->vals[S->on_proc->nnz] = val;
-                                S->on_proc->nnz++;
-                            }
-                        }
-                    }
-                    for (int j = row_start_off; j < row_end_off; j++)
-                    {
-                        col = A->off_proc->idx2[j];
-                        if (variables[i] == off_variables[col])
-                        {
-                            val = A->off_proc->vals[j];
-                            if (val < threshold)
-                            {
-                                S->off_proc->idx2[S->off_proc->nnz] = col;
-                                S->off_proc->vals[S->off_proc->nnz] = val;
-                                S->off_proc->nnz++;
-                            }
-                        }
-                    }
+                    off_strong[j] = variables[i] == off_variables[A->off_proc->idx2[j]]
+                        && sign * A->off_proc->vals[j] > threshold;
                 }
             }
-
         }
-        S->on_proc->idx1[i+1] = S->on_proc->nnz;
-        S->off_proc->idx1[i+1] = S->off_proc->nnz;
     }
-    S->on_proc->idx2.resize(S->on_proc->nnz);
-    S->on_proc->idx2.shrink_to_fit();
-    S->off_proc->idx2.resize(S->off_proc->nnz);
-    S->off_proc->idx2.shrink_to_fit();
-
-    S->on_proc->vals.resize(S->on_proc->nnz);
-    S->on_proc->vals.shrink_to_fit();
-    S->off_proc->vals.resize(S->off_proc->nnz);
-    S->off_proc->vals.shrink_to_fit();
-
-    S->local_nnz = S->on_proc->nnz + S->off_proc->nnz;
-
-    S->on_proc_column_map = A->get_on_proc_column_map();
-    S->local_row_map = A->get_local_row_map();
-    S->off_proc_column_map = A->get_off_proc_column_map();
-
-    S->comm = A->comm;
-    S->tap_comm = A->tap_comm;
-    S->tap_mat_comm = A->tap_mat_comm;
-
-    if (S->comm) S->comm->num_shared++;
-    if (S->tap_comm) S->tap_comm->num_shared++;
-    if (S->tap_mat_comm) S->tap_mat_comm->num_shared++;
-
-    return S;
-
 }
 
+/**************************************************************
+ *****   Symmetric Strength of Connection
+ **************************************************************
+ ***** Entry a_ij is strong if it is strong (in the classical
+ ***** sense) in either row i or row j
+ **************************************************************/
 // TODO -- currently this assumes all diags are same sign...
-ParCSRMatrix* symmetric_strength(ParCSRMatrix* A, double theta, bool tap_amg)
+static void symmetric_strength(ParCSRMatrix* A, double theta, bool tap_amg,
+        aligned_vector<char>& on_strong, aligned_vector<char>& off_strong)
 {
-    int row_start_on, row_end_on;
-    int row_start_off, row_end_off;
-    int col;
-    double val;
-    double row_scale;
-    double threshold;
-    double diag;
-
     CommPkg* comm = A->comm;
     if (tap_amg)
     {
@@ -363,185 +245,109 @@ ParCSRMatrix* symmetric_strength(ParCSRMatrix* A, double theta, bool tap_amg)
         neg_diags.resize(A->local_num_rows);
     }
 
-    ParCSRMatrix* S = new ParCSRMatrix(A->partition, A->global_num_rows, A->global_num_cols,
-            A->local_num_rows, A->on_proc_num_cols, A->off_proc_num_cols);
-    
     A->sort();
     A->on_proc->move_diag();
 
-    if (A->on_proc->nnz)
-    {
-        S->on_proc->idx2.resize(A->on_proc->nnz);
-        S->on_proc->vals.resize(A->on_proc->nnz);
-        S->on_proc->nnz = 0;
-    }
-    if (A->off_proc->nnz)
-    {
-        S->off_proc->idx2.resize(A->off_proc->nnz);
-        S->off_proc->vals.resize(A->off_proc->nnz);
-        S->off_proc->nnz = 0;
-    }
+    on_strong.assign(A->on_proc->nnz, 0);
+    off_strong.assign(A->off_proc->nnz, 0);
 
+    // Threshold of each row (theta times the value with max magnitude),
+    // with sign opposite to that of the diagonal
+#pragma omp parallel for
     for (int i = 0; i < A->local_num_rows; i++)
     {
-        row_start_on = A->on_proc->idx1[i];
-        row_end_on = A->on_proc->idx1[i+1];
-        row_start_off = A->off_proc->idx1[i];
-        row_end_off = A->off_proc->idx1[i+1];
+        int row_start_on = A->on_proc->idx1[i];
+        int row_end_on = A->on_proc->idx1[i+1];
+        int row_start_off = A->off_proc->idx1[i];
+        int row_end_off = A->off_proc->idx1[i+1];
+        neg_diags[i] = 0;
         if (row_end_on - row_start_on || row_end_off - row_start_off)
         {
-            if (A->on_proc->idx2[row_start_on] == i)
+            double diag = 0.0;
+            if (row_end_on > row_start_on && A->on_proc->idx2[row_start_on] == i)
             {
                 diag = A->on_proc->vals[row_start_on];
                 row_start_on++;
             }
-            else
-            {
-                diag = 0.0;
-            }
 
-            // Find value with max magnitude in row
-            if (diag < 0.0)
+            double sign = diag < 0.0 ? 1.0 : -1.0;
+            double row_scale = -RAND_MAX;
+            for (int j = row_start_on; j < row_end_on; j++)
             {
-                neg_diags[i] = 1;
-                row_scale = -RAND_MAX; 
-                for (int j = row_start_on; j < row_end_on; j++)
-                {
-                    val = A->on_proc->vals[j];
-                    if (val > row_scale)
-                    {
-                        row_scale = val;
-                    }
-                }    
-                for (int j = row_start_off; j < row_end_off; j++)
-                {
-                    val = A->off_proc->vals[j];
-                    if (val > row_scale)
-                    {
-                        row_scale = val;
-                    }
-                } 
+                row_scale = std::max(row_scale, sign * A->on_proc->vals[j]);
             }
-            else
+            for (int j = row_start_off; j < row_end_off; j++)
             {
-                neg_diags[i] = 0;
-                row_scale = RAND_MAX;
-                for (int j = row_start_on; j < row_end_on; j++)
-                {
-                    val = A->on_proc->vals[j];
-                    if (val < row_scale)
-                    {
-                        row_scale = val;
-                    }
-                }    
-                for (int j = row_start_off; j < row_end_off; j++)
-                {
-                    val = A->off_proc->vals[j];
-                    if (val < row_scale)
-                    {
-                        row_scale = val;
-                    }
-                } 
+                row_scale = std::max(row_scale, sign * A->off_proc->vals[j]);
             }
 
-            // Multiply row max magnitude by theta
-            row_scales[i] = row_scale * theta;
+            neg_diags[i] = diag < 0.0;
+            row_scales[i] = sign * row_scale * theta;
         }
     }
 
     aligned_vector<double>& off_proc_row_scales = comm->communicate(row_scales);
     aligned_vector<int>& off_proc_neg_diags = comm->communicate(neg_diags);
     
-    S->on_proc->idx1[0] = 0;
-    S->off_proc->idx1[0] = 0;
+    // Entries are strong if strong in either their row or column
+#pragma omp parallel for
     for (int i = 0; i < A->local_num_rows; i++)
     {
-        row_start_on = A->on_proc->idx1[i];
-        row_end_on = A->on_proc->idx1[i+1];
-        row_start_off = A->off_proc->idx1[i];
-        row_end_off = A->off_proc->idx1[i+1];
-        if (row_end_on - row_start_on || row_end_off - row_start_off)
+        int row_start_on = A->on_proc->idx1[i];
+        int row_end_on = A->on_proc->idx1[i+1];
+        int row_start_off = A->off_proc->idx1[i];
+        int row_end_off = A->off_proc->idx1[i+1];
+        if (row_end_on > row_start_on && A->on_proc->idx2[row_start_on] == i)
         {
-            bool neg_diag = neg_diags[i];           
-            threshold = row_scales[i];
-
-            // Always add diagonal
-            S->on_proc->idx2[S->on_proc->nnz] = i;
-            S->on_proc->vals[S->on_proc->nnz] = A->on_proc->vals[row_start_on++];
-            S->on_proc->nnz++;
+            row_start_on++;
+        }
 
-            // Add all off-diagonal entries to strength
-            // if magnitude greater than equal to 
-            // row_max * theta
-            for (int j = row_start_on; j < row_end_on; j++)
-            {
-                val = A->on_proc->vals[j];
-                col = A->on_proc->idx2[j];
-                if ((neg_diag && val > threshold) || (!neg_diag && val < threshold) 
-                        || (neg_diags[col] && val > row_scales[col])
-                        || (!neg_diags[col] && val < row_scales[col]))
-                {
-                    S->on_proc->idx2[S->on_proc->nnz] = col;
-                    S->on_proc->vals[S->on_proc->nnz] = val;
-                    S->on_proc->nnz++;
-                }
-            }
-            for (int j = row_start_off; j < row_end_off; j++)
-            {
-                val = A->off_proc->vals[j];
-                col = A->off_proc->idx2[j];
-                if ((neg_diag && val > threshold) || (!neg_diag && val < threshold)
-                        || (off_proc_neg_diags[col] && val > off_proc_row_scales[col])
-                        || (!off_proc_neg_diags[col] && val < off_proc_row_scales[col]))
-                {
-                    S->off_proc->idx2[S->off_proc->nnz] = col;
-                    S->off_proc->vals[S->off_proc->nnz] = val;
-                    S->off_proc->nnz++;
-                }
-            }                    
+        double sign = neg_diags[i] ? 1.0 : -1.0;
+        double threshold = sign * row_scales[i];
+        for (int j = row_start_on; j < row_end_on; j++)
+        {
+            double val = A->on_proc->vals[j];
+            int col = A->on_proc->idx2[j];
+            double col_sign = neg_diags[col] ? 1.0 : -1.0;
+            on_strong[j] = (sign * val > threshold) 
+                | (col_sign * val > col_sign * row_scales[col]);
         }
-        S->on_proc->idx1[i+1] = S->on_proc->nnz;
-        S->off_proc->idx1[i+1] = S->off_proc->nnz;
+        for (int j = row_start_off; j < row_end_off; j++)
+        {
+            double val = A->off_proc->vals[j];
+            int col = A->off_proc->idx2[j];
+            double col_sign = off_proc_neg_diags[col] ? 1.0 : -1.0;
+            off_strong[j] = (sign * val > threshold)
+                | (col_sign * val > col_sign * off_proc_row_scales[col]);
+        }                    
     }
-    S->on_proc->idx2.resize(S->on_proc->nnz);
-    S->on_proc->idx2.shrink_to_fit();
-    S->off_proc->idx2.resize(S->off_proc->nnz);
-    S->off_proc->idx2.shrink_to_fit();
-
-    S->on_proc->vals.resize(S->on_proc->nnz);
-    S->on_proc->vals.shrink_to_fit();
-    S->off_proc->vals.resize(S->off_proc->nnz);
-    S->off_proc->vals.shrink_to_fit();
-
-    S->local_nnz = S->on_proc->nnz + S->off_proc->nnz;
-
-    S->on_proc_column_map = A->get_on_proc_column_map();
-    S->local_row_map = A->get_local_row_map();
-    S->off_proc_column_map = A->get_off_proc_column_map();
-
-    S->comm = A->comm;
-    S->tap_comm = A->tap_comm;
-    S->tap_mat_comm = A->tap_mat_comm;
-
-    if (S->comm) S->comm->num_shared++;
-    if (S->tap_comm) S->tap_comm->num_shared++;
-    if (S->tap_mat_comm) S->tap_mat_comm->num_shared++;
-
-    return S;
 }
 
 
 // Assumes ParCSRMatrix is previously sorted
 // TODO -- have ParCSRMatrix bool sorted (and sort if not previously)
-ParCSRMatrix* ParCSRMatrix::strength(strength_t strength_type,
-        double theta, bool tap_amg, int num_variables, int* variables)
+void ParCSRMatrix::strength_mask(strength_t strength_type, aligned_vector<char>& on_strong,
+        aligned_vector<char>& off_strong, double theta, bool tap_amg, 
+        int num_variables, int* variables)
 {
     switch (strength_type)
     {
         case Classical:
-            return classical_strength(this, theta, tap_amg, num_variables, variables);
+            classical_strength(this, theta, tap_amg, num_variables, variables,
+                    on_strong, off_strong);
+            break;
         case Symmetric:
-            return symmetric_strength(this, theta, tap_amg);
+            symmetric_strength(this, theta, tap_amg, on_strong, off_strong);
+            break;
     }
 }
 
+ParCSRMatrix* ParCSRMatrix::strength(strength_t strength_type,
+        double theta, bool tap_amg, int num_variables, int* variables)
+{
+    aligned_vector<char> on_strong;
+    aligned_vector<char> off_strong;
+    strength_mask(strength_type, on_strong, off_strong, theta, tap_amg,
+            num_variables, variables);
+    return compact_strength(this, on_strong, off_strong);
+}
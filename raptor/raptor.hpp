@@ -16,9 +16,12 @@
 // Matrix and vector classes
 #include "core/matrix.hpp"
 #include "core/vector.hpp"
+#include "core/index_map.hpp"
 #ifndef NO_MPI
     #include "core/par_matrix.hpp"
     #include "core/par_vector.hpp"
+    #include "core/par_sp_matrix.hpp"
+    #include "core/repro_sum.hpp"
 #endif 
 
 // Communication classes
@@ -93,6 +96,12 @@
 #include "krylov/par_cg.hpp"
 #include "krylov/bicgstab.hpp"
 #include "krylov/par_bicgstab.hpp"
+#include "krylov/par_sstep.hpp"
+#include "krylov/par_gmres.hpp"
+#include "krylov/par_refinement.hpp"
+#include "krylov/par_reduction.hpp"
+#include "krylov/par_bicgstab_l.hpp"
+#include "krylov/par_idr.hpp"
 
 // Relaxation methods
 #include "util/linalg/relax.hpp"
@@ -30,6 +30,28 @@ CSRMatrix* extended_interpolation(CSRMatrix* A, CSRMatrix* S,
     A->move_diag();
     S->sort();
     S->move_diag();
+
+    // Copy entries of A into sparsity pattern of S
+    aligned_vector<double> sa;
+    if (S->nnz)
+    {
+        sa.resize(S->nnz);
+    }
+    for (int i = 0; i < A->n_rows; i++)
+    {
+        startS = S->idx1[i];
+        endS = S->idx1[i+1];
+        ctr = A->idx1[i];
+        for (int j = startS; j < endS; j++)
+        {
+            col = S->idx2[j];
+            while (A->idx2[ctr] != col)
+            {
+                ctr++;
+            }
+            sa[j] = A->vals[ctr];
+        }
+    }
     
     aligned_vector<int> col_to_new;
     if (A->n_cols)
@@ -68,7 +90,7 @@ CSRMatrix* extended_interpolation(CSRMatrix* A, CSRMatrix* S,
         for (int j = startS; j < endS; j++)
         {
             col = S->idx2[j];
-            val = S->vals[j];
+            val = sa[j];
             if (states[col] == Selected)
             {
                 if (pos[col] < row_start)
@@ -133,7 +155,7 @@ CSRMatrix* extended_interpolation(CSRMatrix* A, CSRMatrix* S,
         for (int j = startS; j < endS; j++)
         {
             col = S->idx2[j];
-            val = S->vals[S->idx1[col]]; // A_(col,col)
+            val = sa[S->idx1[col]]; // A_(col,col)
             sign = 1;
             if (val < 0) sign = -1;
 
@@ -157,11 +179,11 @@ CSRMatrix* extended_interpolation(CSRMatrix* A, CSRMatrix* S,
 
                 if (fabs(coarse_sum) < zero_tol)
                 {
-                    weak_sum += S->vals[j];
+                    weak_sum += sa[j];
                 }
                 else
                 {
-                    coarse_sum = S->vals[j] / coarse_sum;
+                    coarse_sum = sa[j] / coarse_sum;
                 }
 
                 start_k = A->idx1[col]+1;
@@ -494,6 +494,101 @@ int select_independent_set(const ParCSRMatrix* S,
     return num_new_coarse;
 }
 
+/**************************************************************
+ *****   Select Local Independent Set
+ **************************************************************
+ ***** Local-only PMIS rounds, performed between exchanges.
+ ***** Interior points (no strong connections to or from other
+ ***** processes) are selected once their weight is the max
+ ***** among unassigned neighbors, and unassigned points strongly
+ ***** depending on them are marked NewUnselection.  Rounds are
+ ***** repeated until no interior point is selected.
+ *****
+ ***** Selecting a point as soon as it is the max among unassigned
+ ***** neighbors gives the same splitting as synchronous rounds, so
+ ***** the result is unchanged.  Boundary points are only ever
+ ***** unselected here, and are communicated with the remainder of
+ ***** the round (neighbors holding a stale Unassigned state only
+ ***** wait on them).
+ **************************************************************/
+int select_local_independent_set(const ParCSRMatrix* S,
+        const int remaining,
+        const aligned_vector<int>& unassigned,
+        const aligned_vector<int>& interior,
+        const aligned_vector<double>& weights,
+        const aligned_vector<int>& on_col_ptr,
+        const aligned_vector<int>& on_col_indices,
+        aligned_vector<int>& states)
+{
+    int start, end, idx;
+    int j, u;
+    int num_new, num_new_coarse;
+    double weight;
+
+    num_new_coarse = 0;
+    do
+    {
+        num_new = 0;
+        for (int i = 0; i < remaining; i++)
+        {
+            u = unassigned[i];
+            if (!interior[u] || states[u] != Unassigned) continue;
+            weight = weights[u];
+
+            // Compare to unassigned neighbors in row of S
+            start = S->on_proc->idx1[u];
+            end = S->on_proc->idx1[u+1];
+            if (start < end && S->on_proc->idx2[start] == u)
+            {
+                start++;
+            }
+            for (j = start; j < end; j++)
+            {
+                idx = S->on_proc->idx2[j];
+                if (states[idx] == Unassigned && weights[idx] > weight)
+                {
+                    break;
+                }
+            }
+            if (j != end)
+            {
+                continue;
+            }
+
+            // Compare to unassigned neighbors in column of S
+            start = on_col_ptr[u];
+            end = on_col_ptr[u+1];
+            for (j = start; j < end; j++)
+            {
+                idx = on_col_indices[j];
+                if (states[idx] == Unassigned && weights[idx] > weight)
+                {
+                    break;
+                }
+            }
+            if (j != end)
+            {
+                continue;
+            }
+
+            // Select u, and unselect points depending on u
+            states[u] = NewSelection;
+            for (j = start; j < end; j++)
+            {
+                idx = on_col_indices[j];
+                if (states[idx] == Unassigned)
+                {
+                    states[idx] = NewUnselection;
+                }
+            }
+            num_new++;
+        }
+        num_new_coarse += num_new;
+    } while (num_new);
+
+    return num_new_coarse;
+}
+
 void update_row_weights(const ParCSRMatrix* S,
         const int num_new_coarse,
         const aligned_vector<int>& new_coarse_list,
@@ -931,242 +1026,48 @@ int find_off_proc_states(CommPkg* comm,
     return num_new_coarse;
 }
 
+/**************************************************************
+ *****   Find Off Proc New Coarse
+ **************************************************************
+ ***** For each (unassigned, unless first_pass) off_proc column
+ ***** of S, lists the new coarse points among the strong
+ ***** connections in its row, as local columns of S (off_proc
+ ***** columns shifted by on_proc_num_cols).  The rows are
+ ***** fetched once, so each round only reads current states.
+ **************************************************************/
 void find_off_proc_new_coarse(const ParCSRMatrix* S,
-        CommPkg* comm,
-        const std::map<int, int>& global_to_local,
+        const ParNeighborRows& neighbor_rows,
         const aligned_vector<int>& states,
         const aligned_vector<int>& off_proc_states,
-        const int* part_to_col,
         aligned_vector<int>& off_proc_col_ptr,
         aligned_vector<int>& off_proc_col_coarse,
         bool first_pass = false)
 {
-    int start, end;
-    int idx, idx_k;
-    int size;
-    int idx_start, idx_end;
-    int proc, count, buf_ptr;
-    int ctr;
-    int tag = 2999;
-    int global_col;
-    int n_sends = 0;
-    int msg_avail;
-    RAPtor_MPI_Status recv_status;
-
-    aligned_vector<int> send_ptr;
-    aligned_vector<int> send_buffer;
-    aligned_vector<int> recv_buffer;
+    int col, state;
+    CSRMatrix* rows = neighbor_rows.rows;
 
     off_proc_col_coarse.clear();
-    int off_proc_num_cols = off_proc_states.size();
-
-    if (first_pass)
-    {
-        send_ptr.resize(S->local_num_rows + 1);
-
-        // For each row in send_data, find if any new coarse
-        // points in row.  If so, add to buffer.  Let buffer_ptr
-        // point to the beginning/end of each send_data msg
-        send_ptr[0] = 0;
-        for (int i = 0; i < S->local_num_rows; i++)
-        {
-            start = S->on_proc->idx1[i];
-            end = S->on_proc->idx1[i+1];
-            if (S->on_proc->idx2[idx_start] == idx)
-            {
-                start++;
-            }
-            for (int j = start; j < end; j++)
-            {
-                idx = S->on_proc->idx2[j];
-                if (states[idx] == NewSelection)
-                {
-                    send_buffer.emplace_back(S->on_proc_column_map[idx]);
-                }
-            }
-            start = S->off_proc->idx1[i];
-            end = S->off_proc->idx1[i+1];
-            for (int j = start; j < end; j++)
-            {
-                idx = S->off_proc->idx2[j];
-                if (off_proc_states[idx] == NewSelection)
-                {
-                    send_buffer.emplace_back(S->off_proc_column_map[idx]);
-                }
-            }
-            send_ptr[i+1] =  send_buffer.size();
-        }
-
-        aligned_vector<double> vals;
-        CSRMatrix* recv_mat = comm->communicate(send_ptr, send_buffer, vals, 1, 1, false); 
-
-        off_proc_col_ptr[0] = 0;
-        for (int i = 0; i < off_proc_num_cols; i++)
-        {
-            start = recv_mat->idx1[i];
-            end = recv_mat->idx1[i+1];
-            for (int j = start; j < end; j++)
-            {
-                global_col = recv_mat->idx2[j];
-                if (global_col >= S->partition->first_local_col 
-                        && global_col <= S->partition->last_local_col)
-                {
-                    off_proc_col_coarse.emplace_back(part_to_col[global_col -
-                            S->partition->first_local_col]);
-                }
-                else
-                {
-                    std::map<int, int>::const_iterator ptr = 
-                    global_to_local.find(global_col);
-                    if (ptr != global_to_local.end())
-                    {
-                        off_proc_col_coarse.emplace_back(ptr->second + S->on_proc_num_cols);
-                    }   
-                }
-            }
-            off_proc_col_ptr[i+1] = off_proc_col_coarse.size();
-        }   
-        delete recv_mat;
-    }
-    else
+    off_proc_col_ptr[0] = 0;
+    for (int i = 0; i < S->off_proc_num_cols; i++)
     {
-        // Clear out any previous data from off_proc_col_coarse
-        //off_proc_col_coarse.clear();
-
-        send_ptr.resize(S->comm->send_data->num_msgs + 1);
-
-        // For each row in send_data, find if any new coarse
-        // points in row.  If so, add to buffer.  Let buffer_ptr
-        // point to the beginning/end of each send_data msg
-        send_ptr[0] = 0;
-        for (int i = 0; i < S->comm->send_data->num_msgs; i++)
-        {
-            start = S->comm->send_data->indptr[i];
-            end = S->comm->send_data->indptr[i+1];
-            for (int j = start; j < end; j++)
-            {
-                idx = S->comm->send_data->indices[j];
-                if (states[idx] == Unassigned)
-                {
-                    // Assuming num coarse in row is zero, 
-                    // but will update later
-                    buf_ptr = send_buffer.size();
-                    send_buffer.emplace_back(0);
-
-                    // Iterate through row
-                    idx_start = S->on_proc->idx1[idx];
-                    idx_end = S->on_proc->idx1[idx+1];
-                    if (S->on_proc->idx2[idx_start] == idx)
-                    {
-                        idx_start++;
-                    }
-                    for (int k = idx_start; k < idx_end; k++)
-                    {
-                        idx_k = S->on_proc->idx2[k];
-                        if (states[idx_k] == NewSelection)
-                        {
-                            // New coarse, so add global idx to buffer
-                            send_buffer.emplace_back(S->on_proc_column_map[idx_k]);
-                        }
-                    }
-                    idx_start = S->off_proc->idx1[idx];
-                    idx_end = S->off_proc->idx1[idx+1];
-                    for (int k = idx_start; k < idx_end; k++)
-                    {
-                        idx_k = S->off_proc->idx2[k];
-                        if (off_proc_states[idx_k] == NewSelection)
-                        {
-                            // New coarse, so add global idx to buffer
-                            send_buffer.emplace_back(S->off_proc_column_map[idx_k]);
-                        }
-                    }
-                    // Update buffer[ptr] with the number of coarse points
-                    // influenced by idx 
-                    send_buffer[buf_ptr] = send_buffer.size() - buf_ptr - 1;
-                }
-            }
-            // Update buffer ptr (for send size)
-            send_ptr[i+1] = send_buffer.size();
-        }
-     
-        // Send coarse indices associated with each send idx
-        // to appropriate procs
-        for (int i = 0; i < S->comm->send_data->num_msgs; i++)
-        {
-            proc = S->comm->send_data->procs[i];
-            start = send_ptr[i];
-            end = send_ptr[i+1];
-            if (end - start)
-            {
-                RAPtor_MPI_Isend(&(send_buffer[start]), end - start, RAPtor_MPI_INT, proc,
-                        tag, RAPtor_MPI_COMM_WORLD, &(S->comm->send_data->requests[n_sends++]));
-            }
-        }
-
-        // Recv coarse indices influence by each off_proc column
-        off_proc_col_ptr[0] = 0;
-        for (int i = 0; i < S->comm->recv_data->num_msgs; i++)
+        if (first_pass || off_proc_states[i] == Unassigned)
         {
-            msg_avail = false;
-            proc = S->comm->recv_data->procs[i];
-            start = S->comm->recv_data->indptr[i];
-            end = S->comm->recv_data->indptr[i+1];
-
-            for (int j = start; j < end; j++)
-            {
-                if (off_proc_states[j] == Unassigned)
-                {
-                    msg_avail = true;
-                    break;
-                }
-            }
-            if (msg_avail)
+            for (int j = rows->idx1[i]; j < rows->idx1[i+1]; j++)
             {
-                RAPtor_MPI_Probe(proc, tag, RAPtor_MPI_COMM_WORLD, &recv_status);
-                RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INT, &count);
-
-                if ((int) recv_buffer.size() < count)
-                {
-                    recv_buffer.resize(count);
-                }
-                RAPtor_MPI_Recv(&recv_buffer[0], count, RAPtor_MPI_INT, proc, tag, RAPtor_MPI_COMM_WORLD,
-                        &recv_status);
-            }
-            ctr = 0;
-            for (int j = start; j < end; j++)
-            {
-                if (off_proc_states[j] == Unassigned)
+                col = neighbor_rows.local_cols[j];
+                if (col < 0) continue;
+
+                if (col < S->on_proc_num_cols)
+                    state = states[col];
+                else 
+                    state = off_proc_states[col - S->on_proc_num_cols];
+                if (state == NewSelection)
                 {
-                    size = recv_buffer[ctr++];
-                    for (int k = 0; k < size; k++)
-                    {
-                        global_col = recv_buffer[ctr++];
-                        if (global_col >= S->partition->first_local_col 
-                                && global_col <= S->partition->last_local_col)
-                        {
-                            off_proc_col_coarse.emplace_back(part_to_col[global_col -
-                                    S->partition->first_local_col]);
-                        }
-                        else
-                        {
-                            std::map<int, int>::const_iterator ptr = 
-                            global_to_local.find(global_col);
-                            if (ptr != global_to_local.end())
-                            {
-                                off_proc_col_coarse.emplace_back(ptr->second + S->on_proc_num_cols);
-                            }   
-                        }
-                    }
+                    off_proc_col_coarse.emplace_back(col);
                 }
-                off_proc_col_ptr[j+1] = off_proc_col_coarse.size();
             }
         }
-
-        // Wait for sends to complete
-        if (n_sends)
-        {
-            RAPtor_MPI_Waitall(n_sends, S->comm->send_data->requests.data(), RAPtor_MPI_STATUSES_IGNORE);
-        }
+        off_proc_col_ptr[i+1] = off_proc_col_coarse.size();
     }
 }
 
@@ -1226,7 +1127,7 @@ int update_states(aligned_vector<double>& weights,
     return ctr;
 }
 
-void pmis_main_loop(ParCSRMatrix* S,
+int pmis_main_loop(ParCSRMatrix* S,
         aligned_vector<int>& states,
         aligned_vector<int>& off_proc_states,
         bool tap_comm, double* rand_vals)
@@ -1236,6 +1137,8 @@ void pmis_main_loop(ParCSRMatrix* S,
     int num_new_coarse;
     int num_remaining;
     int num_remaining_off;
+    int num_rounds;
+    aligned_vector<int> interior;
     aligned_vector<double> off_proc_weights;
     aligned_vector<double> max_weights;
     aligned_vector<int> new_coarse_list;
@@ -1269,6 +1172,23 @@ void pmis_main_loop(ParCSRMatrix* S,
 
     initial_weights(S, comm, weights, rand_vals);
 
+    // Interior points can be assigned in local rounds
+    if (S->local_num_rows)
+    {
+        interior.resize(S->local_num_rows, 1);
+    }
+    for (int i = 0; i < S->local_num_rows; i++)
+    {
+        if (S->off_proc->idx1[i+1] - S->off_proc->idx1[i])
+        {
+            interior[i] = 0;
+        }
+    }
+    for (int i = 0; i < S->comm->send_data->size_msgs; i++)
+    {
+        interior[S->comm->send_data->indices[i]] = 0;
+    }
+
     // Find remaining vertices in on and off proc matrices
     num_remaining = 0;
 
@@ -1323,6 +1243,11 @@ void pmis_main_loop(ParCSRMatrix* S,
     find_off_proc_weights(comm, states, off_proc_states, 
             weights, off_proc_weights, first_pass);
 
+    // Rounds end once all local points, and all off_proc points
+    // (strongly connected neighbors), are assigned.  Only states of
+    // unassigned points are communicated, so processes that finish
+    // early drop out of the exchanges.
+    num_rounds = 0;
     while (num_remaining || num_remaining_off || first_pass)
     {
         // Find max unassigned weight in each row / column
@@ -1369,6 +1294,10 @@ void pmis_main_loop(ParCSRMatrix* S,
             }       
         }
 
+        // Assign interior points without communication
+        select_local_independent_set(S, num_remaining, unassigned, interior,
+                weights, on_col_ptr, on_col_indices, states);
+
         find_off_proc_states(comm, states, off_proc_states, first_pass);
 
         num_remaining = update_states(weights, states, num_remaining, unassigned);
@@ -1377,7 +1306,10 @@ void pmis_main_loop(ParCSRMatrix* S,
 
         first_pass = false;
         comm = S->comm;
+        num_rounds++;
     }
+
+    return num_rounds;
 }
 
 void cljp_main_loop(ParCSRMatrix* S,
@@ -1412,7 +1344,6 @@ void cljp_main_loop(ParCSRMatrix* S,
     aligned_vector<int> off_proc_col_coarse;
     aligned_vector<int> off_proc_weight_updates;
     aligned_vector<int> off_proc_col_ptr;
-    std::map<int, int> global_to_local;
     aligned_vector<int> new_coarse_list;
     aligned_vector<int> off_new_coarse_list;
     aligned_vector<int> unassigned;
@@ -1431,8 +1362,6 @@ void cljp_main_loop(ParCSRMatrix* S,
     int msg_avail;
     RAPtor_MPI_Status recv_status;
 
-    int* part_to_col = S->map_partition_to_local();
-
     if (S->local_num_rows)
     {
         weights.resize(S->local_num_rows, 0);
@@ -1465,10 +1394,8 @@ void cljp_main_loop(ParCSRMatrix* S,
     }
     off_proc_col_ptr.resize(S->off_proc_num_cols + 1);
 
-    for (int i = 0; i < S->off_proc_num_cols; i++)
-    {
-        global_to_local[S->off_proc_column_map[i]] = i;
-    }
+    // Rows of S for each off_proc column, fetched once for all rounds
+    ParNeighborRows neighbor_rows(S, NULL, mat_comm);
 
     initial_weights(S, comm, weights, rand_vals);
 
@@ -1560,9 +1487,8 @@ void cljp_main_loop(ParCSRMatrix* S,
         }
 
         // Find new coarse influenced by each off_proc col
-        // TODO -- Add first pass option
-        find_off_proc_new_coarse(S, mat_comm, global_to_local, states, off_proc_states, 
-                part_to_col, off_proc_col_ptr, off_proc_col_coarse, first_pass);
+        find_off_proc_new_coarse(S, neighbor_rows, states, off_proc_states, 
+                off_proc_col_ptr, off_proc_col_coarse, first_pass);
 
         // Update Weights
         for (int i = 0; i < S->off_proc_num_cols; i++)
@@ -1601,7 +1527,47 @@ void cljp_main_loop(ParCSRMatrix* S,
         first_pass = false;
         comm = S->comm;
     }
-
-    delete[] part_to_col;
 }
 
+
+/**************************************************************
+ *****   Distance-Two Strength
+ **************************************************************
+ ***** Returns the (pattern-only) strength matrix between the
+ ***** coarse points injected by T, used for the second stage of
+ ***** aggressive coarsening : coarse points i and j are strongly
+ ***** connected if j is reached from i by a path of at most two
+ ***** strong connections in S (through any point).  Formed as
+ ***** T^T * S * S * T, with S including its diagonal.
+ **************************************************************/
+ParCSRMatrix* distance_two_strength(ParCSRMatrix* S, ParCSRMatrix* T, bool tap_cf)
+{
+    // Strength of connection with unit values
+    ParCSRMatrix* S1 = S->copy();
+    S1->on_proc->vals.assign(S1->on_proc->nnz, 1.0);
+    S1->off_proc->vals.assign(S1->off_proc->nnz, 1.0);
+
+    ParCSRMatrix* ST = S1->mult(T);
+    ParCSRMatrix* SST = S1->mult(ST);
+    ParCSRMatrix* S2 = SST->mult_T(T);
+    delete S1;
+    delete ST;
+    delete SST;
+
+    // Only the pattern (and not the number of paths) is kept
+    S2->sort();
+    S2->on_proc->move_diag();
+    S2->on_proc->vals.clear();
+    S2->on_proc->vals.shrink_to_fit();
+    S2->off_proc->vals.clear();
+    S2->off_proc->vals.shrink_to_fit();
+
+    S2->comm = new ParComm(S2->partition, S2->off_proc_column_map,
+            S2->on_proc_column_map, S->comm->key, S->comm->mpi_comm);
+    if (tap_cf)
+    {
+        S2->init_tap_communicators(S2->partition->topology->comm);
+    }
+
+    return S2;
+}
@@ -6,6 +6,7 @@
 #include "core/types.hpp"
 #include "core/par_matrix.hpp"
 #include "cf_splitting.hpp"
+#include "par_neighbor_rows.hpp"
 
 using namespace raptor;
 
@@ -15,7 +16,7 @@ void reset_boundaries(ParCSRMatrix* S, aligned_vector<int>& states);
 void cljp_main_loop(ParCSRMatrix* S, aligned_vector<int>& states,
         aligned_vector<int>& off_proc_states, bool tap_comm = false,
         double* rand_vals = NULL);
-void pmis_main_loop(ParCSRMatrix* S, aligned_vector<int>& states,
+int pmis_main_loop(ParCSRMatrix* S, aligned_vector<int>& states,
         aligned_vector<int>& off_proc_states, bool tap_comm = false,
         double* rand_vals = NULL);
 
@@ -37,4 +38,7 @@ void split_pmis(ParCSRMatrix* S, aligned_vector<int>& states,
 void split_hmis(ParCSRMatrix* S, aligned_vector<int>& states,
         aligned_vector<int>& off_proc_states, bool tap_cf = false, 
         double* rand_vals = NULL);
+
+ParCSRMatrix* distance_two_strength(ParCSRMatrix* S, ParCSRMatrix* T, 
+        bool tap_cf = false);
 #endif
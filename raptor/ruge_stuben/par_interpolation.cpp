@@ -3,175 +3,10 @@
 #include "assert.h"
 #include "core/types.hpp"
 #include "core/par_matrix.hpp"
+#include "ruge_stuben/par_neighbor_rows.hpp"
 
 using namespace raptor;
 
-// TODO -- if in S, col is positive, otherwise col is -(col+1)
-CSRMatrix* communicate(ParCSRMatrix* A, ParCSRMatrix* S, const aligned_vector<int>& states,
-        const aligned_vector<int>& off_proc_states, CommPkg* comm)
-{
-    int start, end, col;
-    int ctr_S, end_S, global_col;
-    int tmp_col, sign;
-    double diag, val;
-
-    aligned_vector<int> rowptr(A->local_num_rows + 1);
-    aligned_vector<int> col_indices;
-    aligned_vector<double> values;
-    if (A->local_nnz)
-    {
-        col_indices.reserve(A->local_nnz);
-        values.reserve(A->local_nnz);
-    }
-    rowptr[0] = 0;
-    for (int i = 0; i < A->local_num_rows; i++)
-    {
-        start = A->on_proc->idx1[i];
-        end = A->on_proc->idx1[i+1];
-        ctr_S = S->on_proc->idx1[i]+1;
-        end_S = S->on_proc->idx1[i+1];
-
-        diag = A->on_proc->vals[start++];
-        if (diag > 0) sign = 1;
-        else sign = -1;
-
-        for (int j = start; j < end; j++)
-        {
-            col = A->on_proc->idx2[j];
-            val = A->on_proc->vals[j];
-            if (states[col] == Selected)
-            {
-                global_col = A->on_proc_column_map[col];
-                if (ctr_S < end_S && S->on_proc->idx2[ctr_S] == col)
-                {
-                    if (val * sign < 0) // Only add needed cols
-                    {
-                        col_indices.push_back(-(global_col+1));
-                        values.push_back(val);
-                    }
-                    ctr_S++;
-                }
-                else
-                {
-                    if (val * sign < 0) // Only add needed cols
-                    {
-                        col_indices.push_back(global_col);
-                        values.push_back(val);
-                    }
-                }
-            }
-            else if (ctr_S < end_S && S->on_proc->idx2[ctr_S] == col)
-            {
-                ctr_S++;
-            }
-        }
-
-        start = A->off_proc->idx1[i];
-        end = A->off_proc->idx1[i+1];
-        ctr_S = S->off_proc->idx1[i];
-        end_S = S->off_proc->idx1[i+1];
-        for (int j = start; j < end; j++)
-        {
-            col = A->off_proc->idx2[j];
-            val = A->off_proc->vals[j];
-            if (off_proc_states[col] == NoNeighbors) continue;
-
-            global_col = A->off_proc_column_map[col];
-
-            if (off_proc_states[col] == Unselected) // Add for +i possibility
-            {
-                if (val * sign < 0) // Only add needed cols
-                {
-                    global_col += A->partition->global_num_cols;
-                    col_indices.push_back(global_col);
-                    values.push_back(val);
-                }
-                if (ctr_S < end_S && S->off_proc->idx2[ctr_S] == col)
-                {
-                    ctr_S++;
-                }
-            }
-            else if (ctr_S < end_S && S->off_proc->idx2[ctr_S] == col) 
-            {
-                // Selected and in S
-                if (val * sign < 0) //Only add needed cols 
-                {
-                    col_indices.push_back(-(global_col+1));
-                    values.push_back(val);
-                }
-                ctr_S++;
-            }
-            else
-            {
-                // Selected weak connection
-                if (val * sign < 0)
-                {
-                    col_indices.push_back(global_col);
-                    values.push_back(val);
-                }
-            }
-        }
-        rowptr[i+1] = col_indices.size();
-    }
-
-    return comm->communicate(rowptr, col_indices, values);
-   
-}
-
-
-CSRMatrix*  communicate(ParCSRMatrix* A, const aligned_vector<int>& states,
-        const aligned_vector<int>& off_proc_states, CommPkg* comm)
-{
-    int start, end, col;
-    int sign;
-    double val;
-
-    aligned_vector<int> rowptr(A->local_num_rows + 1);
-    aligned_vector<int> col_indices;
-    aligned_vector<double> values;
-    if (A->local_nnz)
-    {
-        col_indices.reserve(A->local_nnz);
-        values.reserve(A->local_nnz);
-    }
-
-    rowptr[0] = 0;
-    for (int i = 0; i < A->local_num_rows; i++)
-    {
-        start = A->on_proc->idx1[i];
-        end = A->on_proc->idx1[i+1];
-        val = A->on_proc->vals[start++];
-        if (val > 0) sign = 1;
-        else sign = -1;
-
-        for (int j = start; j < end; j++)
-        {
-            col = A->on_proc->idx2[j];
-            val = A->on_proc->vals[j];
-            if (states[col] == 1 && val * sign < 0)
-            {
-                col_indices.push_back(A->on_proc_column_map[col]);
-                values.push_back(A->on_proc->vals[j]);
-            }
-        }
-        start = A->off_proc->idx1[i];
-        end = A->off_proc->idx1[i+1];
-        for (int j = start; j < end; j++)
-        {
-            col = A->off_proc->idx2[j];
-            val = A->off_proc->vals[j];
-            if (off_proc_states[col] == 1 && val * sign < 0)
-            {
-                col_indices.push_back(A->off_proc_column_map[col]);
-                values.push_back(A->off_proc->vals[j]);
-            }
-        }
-        rowptr[i+1] = col_indices.size();
-    }
-
-    return comm->communicate(rowptr, col_indices, values);
-}
-
 void filter_interp(ParCSRMatrix* P, const double filter_threshold)
 {
     int row_start_on = 0;
@@ -276,12 +111,181 @@ void filter_interp(ParCSRMatrix* P, const double filter_threshold)
     P->off_proc->vals.shrink_to_fit();
 }
 
+void truncate_interp(ParCSRMatrix* P, const double trunc_factor, const int max_elmts)
+{
+    if (trunc_factor <= 0 && max_elmts <= 0) return;
+
+    int row_start_on = 0;
+    int row_start_off = 0;
+    int row_end_on, row_end_off;
+    int row_size, num_ties;
+    int ctr_on = 0;
+    int ctr_off = 0;
+    int prev_ctr_on, prev_ctr_off;
+
+    double val, abs_val;
+    double row_max, row_sum, row_scale;
+    double remain_sum, min_kept;
+
+    aligned_vector<double> row_abs;
+
+    for (int i = 0; i < P->local_num_rows; i++)
+    {
+        prev_ctr_on = ctr_on;
+        prev_ctr_off = ctr_off;
+
+        row_end_on = P->on_proc->idx1[i+1];
+        row_end_off = P->off_proc->idx1[i+1];
+        row_size = (row_end_on - row_start_on) + (row_end_off - row_start_off);
+
+        // Entries are kept if they are at least trunc_factor * row_max
+        row_max = 0;
+        for (int j = row_start_on; j < row_end_on; j++)
+        {
+            abs_val = fabs(P->on_proc->vals[j]);
+            if (abs_val > row_max)
+                row_max = abs_val;
+        }
+        for (int j = row_start_off; j < row_end_off; j++)
+        {
+            abs_val = fabs(P->off_proc->vals[j]);
+            if (abs_val > row_max)
+                row_max = abs_val;
+        }
+        row_max *= trunc_factor;
+
+        // ... and among the max_elmts largest (in magnitude), with ties
+        // broken by position in the row
+        min_kept = 0;
+        num_ties = row_size;
+        if (max_elmts > 0 && row_size > max_elmts)
+        {
+            row_abs.resize(row_size);
+            for (int j = row_start_on; j < row_end_on; j++)
+                row_abs[j - row_start_on] = fabs(P->on_proc->vals[j]);
+            for (int j = row_start_off; j < row_end_off; j++)
+                row_abs[row_end_on - row_start_on + j - row_start_off]
+                    = fabs(P->off_proc->vals[j]);
+            std::nth_element(row_abs.begin(), row_abs.begin() + (max_elmts - 1),
+                    row_abs.end(), std::greater<double>());
+            min_kept = row_abs[max_elmts - 1];
+
+            num_ties = max_elmts;
+            for (int j = 0; j < row_size; j++)
+            {
+                if (row_abs[j] > min_kept) num_ties--;
+            }
+        }
+        if (min_kept > row_max)
+            row_max = min_kept;
+
+        row_sum = 0;
+        remain_sum = 0;
+        for (int j = row_start_on; j < row_end_on; j++)
+        {
+            val = P->on_proc->vals[j];
+            abs_val = fabs(val);
+            row_sum += val;
+            if (abs_val > min_kept || (abs_val == min_kept && num_ties-- > 0))
+            {
+                if (abs_val < row_max) continue;
+                P->on_proc->idx2[ctr_on] = P->on_proc->idx2[j];
+                P->on_proc->vals[ctr_on] = val;
+                ctr_on++;
+                remain_sum += val;
+            }
+        }
+        for (int j = row_start_off; j < row_end_off; j++)
+        {
+            val = P->off_proc->vals[j];
+            abs_val = fabs(val);
+            row_sum += val;
+            if (abs_val > min_kept || (abs_val == min_kept && num_ties-- > 0))
+            {
+                if (abs_val < row_max) continue;
+                P->off_proc->idx2[ctr_off] = P->off_proc->idx2[j];
+                P->off_proc->vals[ctr_off] = val;
+                ctr_off++;
+                remain_sum += val;
+            }
+        }
+
+        // Rescale remaining entries to preserve the row sum
+        if (fabs(remain_sum) > zero_tol && fabs(row_sum - remain_sum) > zero_tol)
+        {
+            row_scale = row_sum / remain_sum;
+            for (int j = prev_ctr_on; j < ctr_on; j++)
+                P->on_proc->vals[j] *= row_scale;
+            for (int j = prev_ctr_off; j < ctr_off; j++)
+                P->off_proc->vals[j] *= row_scale;
+        }
+
+        P->on_proc->idx1[i+1] = ctr_on;
+        P->off_proc->idx1[i+1] = ctr_off;
+
+        row_start_on = row_end_on;
+        row_start_off = row_end_off;
+    }
+
+    P->on_proc->nnz = ctr_on;
+    P->off_proc->nnz = ctr_off;
+    P->local_nnz = ctr_on + ctr_off;
+
+    P->on_proc->idx2.resize(ctr_on);
+    P->on_proc->vals.resize(ctr_on);
+    P->off_proc->idx2.resize(ctr_off);
+    P->off_proc->vals.resize(ctr_off);
+
+    // Remove off_proc columns no longer in P
+    int off_proc_num_cols = P->off_proc_num_cols;
+    aligned_vector<int> off_proc_to_new;
+    if (off_proc_num_cols)
+    {
+        off_proc_to_new.resize(off_proc_num_cols, -1);
+        for (int j = 0; j < ctr_off; j++)
+        {
+            off_proc_to_new[P->off_proc->idx2[j]] = 1;
+        }
+        int ctr = 0;
+        for (int j = 0; j < off_proc_num_cols; j++)
+        {
+            if (off_proc_to_new[j] != -1)
+            {
+                off_proc_to_new[j] = ctr;
+                P->off_proc_column_map[ctr++] = P->off_proc_column_map[j];
+            }
+        }
+        P->off_proc_column_map.resize(ctr);
+        for (int j = 0; j < ctr_off; j++)
+        {
+            P->off_proc->idx2[j] = off_proc_to_new[P->off_proc->idx2[j]];
+        }
+    }
+    P->off_proc_num_cols = P->off_proc_column_map.size();
+    P->off_proc->n_cols = P->off_proc_num_cols;
+
+    // Update communicators to the remaining columns
+    if (P->comm)
+    {
+        ParComm* old_comm = P->comm;
+        P->comm = new ParComm(old_comm, off_proc_to_new);
+        old_comm->delete_comm();
+    }
+    if (P->tap_comm)
+    {
+        P->tap_comm->delete_comm();
+        P->tap_mat_comm->delete_comm();
+        P->init_tap_communicators(P->partition->topology->comm);
+    }
+}
+
 
 ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
         ParCSRMatrix* S, const aligned_vector<int>& states,
         const aligned_vector<int>& off_proc_states,
         const double filter_threshold, 
-        bool tap_interp, int num_variables, int* variables)
+        bool tap_interp, int num_variables, int* variables,
+        ParNeighborRows* neighbor_rows)
 {
     int start, end, idx, idx_k;
     int ctr, end_S;
@@ -305,8 +309,7 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
         mat_comm = A->tap_mat_comm;
     }
 
-    std::set<int> global_set;
-    std::map<int, int> global_to_local;
+    IndexMap global_to_local;
     aligned_vector<int> off_proc_column_map;
     aligned_vector<int> off_variables;
 
@@ -331,7 +334,11 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
     }
 
     // Communicate parallel matrix A (portion needed)
-    recv_mat = communicate(A, S, states, off_proc_states, mat_comm);
+    ParNeighborRows* rows = neighbor_rows;
+    if (rows == NULL) rows = new ParNeighborRows(A, S, mat_comm);
+    rows->update_states(states, off_proc_states);
+    recv_mat = rows->extended_rows();
+    if (neighbor_rows == NULL) delete rows;
 
     int tmp_col = col;
     int* on_proc_partition_to_col = A->map_partition_to_local();
@@ -421,7 +428,7 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
     {
         if (off_proc_states[i] == Selected)
         {
-            global_set.insert(S->off_proc_column_map[i]);
+            off_proc_column_map.push_back(S->off_proc_column_map[i]);
         }
     }
     for (int i = 0; i < S->off_proc_num_cols; i++)
@@ -432,21 +439,18 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
             end = A_recv_off_ptr[i+1];
             for (int j = start; j < end; j++)
             {
-                global_set.insert(recv_mat->idx2[A_recv_off_idx[j]]);
+                off_proc_column_map.push_back(recv_mat->idx2[A_recv_off_idx[j]]);
             }
         }
     }
-    for (std::set<int>::iterator it = global_set.begin(); it != global_set.end(); ++it)
-    {
-        global_to_local[*it] = off_proc_column_map.size();
-        off_proc_column_map.push_back(*it);
-    }
+    sort_unique(off_proc_column_map);
     off_proc_cols = off_proc_column_map.size();
+    global_to_local.build(off_proc_column_map);
 
     for (aligned_vector<int>::iterator it = A_recv_off_idx.begin(); 
             it != A_recv_off_idx.end(); ++it)
     {
-        recv_mat->idx2[*it] = global_to_local[recv_mat->idx2[*it]];
+        recv_mat->idx2[*it] = global_to_local.find(recv_mat->idx2[*it]);
     }
 
     // Initialize P
@@ -472,7 +476,7 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
     RAPtor_MPI_Request reduce_request;
     int reduce_buf = on_proc_cols;
     RAPtor_MPI_Iallreduce(&(reduce_buf), &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, 
-            RAPtor_MPI_COMM_WORLD, &reduce_request);
+            A->partition->topology->comm, &reduce_request);
    
     ParCSRMatrix* P = new ParCSRMatrix(A->partition, A->global_num_rows, -1, 
             A->local_num_rows, on_proc_cols, off_proc_cols);
@@ -598,7 +602,6 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
         for (int j = start; j < end; j++)
         {
             col = S->on_proc->idx2[j];
-            val = S->on_proc->vals[j];
             if (states[col] == Selected)
             {
                 if (pos[col] < row_start_on)
@@ -645,7 +648,6 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
         for (int j = start; j < end; j++)
         {
             col = S->off_proc->idx2[j];
-            val = S->off_proc->vals[j];
             if (off_proc_states[col] == Selected)
             {
                 col_P = off_proc_A_to_P[col];
@@ -971,12 +973,12 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
 
     if (tap_interp)
     {
-        P->init_tap_communicators(RAPtor_MPI_COMM_WORLD);
+        P->init_tap_communicators(P->partition->topology->comm);
     }
     else
     {
         P->comm = new ParComm(P->partition, P->off_proc_column_map,
-                P->on_proc_column_map, 9243, RAPtor_MPI_COMM_WORLD);
+                P->on_proc_column_map, 9243, P->partition->topology->comm);
     }
 
     delete recv_mat;
@@ -991,17 +993,18 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
 ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
         ParCSRMatrix* S, const aligned_vector<int>& states,
         const aligned_vector<int>& off_proc_states, 
-        bool tap_interp, int num_variables, int* variables)
+        bool tap_interp, int num_variables, int* variables,
+        ParNeighborRows* neighbor_rows)
 {
     int rank;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_rank(A->partition->topology->comm, &rank);
 
     int start, end;
     int start_k, end_k;
-    int end_S;
+    int end_S, end_A;
     int col, col_k;
     int ctr, idx;
-    int global_col, sign;
+    int global_col, local_col, sign;
     int global_num_cols;
     int row_start_on, row_start_off;
     double diag, val, val_k;
@@ -1064,7 +1067,7 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
             off_proc_cols++;
         }
     }
-    RAPtor_MPI_Allreduce(&(on_proc_cols), &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    RAPtor_MPI_Allreduce(&(on_proc_cols), &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, A->partition->topology->comm);
    
     ParCSRMatrix* P = new ParCSRMatrix(A->partition, A->global_num_rows, global_num_cols, 
             A->local_num_rows, on_proc_cols, off_proc_cols);
@@ -1080,7 +1083,11 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
     P->local_row_map = S->get_local_row_map();
 
     // Communicate parallel matrix A (Costly!)
-    recv_mat = communicate(A, states, off_proc_states, mat_comm);
+    ParNeighborRows* rows = neighbor_rows;
+    if (rows == NULL) rows = new ParNeighborRows(A, S, mat_comm);
+    rows->update_states(states, off_proc_states);
+    recv_mat = rows->classical_rows();
+    if (neighbor_rows == NULL) delete rows;
 
     CSRMatrix* recv_on = new CSRMatrix(recv_mat->n_rows, -1, recv_mat->nnz);
     CSRMatrix* recv_off = new CSRMatrix(recv_mat->n_rows, -1, recv_mat->nnz);
@@ -1121,13 +1128,7 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
     delete[] on_proc_partition_to_col;
 
     // Change off_proc_cols to local (remove cols not on rank)
-    ctr = 0;
-    std::map<int, int> global_to_local;
-    for (aligned_vector<int>::iterator it = A->off_proc_column_map.begin();
-            it != A->off_proc_column_map.end(); ++it)
-    {
-        global_to_local[*it] = ctr++;
-    }
+    IndexMap global_to_local(A->off_proc_column_map);
     recv_off->n_cols = A->off_proc_num_cols;
     ctr = 0;
     start = recv_off->idx1[0];
@@ -1137,10 +1138,10 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
         for (int j = start; j < end; j++)
         {
             global_col = recv_off->idx2[j];
-            std::map<int, int>::iterator it = global_to_local.find(global_col);
-            if (it != global_to_local.end())
+            local_col = global_to_local.find(global_col);
+            if (local_col >= 0)
             {
-                recv_off->idx2[ctr] = it->second;
+                recv_off->idx2[ctr] = local_col;
                 recv_off->vals[ctr++] = recv_off->vals[j];
             }
         }
@@ -1181,15 +1182,27 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
         row_start_on = P->on_proc->idx1[i];
         row_start_off = P->off_proc->idx1[i];
 
-        // Add selected states to P
+        // Add selected states to P, with values of A (the pattern of S
+        // is a subset of that of A, in the same order)
         start = S->on_proc->idx1[i] + 1;
         end = S->on_proc->idx1[i+1];
+        ctr = A->on_proc->idx1[i];
+        end_A = A->on_proc->idx1[i+1];
+        if (ctr < end_A && A->on_proc->idx2[ctr] == i)
+        {
+            ctr++;
+        }
         for (int j = start; j < end; j++)
         {
             col = S->on_proc->idx2[j];
+            while (ctr < end_A && A->on_proc->idx2[ctr] != col)
+            {
+                ctr++;
+            }
+            if (ctr == end_A) break;
             if (states[col] == Selected)
             {
-                val = S->on_proc->vals[j];
+                val = A->on_proc->vals[ctr];
                 pos[col] = P->on_proc->idx2.size();
                 P->on_proc->idx2.push_back(on_proc_col_to_new[col]);
                 P->on_proc->vals.push_back(val);
@@ -1197,12 +1210,19 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
         }
         start = S->off_proc->idx1[i];
         end = S->off_proc->idx1[i+1];
+        ctr = A->off_proc->idx1[i];
+        end_A = A->off_proc->idx1[i+1];
         for (int j = start; j < end; j++)
         {
             col = S->off_proc->idx2[j];
+            while (ctr < end_A && A->off_proc->idx2[ctr] != col)
+            {
+                ctr++;
+            }
+            if (ctr == end_A) break;
             if (off_proc_states[col] == Selected)
             {
-                val = S->off_proc->vals[j];
+                val = A->off_proc->vals[ctr];
                 off_proc_pos[col] = P->off_proc->idx2.size();
                 col_exists[col] = true;
                 P->off_proc->idx2.push_back(col);
@@ -1535,7 +1555,7 @@ ParCSRMatrix* direct_interpolation(ParCSRMatrix* A,
             off_proc_cols++;
         }
     }
-    RAPtor_MPI_Allreduce(&(on_proc_cols), &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    RAPtor_MPI_Allreduce(&(on_proc_cols), &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, S->partition->topology->comm);
    
     ParCSRMatrix* P = new ParCSRMatrix(S->partition, S->global_num_rows, global_num_cols, 
             S->local_num_rows, on_proc_cols, off_proc_cols);
@@ -1752,3 +1772,56 @@ ParCSRMatrix* direct_interpolation(ParCSRMatrix* A,
 
     return P;
 }
+
+/**************************************************************
+ *****   Injection
+ **************************************************************
+ ***** Returns the injection T from the coarse points of A (those
+ ***** with states[i] == Selected) : T_ij = 1 if row i is the
+ ***** coarse point j.  As with the interpolation operators, the
+ ***** columns of T are indexed by the global rows of A.
+ **************************************************************/
+ParCSRMatrix* injection(ParCSRMatrix* A, const aligned_vector<int>& states)
+{
+    int on_proc_cols = 0;
+    int global_num_cols;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        if (states[i] == Selected)
+        {
+            on_proc_cols++;
+        }
+    }
+    RAPtor_MPI_Allreduce(&on_proc_cols, &global_num_cols, 1, RAPtor_MPI_INT,
+            RAPtor_MPI_SUM, A->partition->topology->comm);
+
+    ParCSRMatrix* T = new ParCSRMatrix(A->partition, A->global_num_rows, global_num_cols,
+            A->local_num_rows, on_proc_cols, 0);
+    T->local_row_map = A->get_local_row_map();
+    T->on_proc->idx2.reserve(on_proc_cols);
+    T->on_proc->vals.reserve(on_proc_cols);
+
+    T->on_proc->idx1[0] = 0;
+    T->off_proc->idx1[0] = 0;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        if (states[i] == Selected)
+        {
+            T->on_proc->idx2.push_back(T->on_proc_column_map.size());
+            T->on_proc->vals.push_back(1.0);
+            T->on_proc_column_map.push_back(A->on_proc_column_map[i]);
+        }
+        T->on_proc->idx1[i+1] = T->on_proc->idx2.size();
+        T->off_proc->idx1[i+1] = 0;
+    }
+    T->on_proc->nnz = T->on_proc->idx2.size();
+    T->off_proc->nnz = 0;
+    T->local_nnz = T->on_proc->nnz;
+
+    T->on_proc_num_cols = T->on_proc_column_map.size();
+    T->off_proc_num_cols = 0;
+    T->on_proc->n_cols = T->on_proc_num_cols;
+    T->off_proc->n_cols = 0;
+
+    return T;
+}
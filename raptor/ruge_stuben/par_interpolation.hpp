@@ -5,6 +5,7 @@
 
 #include "core/types.hpp"
 #include "core/par_matrix.hpp"
+#include "ruge_stuben/par_neighbor_rows.hpp"
 
 using namespace raptor;
 
@@ -13,15 +14,27 @@ ParCSRMatrix* direct_interpolation(ParCSRMatrix* A,
         const aligned_vector<int>& off_proc_states,
         bool tap_amg = false);
 
+// If given, neighbor_rows holds the rows of A (with S) fetched for
+// off_proc columns, and is reused rather than fetched again
 ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
         ParCSRMatrix* S, const aligned_vector<int>& states,
         const aligned_vector<int>& off_proc_states,
-        bool tap_amg = false, int num_variables = 1, int* variables = NULL);
+        bool tap_amg = false, int num_variables = 1, int* variables = NULL,
+        ParNeighborRows* neighbor_rows = NULL);
 
 ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
         ParCSRMatrix* S, const aligned_vector<int>& states,
         const aligned_vector<int>& off_proc_states,
         const double filter_threshold = 0.3,
-        bool tap_amg = false, int num_variables = 1, int* variables = NULL);
+        bool tap_amg = false, int num_variables = 1, int* variables = NULL,
+        ParNeighborRows* neighbor_rows = NULL);
+
+ParCSRMatrix* injection(ParCSRMatrix* A, const aligned_vector<int>& states);
+
+// Truncates each row of P to entries at least trunc_factor times the
+// largest (in magnitude), keeping at most max_elmts (if positive), and
+// rescales the remaining entries to preserve the row sum
+void truncate_interp(ParCSRMatrix* P, const double trunc_factor, 
+        const int max_elmts = 0);
 
 #endif
@@ -0,0 +1,228 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "ruge_stuben/par_neighbor_rows.hpp"
+
+using namespace raptor;
+
+ParNeighborRows::ParNeighborRows(ParCSRMatrix* _A, ParCSRMatrix* S, CommPkg* _comm)
+{
+    int start, end, col;
+    int ctr_S, end_S;
+    int sign, flag;
+    double val;
+
+    A = _A;
+    comm = _comm;
+    bool has_vals = A->on_proc->data_size() > 0;
+
+    aligned_vector<int> global_cols;
+    aligned_vector<int> send_flags;
+    aligned_vector<double> values;
+    aligned_vector<double> no_vals;
+
+    send_ptr.resize(A->local_num_rows + 1);
+    if (A->local_nnz)
+    {
+        global_cols.reserve(A->local_nnz);
+        send_cols.reserve(A->local_nnz);
+        send_flags.reserve(A->local_nnz);
+        if (has_vals) values.reserve(A->local_nnz);
+    }
+
+    send_ptr[0] = 0;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        start = A->on_proc->idx1[i];
+        end = A->on_proc->idx1[i+1];
+        sign = -1;
+        if (start < end && A->on_proc->idx2[start] == i)
+        {
+            if (has_vals && A->on_proc->vals[start] > 0) sign = 1;
+            start++;
+        }
+
+        ctr_S = 0;
+        end_S = 0;
+        if (S)
+        {
+            ctr_S = S->on_proc->idx1[i];
+            end_S = S->on_proc->idx1[i+1];
+            if (ctr_S < end_S && S->on_proc->idx2[ctr_S] == i) ctr_S++;
+        }
+        for (int j = start; j < end; j++)
+        {
+            col = A->on_proc->idx2[j];
+            if (col == i) continue;
+
+            flag = 0;
+            while (ctr_S < end_S && S->on_proc->idx2[ctr_S] < col) ctr_S++;
+            if (ctr_S < end_S && S->on_proc->idx2[ctr_S] == col) flag = InS;
+
+            if (has_vals)
+            {
+                val = A->on_proc->vals[j];
+                if (val * sign >= 0) continue;
+                values.emplace_back(val);
+            }
+            global_cols.emplace_back(A->on_proc_column_map[col]);
+            send_cols.emplace_back(col);
+            send_flags.emplace_back(flag);
+        }
+
+        start = A->off_proc->idx1[i];
+        end = A->off_proc->idx1[i+1];
+        if (S)
+        {
+            ctr_S = S->off_proc->idx1[i];
+            end_S = S->off_proc->idx1[i+1];
+        }
+        for (int j = start; j < end; j++)
+        {
+            col = A->off_proc->idx2[j];
+
+            flag = OffProc;
+            while (ctr_S < end_S && S->off_proc->idx2[ctr_S] < col) ctr_S++;
+            if (ctr_S < end_S && S->off_proc->idx2[ctr_S] == col) flag |= InS;
+
+            if (has_vals)
+            {
+                val = A->off_proc->vals[j];
+                if (val * sign >= 0) continue;
+                values.emplace_back(val);
+            }
+            global_cols.emplace_back(A->off_proc_column_map[col]);
+            send_cols.emplace_back(A->on_proc_num_cols + col);
+            send_flags.emplace_back(flag);
+        }
+        send_ptr[i+1] = global_cols.size();
+    }
+
+    // Fetch structure (and values), and flags of each entry
+    rows = comm->communicate(send_ptr, global_cols, values, 1, 1, has_vals);
+    CSRMatrix* recv_flags = comm->communicate(send_ptr, send_flags, no_vals,
+            1, 1, false);
+    flags.swap(recv_flags->idx2);
+    delete recv_flags;
+    rows->n_rows = A->off_proc_num_cols;
+    rows->nnz = rows->idx2.size();
+
+    // Map global columns to local columns of A
+    int first_col = A->partition->first_local_col;
+    int last_col = A->partition->last_local_col;
+    int* part_to_col = A->map_partition_to_local();
+    IndexMap global_to_local(A->off_proc_column_map);
+    if (rows->nnz) local_cols.resize(rows->nnz);
+    for (int j = 0; j < rows->nnz; j++)
+    {
+        col = rows->idx2[j];
+        if (col >= first_col && col <= last_col)
+        {
+            local_cols[j] = part_to_col[col - first_col];
+        }
+        else
+        {
+            col = global_to_local[col];
+            local_cols[j] = col >= 0 ? col + A->on_proc_num_cols : -1;
+        }
+    }
+    delete[] part_to_col;
+}
+
+void ParNeighborRows::update_states(const aligned_vector<int>& states,
+        const aligned_vector<int>& off_proc_states)
+{
+    int col;
+    aligned_vector<int> send_states(send_cols.size());
+    aligned_vector<double> no_vals;
+
+    for (int j = 0; j < (int) send_cols.size(); j++)
+    {
+        col = send_cols[j];
+        if (col < A->on_proc_num_cols)
+            send_states[j] = states[col];
+        else
+            send_states[j] = off_proc_states[col - A->on_proc_num_cols];
+    }
+
+    CSRMatrix* recv_states = comm->communicate(send_ptr, send_states, no_vals,
+            1, 1, false);
+    col_states.swap(recv_states->idx2);
+    delete recv_states;
+}
+
+/**************************************************************
+ *****   Extended Interpolation Rows
+ **************************************************************
+ ***** Entries with Selected columns, and entries with Unselected
+ ***** columns off_proc on the process holding the row (shifted
+ ***** by global_num_cols, for the +i possibility).  Selected
+ ***** columns in S are stored as -(col+1).  Requires states.
+ **************************************************************/
+CSRMatrix* ParNeighborRows::extended_rows()
+{
+    int global_col, state, flag;
+
+    CSRMatrix* recv_mat = new CSRMatrix(rows->n_rows, A->global_num_cols, rows->nnz);
+    recv_mat->idx1[0] = 0;
+    for (int i = 0; i < rows->n_rows; i++)
+    {
+        for (int j = rows->idx1[i]; j < rows->idx1[i+1]; j++)
+        {
+            global_col = rows->idx2[j];
+            state = col_states[j];
+            flag = flags[j];
+            if (flag & OffProc)
+            {
+                if (state == NoNeighbors) continue;
+                if (state == Unselected)
+                {
+                    global_col += A->partition->global_num_cols;
+                }
+                else if (flag & InS)
+                {
+                    global_col = -(global_col + 1);
+                }
+            }
+            else
+            {
+                if (state != Selected) continue;
+                if (flag & InS)
+                {
+                    global_col = -(global_col + 1);
+                }
+            }
+            recv_mat->idx2.emplace_back(global_col);
+            recv_mat->vals.emplace_back(rows->vals[j]);
+        }
+        recv_mat->idx1[i+1] = recv_mat->idx2.size();
+    }
+    recv_mat->nnz = recv_mat->idx2.size();
+
+    return recv_mat;
+}
+
+/**************************************************************
+ *****   Modified Classical Interpolation Rows
+ **************************************************************
+ ***** Entries with Selected columns.  Requires states.
+ **************************************************************/
+CSRMatrix* ParNeighborRows::classical_rows()
+{
+    CSRMatrix* recv_mat = new CSRMatrix(rows->n_rows, A->global_num_cols, rows->nnz);
+    recv_mat->idx1[0] = 0;
+    for (int i = 0; i < rows->n_rows; i++)
+    {
+        for (int j = rows->idx1[i]; j < rows->idx1[i+1]; j++)
+        {
+            if (col_states[j] == Selected)
+            {
+                recv_mat->idx2.emplace_back(rows->idx2[j]);
+                recv_mat->vals.emplace_back(rows->vals[j]);
+            }
+        }
+        recv_mat->idx1[i+1] = recv_mat->idx2.size();
+    }
+    recv_mat->nnz = recv_mat->idx2.size();
+
+    return recv_mat;
+}
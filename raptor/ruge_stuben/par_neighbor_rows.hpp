@@ -0,0 +1,82 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#ifndef RAPTOR_PAR_NEIGHBOR_ROWS_HPP
+#define RAPTOR_PAR_NEIGHBOR_ROWS_HPP
+
+#include "core/types.hpp"
+#include "core/par_matrix.hpp"
+
+using namespace raptor;
+
+/**************************************************************
+ *****   ParNeighborRows Class
+ **************************************************************
+ ***** Rows of A held by other processes, one for each off_proc
+ ***** column of A (the distance-two neighborhood of the local
+ ***** rows), with the state of each column attached.  The
+ ***** structure of the rows is fetched once, on construction,
+ ***** and kept for every round of setup on a level, after which
+ ***** update_states refreshes the attached states with a single
+ ***** integer exchange.
+ *****
+ ***** Diagonals are not fetched.  If A has values, only entries
+ ***** with sign opposite to the diagonal (those used by
+ ***** interpolation) are fetched.
+ *****
+ ***** Attributes
+ ***** -------------
+ ***** rows : CSRMatrix*
+ *****    Fetched rows, with global column indices (and values, if
+ *****    A has values)
+ ***** flags : aligned_vector<int>
+ *****    For each entry, InS if the entry is in S, and OffProc if
+ *****    the column is off_proc on the process holding the row
+ ***** col_states : aligned_vector<int>
+ *****    State of each entry's column, as of the last call to
+ *****    update_states
+ ***** local_cols : aligned_vector<int>
+ *****    Column of A (on_proc, or on_proc_num_cols + off_proc) of
+ *****    each entry, or -1 if not a local column of A
+ *****
+ ***** Methods
+ ***** -------
+ ***** update_states(states, off_proc_states)
+ *****    Attaches current states to each fetched entry
+ ***** extended_rows() / classical_rows()
+ *****    Return the rows in the form used by extended and modified
+ *****    classical interpolation
+ **************************************************************/
+class ParNeighborRows
+{
+    public:
+        static const int InS = 1;
+        static const int OffProc = 2;
+
+        ParNeighborRows(ParCSRMatrix* A, ParCSRMatrix* S, CommPkg* comm);
+
+        ~ParNeighborRows()
+        {
+            delete rows;
+        }
+
+        void update_states(const aligned_vector<int>& states,
+                const aligned_vector<int>& off_proc_states);
+
+        CSRMatrix* extended_rows();
+        CSRMatrix* classical_rows();
+
+        ParCSRMatrix* A;
+        CommPkg* comm;
+        CSRMatrix* rows;
+        aligned_vector<int> flags;
+        aligned_vector<int> col_states;
+        aligned_vector<int> local_cols;
+
+    private:
+        // Local rowptr and columns of fetched entries on the process
+        // holding them (for sending states)
+        aligned_vector<int> send_ptr;
+        aligned_vector<int> send_cols;
+};
+
+#endif
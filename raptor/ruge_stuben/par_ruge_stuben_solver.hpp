@@ -22,6 +22,9 @@ namespace raptor
             variables = NULL;
             num_variables = 1;
             interp_filter = 0.3; // Only used in HMIS/PMIS
+            agg_num_levels = 0;
+            trunc_factor = 0.0;
+            p_max_elmts = 0;
         }
 
         ~ParRugeStubenSolver()
@@ -54,24 +57,10 @@ namespace raptor
             }
         }
 
-        void extend_hierarchy()
+        void form_splitting(ParCSRMatrix* S, aligned_vector<int>& states,
+                aligned_vector<int>& off_proc_states, bool tap_level, 
+                int level_ctr, double* rand_vals)
         {
-            int level_ctr = levels.size() - 1;
-            bool tap_level = tap_amg >= 0 && tap_amg <= level_ctr;
-
-            ParCSRMatrix* A = levels[level_ctr]->A;
-            ParCSRMatrix* S;
-            ParCSRMatrix* P;
-            ParCSRMatrix* AP;
-
-            aligned_vector<int> states;
-            aligned_vector<int> off_proc_states;
-
-            // Form strength of connection
-            S = A->strength(strength_type, strong_threshold, tap_level, 
-                    num_variables, variables);
-
-            // Form CF Splitting
             switch (coarsen_type)
             {
                 case RS:
@@ -82,28 +71,33 @@ namespace raptor
                     else 
                     {
                         split_falgout(S, states, off_proc_states, tap_level, 
-                                weights);
+                                rand_vals);
                     }
                     break;
                 case CLJP:
                     split_cljp(S, states, off_proc_states, tap_level, 
-                            weights);
+                            rand_vals);
                     break;
                 case Falgout:
                     split_falgout(S, states, off_proc_states, tap_level, 
-                            weights);
+                            rand_vals);
                     break;
                 case PMIS:
                     split_pmis(S, states, off_proc_states, tap_level, 
-                            weights);
+                            rand_vals);
                     break;
                 case HMIS:
                     split_hmis(S, states, off_proc_states, tap_level, 
-                            weights);
+                            rand_vals);
                     break;
             }
+        }
 
-            // Form modified classical interpolation
+        ParCSRMatrix* form_interpolation(ParCSRMatrix* A, ParCSRMatrix* S,
+                aligned_vector<int>& states, aligned_vector<int>& off_proc_states,
+                bool tap_level, ParNeighborRows* neighbor_rows = NULL)
+        {
+            ParCSRMatrix* P;
             switch (interp_type)
             {
                 case Direct:
@@ -112,15 +106,164 @@ namespace raptor
                     break;
                 case ModClassical:
                     P = mod_classical_interpolation(A, S, states, off_proc_states, 
-                            tap_level, num_variables, variables);
+                            tap_level, num_variables, variables, neighbor_rows);
                     break;
                 case Extended:
                     P = extended_interpolation(A, S, states, off_proc_states, 
-                            interp_filter, tap_level, num_variables, variables);
+                            interp_filter, tap_level, num_variables, variables,
+                            neighbor_rows);
                     break;
             }
+            return P;
+        }
+
+        /**************************************************************
+         *****   Aggressive Coarsening
+         **************************************************************
+         ***** Two-stage splitting : S is split into C1 / F points, and
+         ***** the distance-two strength between C1 points is split
+         ***** again, with the resulting coarse points (C2) forming the
+         ***** coarse grid.  Returns the two-stage interpolation
+         ***** P = P1 * P2, where P1 interpolates from C1 (with the
+         ***** first stage splitting) and P2 holds the rows at C1 points
+         ***** of the interpolation from C2.  C1 points that are not C2
+         ***** points may have no strong C2 neighbors, so P2 is always
+         ***** formed with extended interpolation, which reaches C2
+         ***** points through strong F neighbors (direct and modified
+         ***** classical interpolation would leave these rows empty).
+         **************************************************************/
+        ParCSRMatrix* aggressive_coarsening(ParCSRMatrix* A, ParCSRMatrix* S,
+                aligned_vector<int>& states, aligned_vector<int>& off_proc_states,
+                bool tap_level, int level_ctr)
+        {
+            int ctr;
+            aligned_vector<int> states1;
+            aligned_vector<int> off_proc_states1;
+            aligned_vector<int> states2;
+            aligned_vector<int> off_proc_states2;
+            aligned_vector<double> weights2;
+
+            // First stage
+            form_splitting(S, states1, off_proc_states1, tap_level, level_ctr,
+                    weights);
+
+            // Second stage, on the distance-two strength between C1 points
+            ParCSRMatrix* T = injection(A, states1);
+            ParCSRMatrix* S2 = distance_two_strength(S, T, tap_level);
+            if (weights)
+            {
+                for (int i = 0; i < A->local_num_rows; i++)
+                {
+                    if (states1[i] == Selected)
+                    {
+                        weights2.push_back(weights[i]);
+                    }
+                }
+            }
+            form_splitting(S2, states2, off_proc_states2, tap_level, level_ctr,
+                    weights ? weights2.data() : NULL);
+            delete S2;
+
+            // C1 points with no C1 neighbors within distance two remain 
+            // coarse
+            ctr = 0;
+            if (A->local_num_rows) 
+            {
+                states.resize(A->local_num_rows);
+            }
+            for (int i = 0; i < A->local_num_rows; i++)
+            {
+                if (states1[i] == Selected)
+                {
+                    states[i] = (states2[ctr] == NoNeighbors) ? Selected : states2[ctr];
+                    ctr++;
+                }
+                else
+                {
+                    states[i] = states1[i];
+                }
+            }
+            CommPkg* comm = tap_level ? (CommPkg*) A->tap_comm : (CommPkg*) A->comm;
+            aligned_vector<int>& recv_states = comm->communicate(states);
+            off_proc_states.resize(A->off_proc_num_cols);
+            std::copy(recv_states.begin(), recv_states.begin() + A->off_proc_num_cols,
+                    off_proc_states.begin());
+
+            // Two-stage interpolation, with both stages sharing the rows of A
+            // fetched for off_proc columns
+            A->sort();
+            S->sort();
+            A->on_proc->move_diag();
+            S->on_proc->move_diag();
+            ParNeighborRows* neighbor_rows = new ParNeighborRows(A, S, tap_level ? 
+                    (CommPkg*) A->tap_mat_comm : (CommPkg*) A->comm);
+            ParCSRMatrix* P1 = form_interpolation(A, S, states1, off_proc_states1,
+                    tap_level, neighbor_rows);
+            ParCSRMatrix* P_full = extended_interpolation(A, S, states, off_proc_states,
+                    interp_filter, tap_level, num_variables, variables, neighbor_rows);
+            delete neighbor_rows;
+            ParCSRMatrix* P2 = P_full->mult_T(T);
+            ParCSRMatrix* P = P1->mult(P2);
+            delete T;
+            delete P1;
+            delete P2;
+            delete P_full;
+
+            P->comm = new ParComm(P->partition, P->off_proc_column_map,
+                    P->on_proc_column_map, A->comm->key, A->comm->mpi_comm);
+            if (tap_level)
+            {
+                P->init_tap_communicators(P->partition->topology->comm);
+            }
+
+            return P;
+        }
+
+        void extend_hierarchy()
+        {
+            int level_ctr = levels.size() - 1;
+            bool tap_level = tap_amg >= 0 && tap_amg <= level_ctr;
+
+            ParCSRMatrix* A = levels[level_ctr]->A;
+            ParCSRMatrix* S;
+            ParCSRMatrix* P;
+            ParCSRMatrix* AP;
+
+            aligned_vector<int> states;
+            aligned_vector<int> off_proc_states;
+
+            // Form strength of connection
+            S = A->strength(strength_type, strong_threshold, tap_level, 
+                    num_variables, variables);
+
+            if (level_ctr < agg_num_levels)
+            {
+                P = aggressive_coarsening(A, S, states, off_proc_states, 
+                        tap_level, level_ctr);
+            }
+            else
+            {
+                // Form CF Splitting
+                form_splitting(S, states, off_proc_states, tap_level, level_ctr,
+                        weights);
+
+                // Form interpolation
+                P = form_interpolation(A, S, states, off_proc_states, tap_level);
+            }
+
+            // Truncate interpolation before forming the coarse grid operator
+            if (trunc_factor > 0 || p_max_elmts > 0)
+            {
+                truncate_interp(P, trunc_factor, p_max_elmts);
+            }
             levels[level_ctr]->P = P;
 
+            // Injection, if the next coarse operator is non-Galerkin
+            if (get_sparsify_tol(level_ctr + 1) > 0)
+            {
+                levels[level_ctr]->I = injection(A, states);
+            }
+
             if (num_variables > 1)
             {
                 int ctr = 0;
@@ -141,20 +284,24 @@ namespace raptor
 
             A->sort();
             A->on_proc->move_diag();
+            sparsify_coarse(level_ctr, AP, A);
 
             level_ctr++;
             levels[level_ctr]->A = A;
             A->comm = new ParComm(A->partition, A->off_proc_column_map,
                     A->on_proc_column_map, levels[level_ctr-1]->A->comm->key,
                     levels[level_ctr-1]->A->comm->mpi_comm);
-            levels[level_ctr]->x.resize(A->global_num_rows, A->local_num_rows);
-            levels[level_ctr]->b.resize(A->global_num_rows, A->local_num_rows);
-            levels[level_ctr]->tmp.resize(A->global_num_rows, A->local_num_rows);
+            levels[level_ctr]->x.resize(A->global_num_rows, A->local_num_rows,
+                    A->partition->topology->comm);
+            levels[level_ctr]->b.resize(A->global_num_rows, A->local_num_rows,
+                    A->partition->topology->comm);
+            levels[level_ctr]->tmp.resize(A->global_num_rows, A->local_num_rows,
+                    A->partition->topology->comm);
             levels[level_ctr]->P = NULL;
 
             if (tap_amg >= 0 && tap_amg <= level_ctr)
             {
-                levels[level_ctr]->A->init_tap_communicators(RAPtor_MPI_COMM_WORLD);
+                levels[level_ctr]->A->init_tap_communicators(levels[level_ctr]->A->partition->topology->comm);
             }
 
             delete AP;
@@ -165,6 +312,16 @@ namespace raptor
         interp_t interp_type;
         double interp_filter;
 
+        // Number of (finest) levels formed with aggressive coarsening
+        // (the second stage always uses extended interpolation)
+        int agg_num_levels;
+
+        // Interpolation truncation : entries smaller than trunc_factor
+        // times the largest in their row are removed, and at most
+        // p_max_elmts are kept per row (no truncation if zero)
+        double trunc_factor;
+        int p_max_elmts;
+
         int* variables;
 
     };
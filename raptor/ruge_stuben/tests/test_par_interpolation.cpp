@@ -163,3 +163,53 @@ TEST(TestParInterpolation, TestsInRuge_Stuben)
     delete A;
 
 } // end of TEST(TestParInterpolation, TestsInRuge_Stuben) //
+
+TEST(TestParNeighborRows, TestsInRuge_Stuben)
+{ 
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    aligned_vector<int> states;
+    aligned_vector<int> off_proc_states;
+    ParCSRMatrix* S = A->strength(Classical, 0.25);
+    split_hmis(S, states, off_proc_states);
+
+    // Interpolation with shared rows matches interpolation fetching its own
+    ParNeighborRows* neighbor_rows = new ParNeighborRows(A, S, A->comm);
+    ParCSRMatrix* P = extended_interpolation(A, S, states, off_proc_states);
+    ParCSRMatrix* P_shared = extended_interpolation(A, S, states, off_proc_states,
+            0.3, false, 1, NULL, neighbor_rows);
+    compare(P, P_shared);
+    delete P;
+    delete P_shared;
+
+    P = mod_classical_interpolation(A, S, states, off_proc_states);
+    P_shared = mod_classical_interpolation(A, S, states, off_proc_states,
+            false, 1, NULL, neighbor_rows);
+    compare(P, P_shared);
+    delete P;
+    delete P_shared;
+
+    // Attached states are those of the global columns
+    aligned_vector<int> global_states(A->global_num_rows, 0);
+    aligned_vector<int> local_states(A->global_num_rows, 0);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        local_states[A->local_row_map[i]] = states[i];
+    }
+    MPI_Allreduce(local_states.data(), global_states.data(), A->global_num_rows,
+            MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    CSRMatrix* rows = neighbor_rows->rows;
+    ASSERT_EQ(rows->n_rows, A->off_proc_num_cols);
+    for (int j = 0; j < rows->nnz; j++)
+    {
+        ASSERT_EQ(neighbor_rows->col_states[j], global_states[rows->idx2[j]]);
+    }
+
+    delete neighbor_rows;
+    delete S;
+    delete A;
+
+} // end of TEST(TestParNeighborRows, TestsInRuge_Stuben) //
@@ -134,3 +134,62 @@ TEST(TestParSplitting, TestsInRuge_Stuben)
 
 } // end of TEST(TestParSplitting, TestsInRuge_Stuben) //
 
+
+TEST(TestParSplitting, TestLocalRounds)
+{ 
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    FILE* f;
+    aligned_vector<int> states;
+    aligned_vector<int> off_proc_states;
+    int cf, num_rounds;
+
+    ParCSRMatrix* S;
+
+    const char* S0_fn = "../../../../test_data/rss_S0.pm";
+    const char* cf0_pmis = "../../../../test_data/rss_cf0_pmis.txt";
+    const char* weights_fn = "../../../../test_data/weights.txt";
+
+    S = readParMatrix(S0_fn);
+
+    f = fopen(weights_fn, "r");
+    aligned_vector<double> weights(S->local_num_rows);
+    for (int i = 0; i < S->partition->first_local_row; i++)
+    {
+        fscanf(f, "%lf\n", &weights[0]);
+    }
+    for (int i = 0; i < S->local_num_rows; i++)
+    {
+        fscanf(f, "%lf\n", &weights[i]);
+    }
+    fclose(f);
+
+    // Interior points are assigned in local rounds, without changing
+    // the splitting
+    S->on_proc->move_diag();
+    set_initial_states(S, states);
+    num_rounds = pmis_main_loop(S, states, off_proc_states, false, weights.data());
+
+    f = fopen(cf0_pmis, "r");
+    for (int i = 0; i < S->partition->first_local_row; i++)
+    {
+        fscanf(f, "%d\n", &cf);
+    }
+    for (int i = 0; i < S->local_num_rows; i++)
+    {
+        fscanf(f, "%d\n", &cf);
+        ASSERT_EQ(cf, states[i]);
+    }
+    fclose(f);
+
+    // With a single process, every point is interior
+    if (num_procs == 1)
+    {
+        ASSERT_EQ(num_rounds, 1);
+    }
+
+    delete S;
+
+} // end of TEST(TestParSplitting, TestLocalRounds) //
@@ -4,14 +4,62 @@
 
 using namespace raptor;
 
-CSRMatrix* classical_strength(CSRMatrix* A, double theta, int num_variables, int* variables)
+/**************************************************************
+ *****   Compact Strength
+ **************************************************************
+ ***** Forms the pattern-only strength matrix S (no values)
+ ***** from the kept entries of A.  On entry,
+ ***** S->idx1[i+1] holds the number of entries of row i
+ ***** (including the diagonal, if present), and keep flags the
+ ***** off-diagonal entries of A to keep.  Row pointers are
+ ***** formed with a prefix sum, after which rows are filled
+ ***** independently.
+ **************************************************************/
+static void compact_strength(CSRMatrix* A, CSRMatrix* S, const aligned_vector<char>& keep)
 {
-    int start, end, col;
-    double val;
-    double row_scale;
-    double threshold;
-    double diag;
+    S->idx1[0] = 0;
+    for (int i = 0; i < A->n_rows; i++)
+    {
+        S->idx1[i+1] += S->idx1[i];
+    }
+    S->nnz = S->idx1[A->n_rows];
+    S->idx2.resize(S->nnz);
 
+#pragma omp parallel for
+    for (int i = 0; i < A->n_rows; i++)
+    {
+        int start = A->idx1[i];
+        int end = A->idx1[i+1];
+        int ctr = S->idx1[i];
+        if (end > start && A->idx2[start] == i)
+        {
+            S->idx2[ctr++] = i;
+            start++;
+        }
+        for (int j = start; j < end; j++)
+        {
+            if (keep[j])
+            {
+                S->idx2[ctr++] = A->idx2[j];
+            }
+        }
+    }
+
+    // S inherits the (sorted, diagonal first) ordering of A
+    S->sorted = true;
+    S->diag_first = true;
+}
+
+/**************************************************************
+ *****   Classical Strength of Connection
+ **************************************************************
+ ***** Entry a_ij is strong if -sign(a_ii)*a_ij exceeds theta
+ ***** times the largest such value in row i.  Each row is
+ ***** scanned independently, flagging the kept entries of A,
+ ***** and S is then formed by compact_strength.
+ **************************************************************/
+CSRMatrix* classical_strength(CSRMatrix* A, double theta, int num_variables, int* variables)
+{
     if (!A->sorted)
     {
         A->sort();
@@ -22,172 +70,73 @@ CSRMatrix* classical_strength(CSRMatrix* A, double theta, int num_variables, int
     }
 
     CSRMatrix* S = new CSRMatrix(A->n_rows, A->n_cols);
-    S->idx2.resize(A->nnz);
-    S->vals.resize(A->nnz);
+    aligned_vector<char> keep(A->nnz, 0);
 
-    S->nnz = 0;
-    S->idx1[0] = 0;
+#pragma omp parallel for
     for (int i = 0; i < A->n_rows; i++)
     {
+        int start = A->idx1[i];
+        int end = A->idx1[i+1];
+        int num_kept = 0;
+
         // Always add the diagonal 
-        start = A->idx1[i];
-        end = A->idx1[i+1];
-        if (end - start)
+        double diag = 0.0;
+        if (end > start && A->idx2[start] == i)
         {
-            if (A->idx2[start] == i)
-            {
-                diag = A->vals[start];
-                S->idx2[S->nnz] = A->idx2[start];
-                S->vals[S->nnz] = diag;
-                S->nnz++;
-                start++;
-            }
-            else
-            {
-                diag = 0.0;
-            }
+            diag = A->vals[start];
+            num_kept++;
+            start++;
+        }
 
-            if (num_variables == 1)
+        // Compare sign*val, so the strongest connections (those 
+        // of opposite sign to the diagonal) are the largest
+        double sign = diag < 0.0 ? 1.0 : -1.0;
+        double row_scale = -RAND_MAX;
+        if (num_variables == 1)
+        {
+            for (int j = start; j < end; j++)
             {
-                if (diag < 0.0) // find max off-diag value in row
-                {
-                    row_scale = -RAND_MAX;
-                    for (int j = start; j < end; j++)
-                    {
-                        val = A->vals[j];
-                        if (val > row_scale)
-                        {
-                            row_scale = val;
-                        }
-                    }
-                }
-                else // find min off-diag value in row
-                {
-                    row_scale = RAND_MAX;
-                    for (int j = start; j < end; j++)
-                    {
-                        val = A->vals[j];
-                        if (val < row_scale)
-                        {
-                            row_scale = val;
-                        }
-                    }
-                }
+                row_scale = std::max(row_scale, sign * A->vals[j]);
             }
-            else
+        }
+        else
+        {
+            for (int j = start; j < end; j++)
             {
-                if (diag < 0.0) // find max off-diag value in row
-                {
-                    row_scale = -RAND_MAX;
-                    for (int j = start; j < end; j++)
-                    {
-                        col = A->idx2[j];
-                        if (variables[i] == variables[col])
-                        {
-                            val = A->vals[j];
-                            if (val > row_scale)
-                            {
-                                row_scale = val;
-                            }
-                        }
-                    }
-                }
-                else // find min off-diag value in row
+                if (variables[i] == variables[A->idx2[j]])
                 {
-                    row_scale = RAND_MAX;
-                    for (int j = start; j < end; j++)
-                    {
-                        col = A->idx2[j];
-                        if (variables[i] == variables[col])
-                        {
-                            val = A->vals[j];
-                            if (val < row_scale)
-                            {
-                                row_scale = val;
-                            }
-                        }
-                    }
+                    row_scale = std::max(row_scale, sign * A->vals[j]);
                 }
-
             }
+        }
 
-            // Multiply row magnitude by theta
-            threshold = row_scale*theta;
+        // Multiply row magnitude by theta
+        double threshold = row_scale * theta;
 
-            // Add off-diagonals greater than threshold
-            if (num_variables == 1)
+        // Add off-diagonals greater than threshold
+        if (num_variables == 1)
+        {
+            for (int j = start; j < end; j++)
             {
-                if (diag < 0)
-                {
-                    for (int j = start; j < end; j++)
-                    {
-                        val = A->vals[j];
-                        if (val > threshold)
-                        {
-                            S->idx2[S->nnz] = A->idx2[j];
-                            S->vals[S->nnz] = val;
-                            S->nnz++;
-                        }
-                    }
-                }
-                else
-                {
-                    for (int j = start; j < end; j++)
-                    {
-                        val = A->vals[j];
-                        if (val < threshold)
-                        {
-                            S->idx2[S->nnz] = A->idx2[j];
-                            S->vals[S->nnz] = val;
-                            S->nnz++;
-                        }
-                    }
-                }
+                char k = sign * A->vals[j] > threshold;
+                keep[j] = k;
+                num_kept += k;
             }
-            else
+        }
+        else
+        {
+            for (int j = start; j < end; j++)
             {
-                if (diag < 0)
-                {
-                    for (int j = start; j < end; j++)
-                    {
-                        col = A->idx2[j];
-                        if (variables[i] == variables[col])
-                        {
-                            val = A->vals[j];
-                            if (val > threshold)
-                            {
-                                S->idx2[S->nnz] = col;
-                                S->vals[S->nnz] = val;
-                                S->nnz++;
-                            }
-                        }
-                    }
-                }
-                else
-                {
-                    for (int j = start; j < end; j++)
-                    {
-                        col = A->idx2[j];
-                        if (variables[i] == variables[col])
-                        {
-                            val = A->vals[j];
-                            if (val < threshold)
-                            {
-                                S->idx2[S->nnz] = col;
-                                S->vals[S->nnz] = val;
-                                S->nnz++;
-                            }
-                        }
-                    }
-                }
+                char k = variables[i] == variables[A->idx2[j]]
+                    && sign * A->vals[j] > threshold;
+                keep[j] = k;
+                num_kept += k;
             }
         }
-        S->idx1[i+1] = S->nnz;
+        S->idx1[i+1] = num_kept;
     }
-    S->idx2.resize(S->nnz);
-    S->idx2.shrink_to_fit();
-    S->vals.resize(S->nnz);
-    S->vals.shrink_to_fit();
+
+    compact_strength(A, S, keep);
 
     return S;
 
@@ -195,12 +144,6 @@ CSRMatrix* classical_strength(CSRMatrix* A, double theta, int num_variables, int
 
 CSRMatrix* symmetric_strength(CSRMatrix* A, double theta)
 {
-    int start, end, col;
-    double val;
-    double row_scale;
-    double threshold;
-    double diag;
-
     aligned_vector<int> neg_diags;
     aligned_vector<double> row_scales;
     if (A->n_rows)
@@ -219,105 +162,64 @@ CSRMatrix* symmetric_strength(CSRMatrix* A, double theta)
     }
 
     CSRMatrix* S = new CSRMatrix(A->n_rows, A->n_cols);
-    S->idx2.resize(A->nnz);
-    S->vals.resize(A->nnz);
+    aligned_vector<char> keep(A->nnz, 0);
 
+    // Threshold of each row (theta times the value with max magnitude),
+    // with sign opposite to that of the diagonal
+#pragma omp parallel for
     for (int i = 0; i < A->n_rows; i++)
     {
-        // Always add the diagonal 
-        start = A->idx1[i];
-        end = A->idx1[i+1];
-        if (end - start)
+        int start = A->idx1[i];
+        int end = A->idx1[i+1];
+        double diag = 0.0;
+        if (end > start && A->idx2[start] == i)
         {
-            if (A->idx2[start] == i)
-            {
-                diag = A->vals[start];
-                start++;
-            }
-            else
-            {
-                diag = 0.0;
-            }
-
-            if (diag < 0.0) // find max off-diag value in row
-            {
-                neg_diags[i] = 1;
-                row_scale = -RAND_MAX;
-                for (int j = start; j < end; j++)
-                {
-                    val = A->vals[j];
-                    if (val > row_scale)
-                    {
-                        row_scale = val;
-                    }
-                }
-            }
-            else // find min off-diag value in row
-            {
-                neg_diags[i] = 0;
-                row_scale = RAND_MAX;
-                for (int j = start; j < end; j++)
-                {
-                    val = A->vals[j];
-                    if (val < row_scale)
-                    {
-                        row_scale = val;
-                    }
-                }
-            }
-
+            diag = A->vals[start];
+            start++;
+        }
 
-            // Multiply row magnitude by theta
-            threshold = row_scale*theta;
-            row_scales[i] = threshold;
+        double sign = diag < 0.0 ? 1.0 : -1.0;
+        double row_scale = -RAND_MAX;
+        for (int j = start; j < end; j++)
+        {
+            row_scale = std::max(row_scale, sign * A->vals[j]);
         }
+
+        neg_diags[i] = diag < 0.0;
+        row_scales[i] = end > A->idx1[i] ? sign * row_scale * theta : 0.0;
     }
 
-    S->nnz = 0;
-    S->idx1[0] = 0;
+    // Entries are strong if strong in either their row or column
+#pragma omp parallel for
     for (int i = 0; i < A->n_rows; i++)
     {
-        // Always add the diagonal 
-        start = A->idx1[i];
-        end = A->idx1[i+1];
-        if (end - start)
+        int start = A->idx1[i];
+        int end = A->idx1[i+1];
+        int num_kept = 0;
+        if (end > start && A->idx2[start] == i)
         {
-            if (A->idx2[start] == i)
-            {
-                diag = A->vals[start];
-                S->idx2[S->nnz] = A->idx2[start];
-                S->vals[S->nnz] = A->vals[start];
-                S->nnz++;
-                start++;
-            }
-            int neg_diag = neg_diags[i];
-            threshold = row_scales[i];
+            num_kept++;
+            start++;
+        }
 
-            // Add off-diagonals greater than threshold
-            for (int j = start; j < end; j++)
-            {
-                val = A->vals[j];
-                col = A->idx2[j];
-                if ((neg_diag && val > threshold) || (!neg_diag && val < threshold)
-                        || (neg_diags[col] && val > row_scales[col]) 
-                        || (!neg_diags[col] && val < row_scales[col]))
-                {
-                    S->idx2[S->nnz] = col;
-                    S->vals[S->nnz] = val;
-                    S->nnz++;
-                }
-            }
+        double sign = neg_diags[i] ? 1.0 : -1.0;
+        double threshold = sign * row_scales[i];
+        for (int j = start; j < end; j++)
+        {
+            double val = A->vals[j];
+            int col = A->idx2[j];
+            double col_sign = neg_diags[col] ? 1.0 : -1.0;
+            char k = (sign * val > threshold) 
+                | (col_sign * val > col_sign * row_scales[col]);
+            keep[j] = k;
+            num_kept += k;
         }
-        S->idx1[i+1] = S->nnz;
+        S->idx1[i+1] = num_kept;
     }
-    S->idx2.resize(S->nnz);
-    S->idx2.shrink_to_fit();
-    S->vals.resize(S->nnz);
-    S->vals.shrink_to_fit();
-
-    return S;
 
+    compact_strength(A, S, keep);
 
+    return S;
 }
 
 CSRMatrix* CSRMatrix::strength(strength_t strength_type,
@@ -75,3 +75,38 @@ TEST(ParStrengthTest, TestsInTests)
     delete S_rap;
 
 } // end of  TEST(ParStrengthTest, TestsInTests) //
+
+TEST(ParStrengthTest, PatternOnlyTest)
+{
+    int num_strong;
+
+    const char* A0_fn = "../../../test_data/aniso.pm";
+    ParCSRMatrix* A = readParMatrix(A0_fn);
+    aligned_vector<char> on_strong;
+    aligned_vector<char> off_strong;
+
+    // S holds no values, and its entries are the diagonal of each
+    // row plus the entries flagged by strength_mask
+    ParCSRMatrix* S = A->strength(Classical, 0.25);
+    ASSERT_TRUE(S->on_proc->vals.empty());
+    ASSERT_TRUE(S->off_proc->vals.empty());
+
+    A->strength_mask(Classical, on_strong, off_strong, 0.25);
+    ASSERT_EQ(on_strong.size(), A->on_proc->nnz);
+    ASSERT_EQ(off_strong.size(), A->off_proc->nnz);
+
+    num_strong = A->local_num_rows;
+    for (int i = 0; i < A->on_proc->nnz; i++)
+    {
+        num_strong += on_strong[i];
+    }
+    for (int i = 0; i < A->off_proc->nnz; i++)
+    {
+        num_strong += off_strong[i];
+    }
+    ASSERT_EQ(num_strong, S->local_nnz);
+
+    delete S;
+    delete A;
+
+} // end of  TEST(ParStrengthTest, PatternOnlyTest) //
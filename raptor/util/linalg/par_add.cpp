@@ -26,34 +26,22 @@ ParCSRMatrix* ParCSRMatrix::add(ParCSRMatrix* B)
     if (off_proc_num_cols) off_proc_to_new.resize(off_proc_num_cols, 0);
     if (B->off_proc_num_cols) B_off_proc_to_new.resize(B->off_proc_num_cols, 0);
 
-    int ctr = 0;
-    int ctr_B = 0;
-    int global_col = 0;
-    int global_col_B = 0;
-    while (ctr < off_proc_num_cols || ctr_B < B->off_proc_num_cols)
+    // Off-process columns of C are the union of those of both matrices
+    int ctr;
+    C->off_proc_column_map.reserve(off_proc_num_cols + B->off_proc_num_cols);
+    C->off_proc_column_map.insert(C->off_proc_column_map.end(),
+            off_proc_column_map.begin(), off_proc_column_map.end());
+    C->off_proc_column_map.insert(C->off_proc_column_map.end(),
+            B->off_proc_column_map.begin(), B->off_proc_column_map.end());
+    sort_unique(C->off_proc_column_map);
+    IndexMap global_to_C(C->off_proc_column_map);
+    for (int i = 0; i < off_proc_num_cols; i++)
     {
-        if (ctr < off_proc_num_cols) global_col = off_proc_column_map[ctr];
-        else global_col = partition->global_num_cols;
-
-        if (ctr_B < B->off_proc_num_cols) global_col_B = B->off_proc_column_map[ctr_B];
-        else global_col_B = B->partition->global_num_cols;
-
-        if (global_col == global_col_B)
-        {
-            off_proc_to_new[ctr++] = C->off_proc_column_map.size();
-            B_off_proc_to_new[ctr_B++] = C->off_proc_column_map.size();
-            C->off_proc_column_map.emplace_back(global_col);
-        }
-        else if (global_col < global_col_B)
-        {
-            off_proc_to_new[ctr++] = C->off_proc_column_map.size();
-            C->off_proc_column_map.emplace_back(global_col);
-        }
-        else
-        {
-            B_off_proc_to_new[ctr_B++] = C->off_proc_column_map.size();
-            C->off_proc_column_map.emplace_back(global_col_B);
-        }
+        off_proc_to_new[i] = global_to_C[off_proc_column_map[i]];
+    }
+    for (int i = 0; i < B->off_proc_num_cols; i++)
+    {
+        B_off_proc_to_new[i] = global_to_C[B->off_proc_column_map[i]];
     }
     C->off_proc_num_cols = C->off_proc_column_map.size();
 
@@ -124,7 +112,7 @@ ParCSRMatrix* ParCSRMatrix::add(ParCSRMatrix* B)
         for (aligned_vector<int>::iterator it = C->off_proc->idx2.begin() + off_nnz;
                 it != C->off_proc->idx2.begin() + off_nnz + (end - start); ++it)
         {
-            *it = off_proc_to_new[*it];
+            *it = B_off_proc_to_new[*it];
         }
         off_nnz += (end - start);
 
@@ -160,7 +148,10 @@ ParCSRMatrix* ParCSRMatrix::add(ParCSRMatrix* B)
         for (int i = 0; i < C->off_proc_num_cols; i++)
         {
             if (new_col[i])
+            {
+                C->off_proc_column_map[ctr] = C->off_proc_column_map[i];
                 new_col[i] = ctr++;
+            }
             else 
                 new_col[i] = -1;
         }
@@ -192,34 +183,22 @@ ParCSRMatrix* ParCSRMatrix::subtract(ParCSRMatrix* B)
     if (off_proc_num_cols) off_proc_to_new.resize(off_proc_num_cols, 0);
     if (B->off_proc_num_cols) B_off_proc_to_new.resize(B->off_proc_num_cols, 0);
 
-    int ctr = 0;
-    int ctr_B = 0;
-    int global_col = 0;
-    int global_col_B = 0;
-    while (ctr < off_proc_num_cols || ctr_B < B->off_proc_num_cols)
+    // Off-process columns of C are the union of those of both matrices
+    int ctr;
+    C->off_proc_column_map.reserve(off_proc_num_cols + B->off_proc_num_cols);
+    C->off_proc_column_map.insert(C->off_proc_column_map.end(),
+            off_proc_column_map.begin(), off_proc_column_map.end());
+    C->off_proc_column_map.insert(C->off_proc_column_map.end(),
+            B->off_proc_column_map.begin(), B->off_proc_column_map.end());
+    sort_unique(C->off_proc_column_map);
+    IndexMap global_to_C(C->off_proc_column_map);
+    for (int i = 0; i < off_proc_num_cols; i++)
     {
-        if (ctr < off_proc_num_cols) global_col = off_proc_column_map[ctr];
-        else global_col = partition->global_num_cols;
-
-        if (ctr_B < B->off_proc_num_cols) global_col_B = B->off_proc_column_map[ctr_B];
-        else global_col_B = B->partition->global_num_cols;
-
-        if (global_col == global_col_B)
-        {
-            off_proc_to_new[ctr++] = C->off_proc_column_map.size();
-            B_off_proc_to_new[ctr_B++] = C->off_proc_column_map.size();
-            C->off_proc_column_map.emplace_back(global_col);
-        }
-        else if (global_col < global_col_B)
-        {
-            off_proc_to_new[ctr++] = C->off_proc_column_map.size();
-            C->off_proc_column_map.emplace_back(global_col);
-        }
-        else
-        {
-            B_off_proc_to_new[ctr_B++] = C->off_proc_column_map.size();
-            C->off_proc_column_map.emplace_back(global_col_B);
-        }
+        off_proc_to_new[i] = global_to_C[off_proc_column_map[i]];
+    }
+    for (int i = 0; i < B->off_proc_num_cols; i++)
+    {
+        B_off_proc_to_new[i] = global_to_C[B->off_proc_column_map[i]];
     }
     C->off_proc_num_cols = C->off_proc_column_map.size();
 
@@ -288,7 +267,10 @@ ParCSRMatrix* ParCSRMatrix::subtract(ParCSRMatrix* B)
         for (int i = 0; i < C->off_proc_num_cols; i++)
         {
             if (new_col[i])
+            {
+                C->off_proc_column_map[ctr] = C->off_proc_column_map[i];
                 new_col[i] = ctr++;
+            }
             else 
                 new_col[i] = -1;
         }
@@ -5,273 +5,737 @@
 #include "util/linalg/par_relax.hpp"
 #include "core/par_matrix.hpp"
 
+/**************************************************************
+ *****   Relaxation Communicator
+ **************************************************************
+ ***** Returns the communication package used to gather the
+ ***** off-process values of x, forming it if necessary
+ **************************************************************/
+CommPkg* relax_comm(ParCSRMatrix* A, bool tap)
+{
+    if (tap)
+    {
+        if (!A->tap_comm)
+        {
+            A->tap_comm = new TAPComm(A->partition, A->off_proc_column_map,
+                    A->on_proc_column_map);
+        }
+        return A->tap_comm;
+    }
+
+    if (!A->comm)
+    {
+        A->comm = new ParComm(A->partition, A->off_proc_column_map,
+                A->on_proc_column_map);
+    }
+    return A->comm;
+}
+
+/**************************************************************
+ *****   Smoother Data Setup
+ **************************************************************
+ ***** Sorts A, moves the diagonal to the front of each row,
+ ***** and forms the data required by relax_type.
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** A : ParCSRMatrix*
+ *****    Matrix to be relaxed over
+ ***** relax_type : relax_t
+ *****    Relaxation method that will be used with this data
+ **************************************************************/
+void ParSmootherData::setup(ParCSRMatrix* A, relax_t relax_type, bool tap)
+{
+    int start, end;
+
+    A->on_proc->sort();
+    A->off_proc->sort();
+    A->on_proc->move_diag();
+
+    diag_inv.resize(A->local_num_rows);
+    if (relax_type == L1Jacobi || relax_type == L1SOR || relax_type == L1SSOR)
+    {
+        l1_row_norms(A, diag_inv, relax_type == L1Jacobi);
+    }
+    else
+    {
+        for (int i = 0; i < A->local_num_rows; i++)
+        {
+            diag_inv[i] = 0.0;
+            start = A->on_proc->idx1[i];
+            end = A->on_proc->idx1[i+1];
+            if (start < end && A->on_proc->idx2[start] == i)
+            {
+                diag_inv[i] = A->on_proc->vals[start];
+            }
+        }
+    }
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        if (fabs(diag_inv[i]) > zero_tol)
+        {
+            diag_inv[i] = 1.0 / diag_inv[i];
+        }
+        else
+        {
+            diag_inv[i] = 0.0;
+        }
+    }
+
+    if (relax_type == Chebyshev)
+    {
+        work.resize(A->global_num_rows, A->local_num_rows,
+                A->partition->topology->comm);
+        max_eig = estimate_spectral_radius(A, diag_inv, 10, tap);
+    }
+    else if (relax_type == MulticolorSSOR)
+    {
+        color_on_proc(A, color_ptr, color_rows);
+    }
+}
+
 /**************************************************************
  *****   Hybrid Gauss-Seidel / Jacobi Parallel Relaxation
  **************************************************************
  ***** Performs Jacobi along the off-diagonal block and
- ***** symmetric Gauss-Seidel along the diagonal block
- ***** The tmp array is used as a place-holder, but the result
- ***** is returned put in the x-vector. 
+ ***** Gauss-Seidel along the diagonal block.  Each row is
+ ***** updated with x_i += omega * diag_inv_i * (y_i - A_i x),
+ ***** which is SOR when diag_inv holds the inverse diagonal,
+ ***** and hybrid l1 Gauss-Seidel when it holds the inverse l1
+ ***** diagonal.  Rows without a diagonal (diag_inv_i = 0) are
+ ***** left unchanged.
  *****
  ***** Parameters
  ***** -------------
  ***** A : Matrix*
  *****    Matrix to relax over
+ ***** on_vals, off_vals : T*
+ *****    Values of A->on_proc and A->off_proc (double, or float
+ *****    for single precision relaxation)
  ***** x : data_t*
  *****    Vector to be relaxed, will contain result
  ***** y : data_t*
  *****    Right hand side vector
- ***** tmp: data_t*
- *****    Vector needed for inner steps
+ ***** diag_inv : aligned_vector<double>&
+ *****    Inverse of diagonal used to scale each row
  ***** dist_x : data_t*
  *****    Vector of distant x-values recvd from other processes
  **************************************************************/
-void SOR_forward(ParCSRMatrix* A, ParVector& x, const ParVector& y, 
-        const aligned_vector<double>& dist_x, double omega)
+template <typename T>
+inline void SOR_row(const ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, const ParVector& y,
+        const aligned_vector<double>& diag_inv, const aligned_vector<double>& dist_x,
+        const double omega, const int i)
 {
-    int start_on, end_on;
-    int start_off, end_off;
-    int col;
-    double diag;
-    double row_sum;
+    int start, end;
+    double row_sum = 0;
 
-    start_on = 0;
-    start_off = 0;
-    for (int i = 0; i < A->local_num_rows; i++)
+    start = A->on_proc->idx1[i];
+    end = A->on_proc->idx1[i+1];
+    for (int j = start; j < end; j++)
     {
-        row_sum = 0;
-        end_on = A->on_proc->idx1[i+1];
-        if (A->on_proc->idx2[start_on] == i)
-        {
-            diag = A->on_proc->vals[start_on];
-            start_on++;
-        }        
-        else continue;
-        for (int j = start_on; j < end_on; j++)
-        {
-            col = A->on_proc->idx2[j];
-            row_sum += A->on_proc->vals[j] * x[col];
-        }
-        start_on = end_on;
-
-        end_off = A->off_proc->idx1[i+1];
-        for (int j = start_off; j < end_off; j++)
-        {
-            col = A->off_proc->idx2[j];
-            row_sum += A->off_proc->vals[j] * dist_x[col];
-        }
-        start_off = end_off;
+        row_sum += on_vals[j] * x[A->on_proc->idx2[j]];
+    }
 
-//        x[i] = ((1.0 - omega)*x[i]) + (omega*((y[i] - row_sum) / diag));
-        x[i] = (x[i] + omega * (y[i] - x[i] - row_sum)) / diag;
+    start = A->off_proc->idx1[i];
+    end = A->off_proc->idx1[i+1];
+    for (int j = start; j < end; j++)
+    {
+        row_sum += off_vals[j] * dist_x[A->off_proc->idx2[j]];
     }
+
+    x[i] += omega * diag_inv[i] * (y[i] - row_sum);
 }
 
-void SOR_backward(ParCSRMatrix* A, ParVector& x, const ParVector& y,
-        const aligned_vector<double>& dist_x, double omega)
+template <typename T>
+void SOR_forward(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, const ParVector& y,
+        const aligned_vector<double>& diag_inv, const aligned_vector<double>& dist_x,
+        double omega)
 {
-    int start, end, col;
-    double diag;
-    double row_sum;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        SOR_row(A, on_vals, off_vals, x, y, diag_inv, dist_x, omega, i);
+    }
+}
 
+template <typename T>
+void SOR_backward(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, const ParVector& y,
+        const aligned_vector<double>& diag_inv, const aligned_vector<double>& dist_x,
+        double omega)
+{
     for (int i = A->local_num_rows - 1; i >= 0; i--)
     {
-        row_sum = 0;
-        start = A->on_proc->idx1[i];
-        end = A->on_proc->idx1[i+1];
-        if (A->on_proc->idx2[start] == i)
-        {
-            diag = A->on_proc->vals[start];
-            start++;
-        }        
-        else continue;
-        for (int j = start; j < end; j++)
-        {
-            col = A->on_proc->idx2[j];
-            row_sum += A->on_proc->vals[j] * x[col];
-        }
+        SOR_row(A, on_vals, off_vals, x, y, diag_inv, dist_x, omega, i);
+    }
+}
 
-        start = A->off_proc->idx1[i];
-        end = A->off_proc->idx1[i+1];
-        for (int j = start; j < end; j++)
-        {
-            col = A->off_proc->idx2[j];
-            row_sum += A->off_proc->vals[j] * dist_x[col];
-        }
+/**************************************************************
+ *****   Multicolor Gauss-Seidel Parallel Relaxation
+ **************************************************************
+ ***** Performs SOR over the rows of a single color, with Jacobi
+ ***** along the off-diagonal block.  Rows of a single color
+ ***** share no on_proc couplings, so they are updated in
+ ***** parallel.
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** color_ptr : aligned_vector<int>&
+ *****    Rows of color c are color_rows[color_ptr[c]:color_ptr[c+1]]
+ ***** color_rows : aligned_vector<int>&
+ *****    Local rows, ordered by color
+ **************************************************************/
+template <typename T>
+void multicolor_SOR_color(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, const ParVector& y,
+        const aligned_vector<double>& diag_inv, const aligned_vector<int>& color_ptr,
+        const aligned_vector<int>& color_rows, const aligned_vector<double>& dist_x,
+        double omega, int color)
+{
+    int first = color_ptr[color];
+    int last = color_ptr[color+1];
 
-        x[i] = ((1.0 - omega)*x[i]) + (omega*((y[i] - row_sum) / diag));
+#pragma omp parallel for
+    for (int ctr = first; ctr < last; ctr++)
+    {
+        SOR_row(A, on_vals, off_vals, x, y, diag_inv, dist_x, omega, color_rows[ctr]);
     }
 }
 
-void jacobi_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, CommPkg* comm)
+/**************************************************************
+ *****   Jacobi Parallel Relaxation
+ **************************************************************
+ ***** Performs weighted Jacobi, scaling each row by diag_inv.
+ ***** The relaxed values are written to tmp in a single pass
+ ***** over A, after which the storage of x and tmp is swapped,
+ ***** so no copy of x is needed.
+ **************************************************************/
+template <typename T>
+void jacobi_helper(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, ParVector& b, ParVector& tmp,
+        const aligned_vector<double>& diag_inv, int num_sweeps, double omega,
+        CommPkg* comm)
 {
-    A->on_proc->sort();
-    A->off_proc->sort();
-    A->on_proc->move_diag();
-  
-    int start, end, col;
-    double diag, row_sum;
+    int start, end;
+    double row_sum;
 
     for (int iter = 0; iter < num_sweeps; iter++)
     {
         comm->communicate(x);
         aligned_vector<double>& dist_x = comm->get_buffer<double>();
-        for (int i = 0; i < A->local_num_rows; i++)
-        {
-            tmp[i] = x[i];
-        }
 
         for (int i = 0; i < A->local_num_rows; i++)
-        {    
-            diag = 0;
+        {
             row_sum = 0;
-
-            start = A->on_proc->idx1[i]+1;
+            start = A->on_proc->idx1[i];
             end = A->on_proc->idx1[i+1];
             for (int j = start; j < end; j++)
             {
-                col = A->on_proc->idx2[j];
-                row_sum += A->on_proc->vals[j] * tmp[col];
+                row_sum += on_vals[j] * x[A->on_proc->idx2[j]];
             }
 
             start = A->off_proc->idx1[i];
             end = A->off_proc->idx1[i+1];
             for (int j = start; j < end; j++)
             {
-                col = A->off_proc->idx2[j];
-                row_sum += A->off_proc->vals[j] * dist_x[col];
+                row_sum += off_vals[j] * dist_x[A->off_proc->idx2[j]];
             }
 
-            if (fabs(diag) > zero_tol)
-            {
-                x[i] = ((1.0 - omega)*tmp[i]) + (omega*((b[i] - row_sum) / diag));
-            }
+            tmp[i] = x[i] + omega * diag_inv[i] * (b[i] - row_sum);
         }
+
+        x.local.values.swap(tmp.local.values);
     }
 }
 
-void sor_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, CommPkg* comm)
+template <typename T>
+void sor_helper(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, ParVector& b,
+        const aligned_vector<double>& diag_inv, int num_sweeps, double omega,
+        CommPkg* comm)
 {
-    A->on_proc->sort();
-    A->off_proc->sort();
-    A->on_proc->move_diag();
+    for (int iter = 0; iter < num_sweeps; iter++)
+    {
+        comm->communicate(x);
+        SOR_forward(A, on_vals, off_vals, x, b, diag_inv, comm->get_buffer<double>(), omega);
+    }
+}
 
+template <typename T>
+void ssor_helper(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, ParVector& b,
+        const aligned_vector<double>& diag_inv, int num_sweeps, double omega,
+        CommPkg* comm)
+{
     for (int iter = 0; iter < num_sweeps; iter++)
     {
         comm->communicate(x);
-        SOR_forward(A, x, b, comm->get_buffer<double>(), omega);
+        SOR_forward(A, on_vals, off_vals, x, b, diag_inv, comm->get_buffer<double>(), omega);
+        SOR_backward(A, on_vals, off_vals, x, b, diag_inv, comm->get_buffer<double>(), omega);
     }
 }
 
+template <typename T>
+void multicolor_ssor_helper(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, ParVector& b,
+        const aligned_vector<double>& diag_inv, const aligned_vector<int>& color_ptr,
+        const aligned_vector<int>& color_rows, int num_sweeps, double omega,
+        CommPkg* comm)
+{
+    int num_colors = color_ptr.size() - 1;
 
-void ssor_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, CommPkg* comm)
+    for (int iter = 0; iter < num_sweeps; iter++)
+    {
+        comm->communicate(x);
+        aligned_vector<double>& dist_x = comm->get_buffer<double>();
+        for (int c = 0; c < num_colors; c++)
+        {
+            multicolor_SOR_color(A, on_vals, off_vals, x, b, diag_inv, color_ptr, color_rows,
+                    dist_x, omega, c);
+        }
+        for (int c = num_colors - 1; c >= 0; c--)
+        {
+            multicolor_SOR_color(A, on_vals, off_vals, x, b, diag_inv, color_ptr, color_rows,
+                    dist_x, omega, c);
+        }
+    }
+}
+
+/**************************************************************
+ *****   Chebyshev Polynomial Relaxation
+ **************************************************************
+ ***** Applies a Chebyshev polynomial in D^{-1}A, damping error
+ ***** components with eigenvalues in [fraction*max_eig, max_eig].
+ ***** Only matrix-vector products are needed, so results do not
+ ***** depend on the number of processes.  The tmp vector holds
+ ***** the scaled residual and work holds the search direction.
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** max_eig : double
+ *****    Estimate of the largest eigenvalue of D^{-1}A
+ ***** degree : int
+ *****    Degree of Chebyshev polynomial applied per sweep
+ ***** fraction : double
+ *****    Lower bound of interval, as fraction of max_eig
+ **************************************************************/
+template <typename T>
+void chebyshev_helper(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, ParVector& b, ParVector& tmp,
+        ParVector& work, const aligned_vector<double>& diag_inv, double max_eig,
+        int num_sweeps, int degree, double fraction, CommPkg* comm)
 {
-    A->on_proc->sort();
-    A->off_proc->sort();
-    A->on_proc->move_diag();
+    int start, end;
+    double row_sum;
+    double rho, rho_new;
+
+    // Power iteration underestimates the spectral radius, so
+    // pad the upper bound of the interval
+    double upper = 1.1 * max_eig;
+    double lower = fraction * upper;
+    double theta = 0.5 * (upper + lower);
+    double delta = 0.5 * (upper - lower);
+    double sigma = theta / delta;
 
     for (int iter = 0; iter < num_sweeps; iter++)
     {
+        // r = D^{-1}(b - Ax), d = r / theta
         comm->communicate(x);
-        SOR_forward(A, x, b, comm->get_buffer<double>(), omega);
-        SOR_backward(A, x, b, comm->get_buffer<double>(), omega);
+        aligned_vector<double>& dist_x = comm->get_buffer<double>();
+        for (int i = 0; i < A->local_num_rows; i++)
+        {
+            row_sum = 0;
+            start = A->on_proc->idx1[i];
+            end = A->on_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                row_sum += on_vals[j] * x[A->on_proc->idx2[j]];
+            }
+
+            start = A->off_proc->idx1[i];
+            end = A->off_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                row_sum += off_vals[j] * dist_x[A->off_proc->idx2[j]];
+            }
+
+            tmp[i] = diag_inv[i] * (b[i] - row_sum);
+            work[i] = tmp[i] / theta;
+        }
+
+        rho = 1.0 / sigma;
+        for (int k = 0; k < degree; k++)
+        {
+            // x_{k+1} = x_k + d_k
+            x.axpy(work, 1.0);
+            if (k == degree - 1) break;
+
+            // r_{k+1} = r_k - D^{-1}Ad_k
+            comm->communicate(work);
+            aligned_vector<double>& dist_d = comm->get_buffer<double>();
+            for (int i = 0; i < A->local_num_rows; i++)
+            {
+                row_sum = 0;
+                start = A->on_proc->idx1[i];
+                end = A->on_proc->idx1[i+1];
+                for (int j = start; j < end; j++)
+                {
+                    row_sum += on_vals[j] * work[A->on_proc->idx2[j]];
+                }
+
+                start = A->off_proc->idx1[i];
+                end = A->off_proc->idx1[i+1];
+                for (int j = start; j < end; j++)
+                {
+                    row_sum += off_vals[j] * dist_d[A->off_proc->idx2[j]];
+                }
+
+                tmp[i] -= diag_inv[i] * row_sum;
+            }
+
+            // d_{k+1} = rho_{k+1}*rho_k*d_k + (2*rho_{k+1}/delta)*r_{k+1}
+            rho_new = 1.0 / (2.0*sigma - rho);
+            for (int i = 0; i < A->local_num_rows; i++)
+            {
+                work[i] = rho_new*rho*work[i] + (2.0*rho_new/delta)*tmp[i];
+            }
+            rho = rho_new;
+        }
     }
 }
 
 /**************************************************************
- *****  Relaxation Method 
+ *****  Relaxation Method
  **************************************************************
- ***** Performs jacobi along the diagonal block of the matrix
+ ***** Performs relaxation over A, using smoother data formed
+ ***** during setup.  The versions without a ParSmootherData
+ ***** argument form it on each call.
  *****
  ***** Parameters
  ***** -------------
- ***** l: Level*
- *****    Level in hierarchy to be relaxed
+ ***** A : ParCSRMatrix*
+ *****    Matrix to relax over
+ ***** data : ParSmootherData&
+ *****    Smoother data formed with ParSmootherData::setup
  ***** num_sweeps : int
  *****    Number of relaxation sweeps to perform
  **************************************************************/
-void jacobi(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+void jacobi(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps, double omega, bool tap)
+{
+    jacobi_helper(A, A->on_proc->vals.data(), A->off_proc->vals.data(),
+            x, b, tmp, data.diag_inv, num_sweeps, omega, relax_comm(A, tap));
+}
+void sor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector&,
+        ParSmootherData& data, int num_sweeps, double omega, bool tap)
+{
+    sor_helper(A, A->on_proc->vals.data(), A->off_proc->vals.data(),
+            x, b, data.diag_inv, num_sweeps, omega, relax_comm(A, tap));
+}
+void ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector&,
+        ParSmootherData& data, int num_sweeps, double omega, bool tap)
+{
+    ssor_helper(A, A->on_proc->vals.data(), A->off_proc->vals.data(),
+            x, b, data.diag_inv, num_sweeps, omega, relax_comm(A, tap));
+}
+void chebyshev(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps, int degree, double fraction,
+        bool tap)
+{
+    chebyshev_helper(A, A->on_proc->vals.data(), A->off_proc->vals.data(),
+            x, b, tmp, data.work, data.diag_inv, data.max_eig, num_sweeps,
+            degree, fraction, relax_comm(A, tap));
+}
+void multicolor_ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector&,
+        ParSmootherData& data, int num_sweeps, double omega, bool tap)
+{
+    multicolor_ssor_helper(A, A->on_proc->vals.data(), A->off_proc->vals.data(),
+            x, b, data.diag_inv, data.color_ptr, data.color_rows, num_sweeps,
+            omega, relax_comm(A, tap));
+}
+
+// Single precision values (ParSPMatrix), sharing the pattern,
+// communication and smoother data of A_sp->A
+void jacobi(ParSPMatrix* A_sp, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps, double omega, bool tap)
+{
+    jacobi_helper(A_sp->A, A_sp->on_vals.data(), A_sp->off_vals.data(),
+            x, b, tmp, data.diag_inv, num_sweeps, omega, relax_comm(A_sp->A, tap));
+}
+void sor(ParSPMatrix* A_sp, ParVector& x, ParVector& b, ParVector&,
+        ParSmootherData& data, int num_sweeps, double omega, bool tap)
+{
+    sor_helper(A_sp->A, A_sp->on_vals.data(), A_sp->off_vals.data(),
+            x, b, data.diag_inv, num_sweeps, omega, relax_comm(A_sp->A, tap));
+}
+void ssor(ParSPMatrix* A_sp, ParVector& x, ParVector& b, ParVector&,
+        ParSmootherData& data, int num_sweeps, double omega, bool tap)
+{
+    ssor_helper(A_sp->A, A_sp->on_vals.data(), A_sp->off_vals.data(),
+            x, b, data.diag_inv, num_sweeps, omega, relax_comm(A_sp->A, tap));
+}
+void chebyshev(ParSPMatrix* A_sp, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps, int degree, double fraction,
+        bool tap)
+{
+    chebyshev_helper(A_sp->A, A_sp->on_vals.data(), A_sp->off_vals.data(),
+            x, b, tmp, data.work, data.diag_inv, data.max_eig, num_sweeps,
+            degree, fraction, relax_comm(A_sp->A, tap));
+}
+void multicolor_ssor(ParSPMatrix* A_sp, ParVector& x, ParVector& b, ParVector&,
+        ParSmootherData& data, int num_sweeps, double omega, bool tap)
+{
+    multicolor_ssor_helper(A_sp->A, A_sp->on_vals.data(), A_sp->off_vals.data(),
+            x, b, data.diag_inv, data.color_ptr, data.color_rows, num_sweeps,
+            omega, relax_comm(A_sp->A, tap));
+}
+
+void jacobi(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
         int num_sweeps, double omega, bool tap)
 {
-    CommPkg* comm;
-    if (tap)
+    ParSmootherData data;
+    data.setup(A, Jacobi, tap);
+    jacobi(A, x, b, tmp, data, num_sweeps, omega, tap);
+}
+void sor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
+        int num_sweeps, double omega, bool tap)
+{
+    ParSmootherData data;
+    data.setup(A, SOR, tap);
+    sor(A, x, b, tmp, data, num_sweeps, omega, tap);
+}
+void ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
+        int num_sweeps, double omega, bool tap)
+{
+    ParSmootherData data;
+    data.setup(A, SSOR, tap);
+    ssor(A, x, b, tmp, data, num_sweeps, omega, tap);
+}
+
+/**************************************************************
+ *****  L1 Row Norms
+ **************************************************************
+ ***** Forms the l1 diagonal used by the l1 smoothers.  By 
+ ***** default, this is a_ii plus the row sum of |off_proc|, 
+ ***** which is used by hybrid Gauss-Seidel.  If full_row is 
+ ***** true, |a_ij| is summed over all off-diagonal entries of 
+ ***** the row, as is needed for pointwise l1-Jacobi.  The sign
+ ***** of a_ii is kept.
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** A : ParCSRMatrix*
+ *****    Matrix to form l1 diagonal of
+ ***** l1_diag : aligned_vector<double>&
+ *****    Returns l1 diagonal of each local row
+ ***** full_row : bool
+ *****    Sum over all entries of each row rather than only off_proc
+ **************************************************************/
+void l1_row_norms(ParCSRMatrix* A, aligned_vector<double>& l1_diag, bool full_row)
+{
+    int start, end;
+    double diag, row_sum;
+
+    l1_diag.resize(A->local_num_rows);
+    for (int i = 0; i < A->local_num_rows; i++)
     {
-        if (!A->tap_comm) 
+        diag = 0;
+        row_sum = 0;
+        start = A->on_proc->idx1[i];
+        end = A->on_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
         {
-            A->tap_comm = new TAPComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
+            if (A->on_proc->idx2[j] == i)
+            {
+                diag = A->on_proc->vals[j];
+            }
+            else if (full_row)
+            {
+                row_sum += fabs(A->on_proc->vals[j]);
+            }
         }
-        comm = A->tap_comm;
-    }
-    else
-    {
-        if (!A->comm) 
+
+        start = A->off_proc->idx1[i];
+        end = A->off_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
         {
-            A->comm = new ParComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
+            row_sum += fabs(A->off_proc->vals[j]);
         }
-        comm = A->comm;
-    }
 
-    jacobi_helper(A, x, b, tmp, num_sweeps, omega, comm);
+        // Keep sign of diagonal
+        if (diag < 0)
+        {
+            l1_diag[i] = diag - row_sum;
+        }
+        else
+        {
+            l1_diag[i] = diag + row_sum;
+        }
+    }
 }
-void sor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, bool tap)
+
+/**************************************************************
+ *****  Color On Proc
+ **************************************************************
+ ***** Greedily colors the graph of A->on_proc (symmetrized), 
+ ***** so that no two rows of the same color are coupled.  Rows
+ ***** are returned grouped by color for multicolor relaxation.
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** A : ParCSRMatrix*
+ *****    Matrix to be colored
+ ***** color_ptr : aligned_vector<int>&
+ *****    Returns offset of each color in color_rows
+ ***** color_rows : aligned_vector<int>&
+ *****    Returns local rows, ordered by color
+ *****
+ ***** Returns
+ ***** -------------
+ ***** int : number of colors
+ **************************************************************/
+int color_on_proc(ParCSRMatrix* A, aligned_vector<int>& color_ptr, 
+        aligned_vector<int>& color_rows)
 {
-    CommPkg* comm;
-    if (tap)
+    int n_rows = A->local_num_rows;
+    int start, end, col, row;
+    int color;
+    int num_colors = 0;
+
+    // Form transpose pattern of on_proc so that both A_ij and A_ji
+    // are checked for conflicts
+    aligned_vector<int> col_ptr(n_rows + 1, 0);
+    aligned_vector<int> col_rows;
+    for (int i = 0; i < n_rows; i++)
     {
-        if (!A->tap_comm) 
+        start = A->on_proc->idx1[i];
+        end = A->on_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
         {
-            A->tap_comm = new TAPComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
+            col = A->on_proc->idx2[j];
+            if (col < n_rows) col_ptr[col+1]++;
         }
-        comm = A->tap_comm;
     }
-    else
+    for (int i = 0; i < n_rows; i++)
     {
-        if (!A->comm) 
+        col_ptr[i+1] += col_ptr[i];
+    }
+    col_rows.resize(col_ptr[n_rows]);
+    aligned_vector<int> col_pos(col_ptr.begin(), col_ptr.end() - 1);
+    for (int i = 0; i < n_rows; i++)
+    {
+        start = A->on_proc->idx1[i];
+        end = A->on_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
         {
-            A->comm = new ParComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
+            col = A->on_proc->idx2[j];
+            if (col < n_rows) col_rows[col_pos[col]++] = i;
         }
-        comm = A->comm;
     }
 
-    sor_helper(A, x, b, tmp, num_sweeps, omega, comm);
-}
-void ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, bool tap)
-{
-    CommPkg* comm;
-    if (tap)
+    // Assign each row smallest color not used by a neighbor
+    aligned_vector<int> colors(n_rows, -1);
+    aligned_vector<int> color_mark;
+    for (int i = 0; i < n_rows; i++)
     {
-        if (!A->tap_comm) 
+        start = A->on_proc->idx1[i];
+        end = A->on_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
         {
-            A->tap_comm = new TAPComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
+            col = A->on_proc->idx2[j];
+            if (col < n_rows && colors[col] >= 0) color_mark[colors[col]] = i;
         }
-        comm = A->tap_comm;
-    }
-    else
-    {
-        if (!A->comm) 
+        start = col_ptr[i];
+        end = col_ptr[i+1];
+        for (int j = start; j < end; j++)
         {
-            A->comm = new ParComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
+            row = col_rows[j];
+            if (colors[row] >= 0) color_mark[colors[row]] = i;
         }
-        comm = A->comm;
+
+        for (color = 0; color < num_colors; color++)
+        {
+            if (color_mark[color] != i) break;
+        }
+        if (color == num_colors)
+        {
+            color_mark.emplace_back(-1);
+            num_colors++;
+        }
+        colors[i] = color;
+    }
+
+    // Group rows by color
+    color_ptr.resize(num_colors + 1);
+    std::fill(color_ptr.begin(), color_ptr.end(), 0);
+    for (int i = 0; i < n_rows; i++)
+    {
+        color_ptr[colors[i]+1]++;
+    }
+    for (int c = 0; c < num_colors; c++)
+    {
+        color_ptr[c+1] += color_ptr[c];
+    }
+    color_rows.resize(n_rows);
+    aligned_vector<int> color_pos(color_ptr.begin(), color_ptr.end() - 1);
+    for (int i = 0; i < n_rows; i++)
+    {
+        color_rows[color_pos[colors[i]]++] = i;
     }
 
-    ssor_helper(A, x, b, tmp, num_sweeps, omega, comm);
+    return num_colors;
 }
 
+/**************************************************************
+ *****  Estimate Spectral Radius
+ **************************************************************
+ ***** Estimates the largest eigenvalue of D^{-1}A with power 
+ ***** iteration.  The initial vector depends only on global row
+ ***** indices, so the estimate is independent of the partition.
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** A : ParCSRMatrix*
+ *****    Matrix to estimate spectral radius of
+ ***** diag_inv : aligned_vector<double>&
+ *****    Inverse diagonal of A (ParSmootherData::diag_inv)
+ ***** num_iters : int
+ *****    Number of power iterations to perform
+ **************************************************************/
+double estimate_spectral_radius(ParCSRMatrix* A,
+        const aligned_vector<double>& diag_inv, int num_iters, bool tap)
+{
+    double norm_v;
+    double rho = 0.0;
 
+    ParVector v(A->global_num_rows, A->local_num_rows,
+            A->partition->topology->comm);
+    ParVector w(A->global_num_rows, A->local_num_rows,
+            A->partition->topology->comm);
 
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        v[i] = 1.0 + (double)((A->local_row_map[i] * 7919L) % 1009) / 1009;
+    }
 
+    norm_v = v.norm(2);
+    if (norm_v < zero_tol) return 0.0;
+    v.scale(1.0 / norm_v);
 
+    for (int iter = 0; iter < num_iters; iter++)
+    {
+        A->mult(v, w, tap);
+        for (int i = 0; i < A->local_num_rows; i++)
+        {
+            w[i] *= diag_inv[i];
+        }
+        rho = w.norm(2);
+        if (rho < zero_tol) break;
 
+        v.copy(w);
+        v.scale(1.0 / rho);
+    }
 
+    return rho;
+}
@@ -8,17 +8,101 @@
 
 #include "core/par_vector.hpp"
 #include "core/par_matrix.hpp"
-#include "multilevel/par_level.hpp"
+#include "core/par_sp_matrix.hpp"
 
 using namespace raptor;
 
-void jacobi(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+/**************************************************************
+ *****   ParSmootherData Class
+ **************************************************************
+ ***** Holds everything a relaxation method needs for one
+ ***** matrix, formed once during setup so that each sweep is
+ ***** a single pass over the matrix.  Setup sorts A and moves
+ ***** the diagonal to the front of each row of on_proc.
+ *****
+ ***** Attributes
+ ***** -------------
+ ***** diag_inv : aligned_vector<double>
+ *****    Inverse of the diagonal used to scale each row (the l1
+ *****    diagonal for l1 smoothers), or 0 if the row has no
+ *****    diagonal.
+ ***** max_eig : double
+ *****    Estimate of the largest eigenvalue of D^{-1}A (Chebyshev)
+ ***** work : ParVector
+ *****    Work vector (Chebyshev)
+ ***** color_ptr : aligned_vector<int>
+ *****    Rows of color c are color_rows[color_ptr[c]:color_ptr[c+1]]
+ ***** color_rows : aligned_vector<int>
+ *****    Local rows, ordered by color (Multicolor)
+ **************************************************************/
+class ParSmootherData
+{
+  public:
+    ParSmootherData()
+    {
+        max_eig = 0.0;
+    }
+
+    void setup(ParCSRMatrix* A, relax_t relax_type, bool tap = false);
+
+    aligned_vector<double> diag_inv;
+    double max_eig;
+    ParVector work;
+    aligned_vector<int> color_ptr;
+    aligned_vector<int> color_rows;
+};
+
+void jacobi(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
         int num_sweeps = 1, double omega = 1.0, bool tap = false);
-void sor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+void sor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
         int num_sweeps = 1, double omega = 1.0, bool tap = false);
-void ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+void ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
         int num_sweeps = 1, double omega = 1.0, bool tap = false);
 
+// Relaxation with data formed during setup (ParSmootherData::setup)
+void jacobi(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps = 1, double omega = 1.0,
+        bool tap = false);
+void sor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps = 1, double omega = 1.0,
+        bool tap = false);
+void ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps = 1, double omega = 1.0,
+        bool tap = false);
+void chebyshev(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps = 1, int degree = 2,
+        double fraction = 0.3, bool tap = false);
+void multicolor_ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps = 1, double omega = 1.0,
+        bool tap = false);
+
+// Relaxation with single precision values of A (A_sp->A must
+// be the matrix data was formed for)
+void jacobi(ParSPMatrix* A_sp, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps = 1, double omega = 1.0,
+        bool tap = false);
+void sor(ParSPMatrix* A_sp, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps = 1, double omega = 1.0,
+        bool tap = false);
+void ssor(ParSPMatrix* A_sp, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps = 1, double omega = 1.0,
+        bool tap = false);
+void chebyshev(ParSPMatrix* A_sp, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps = 1, int degree = 2,
+        double fraction = 0.3, bool tap = false);
+void multicolor_ssor(ParSPMatrix* A_sp, ParVector& x, ParVector& b, ParVector& tmp,
+        ParSmootherData& data, int num_sweeps = 1, double omega = 1.0,
+        bool tap = false);
+
+void l1_row_norms(ParCSRMatrix* A, aligned_vector<double>& l1_diag,
+        bool full_row = false);
+
+int color_on_proc(ParCSRMatrix* A, aligned_vector<int>& color_ptr,
+        aligned_vector<int>& color_rows);
+
+double estimate_spectral_radius(ParCSRMatrix* A,
+        const aligned_vector<double>& diag_inv, int num_iters = 10,
+        bool tap = false);
 
 
 #endif
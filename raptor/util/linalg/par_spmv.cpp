@@ -4,6 +4,7 @@
 #include "core/types.hpp"
 #include "core/par_matrix.hpp"
 #include "core/par_vector.hpp"
+#include "core/par_sp_matrix.hpp"
 
 #include "assert.h"
 
@@ -344,3 +345,184 @@ void ParCSCMatrix::tap_mult_T(ParVector& x, ParVector& b)
     ParMatrix::tap_mult_T(x, b);
 }
 
+
+/**************************************************************
+ *****   Single Precision Parallel SpMV
+ **************************************************************
+ ***** Products with the float values of a ParSPMatrix.  These
+ ***** follow ParMatrix::mult, mult_T and residual, sharing the
+ ***** communication packages of A.  Products accumulate in 
+ ***** double.
+ **************************************************************/
+CommPkg* ParSPMatrix::get_comm(bool tap)
+{
+    if (tap)
+    {
+        if (A->tap_comm == NULL)
+        {
+            A->tap_comm = new TAPComm(A->partition, A->off_proc_column_map,
+                    A->on_proc_column_map);
+        }
+        return A->tap_comm;
+    }
+
+    if (A->comm == NULL)
+    {
+        A->comm = new ParComm(A->partition, A->off_proc_column_map,
+                A->on_proc_column_map);
+    }
+    return A->comm;
+}
+
+void ParSPMatrix::mult(ParVector& x, ParVector& b, bool tap)
+{
+    CommPkg* comm = get_comm(tap);
+    comm->init_comm(x);
+
+    int start, end;
+    double row_sum;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        row_sum = 0.0;
+        start = A->on_proc->idx1[i];
+        end = A->on_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            row_sum += on_vals[j] * x[A->on_proc->idx2[j]];
+        }
+        b[i] = row_sum;
+    }
+
+    aligned_vector<double>& x_tmp = comm->complete_comm<double>();
+
+    if (A->off_proc_num_cols)
+    {
+        for (int i = 0; i < A->local_num_rows; i++)
+        {
+            row_sum = 0.0;
+            start = A->off_proc->idx1[i];
+            end = A->off_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                row_sum += off_vals[j] * x_tmp[A->off_proc->idx2[j]];
+            }
+            b[i] += row_sum;
+        }
+    }
+}
+
+void ParSPMatrix::mult_append(ParVector& x, ParVector& b, bool tap)
+{
+    CommPkg* comm = get_comm(tap);
+    comm->init_comm(x);
+
+    int start, end;
+    double row_sum;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        row_sum = 0.0;
+        start = A->on_proc->idx1[i];
+        end = A->on_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            row_sum += on_vals[j] * x[A->on_proc->idx2[j]];
+        }
+        b[i] += row_sum;
+    }
+
+    aligned_vector<double>& x_tmp = comm->complete_comm<double>();
+
+    if (A->off_proc_num_cols)
+    {
+        for (int i = 0; i < A->local_num_rows; i++)
+        {
+            row_sum = 0.0;
+            start = A->off_proc->idx1[i];
+            end = A->off_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                row_sum += off_vals[j] * x_tmp[A->off_proc->idx2[j]];
+            }
+            b[i] += row_sum;
+        }
+    }
+}
+
+void ParSPMatrix::mult_T(ParVector& x, ParVector& b, bool tap)
+{
+    CommPkg* comm = get_comm(tap);
+
+    int start, end;
+    double val;
+
+    // Contributions to off-process rows of A^T
+    int b_cols = A->off_proc->b_cols;
+    int recv_size = tap ? A->tap_comm->recv_size : A->comm->recv_data->size_msgs;
+    aligned_vector<double>& x_tmp = comm->get_buffer<double>();
+    if ((int) x_tmp.size() < recv_size * b_cols)
+        x_tmp.resize(recv_size * b_cols);
+    std::fill(x_tmp.begin(), x_tmp.begin() + recv_size * b_cols, 0.0);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        val = x[i];
+        start = A->off_proc->idx1[i];
+        end = A->off_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            x_tmp[A->off_proc->idx2[j]] += off_vals[j] * val;
+        }
+    }
+
+    comm->init_comm_T(x_tmp, b_cols);
+
+    b.set_const_value(0.0);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        val = x[i];
+        start = A->on_proc->idx1[i];
+        end = A->on_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            b[A->on_proc->idx2[j]] += on_vals[j] * val;
+        }
+    }
+
+    comm->complete_comm_T<double>(b.local.values, b_cols);
+}
+
+void ParSPMatrix::residual(ParVector& x, ParVector& b, ParVector& r, bool tap)
+{
+    CommPkg* comm = get_comm(tap);
+    comm->init_comm(x);
+
+    int start, end;
+    double row_sum;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        row_sum = 0.0;
+        start = A->on_proc->idx1[i];
+        end = A->on_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            row_sum += on_vals[j] * x[A->on_proc->idx2[j]];
+        }
+        r[i] = b[i] - row_sum;
+    }
+
+    aligned_vector<double>& x_tmp = comm->complete_comm<double>();
+
+    if (A->off_proc_num_cols)
+    {
+        for (int i = 0; i < A->local_num_rows; i++)
+        {
+            row_sum = 0.0;
+            start = A->off_proc->idx1[i];
+            end = A->off_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                row_sum += off_vals[j] * x_tmp[A->off_proc->idx2[j]];
+            }
+            r[i] -= row_sum;
+        }
+    }
+}